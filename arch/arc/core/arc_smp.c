@@ -107,6 +107,19 @@ void arch_sched_ipi(void)
 	}
 }
 
+void arch_sched_directed_ipi(uint32_t cpu_bitmap)
+{
+	uint32_t i;
+
+	cpu_bitmap &= ~BIT(arch_curr_cpu()->id);
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if ((cpu_bitmap & BIT(i)) != 0) {
+			z_arc_connect_ici_generate(i);
+		}
+	}
+}
+
 static int arc_smp_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
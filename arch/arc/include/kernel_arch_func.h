@@ -68,6 +68,8 @@ extern void z_arc_fatal_error(unsigned int reason, const z_arch_esf_t *esf);
 
 extern void arch_sched_ipi(void);
 
+extern void arch_sched_directed_ipi(uint32_t cpu_bitmap);
+
 extern void z_arc_switch(void *switch_to, void **switched_from);
 
 static inline void arch_switch(void *switch_to, void **switched_from)
@@ -117,6 +117,16 @@ void arch_sched_ipi(void)
 	broadcast_ipi(SGI_SCHED_IPI);
 }
 
+void arch_sched_directed_ipi(uint32_t cpu_bitmap)
+{
+	const uint64_t mpidr = GET_MPIDR();
+
+	/* Note: Assume only one Cluster now, as broadcast_ipi() does */
+	gic_raise_sgi(SGI_SCHED_IPI, mpidr,
+		      cpu_bitmap & SGIR_TGT_MASK &
+		      ~(1 << MPIDR_TO_CORE(mpidr)));
+}
+
 #ifdef CONFIG_USERSPACE
 void ptable_ipi_handler(const void *unused)
 {
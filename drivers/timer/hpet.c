@@ -124,6 +124,9 @@ int sys_clock_driver_init(const struct device *dev)
 	/* CLK_PERIOD_REG is in femtoseconds (1e-15 sec) */
 	hz = (uint32_t)(1000000000000000ull / CLK_PERIOD_REG);
 	z_clock_hw_cycles_per_sec = hz;
+#ifdef CONFIG_USER_TIME_PAGE
+	(void)atomic_set(&z_time_page.page.hw_cycles_per_sec, hz);
+#endif
 	cyc_per_tick = hz / CONFIG_SYS_CLOCK_TICKS_PER_SEC;
 
 	/* Note: we set the legacy routing bit, because otherwise
@@ -117,6 +117,9 @@ struct k_mem_partition;
  * Do not call k_mem_domain_init() on the same memory domain more than once,
  * doing so is undefined behavior.
  *
+ * With CONFIG_USER_TIME_PAGE, the kernel time page is added to every memory
+ * domain as its first partition, and one less partition is available.
+ *
  * @param domain The memory domain to be initialized.
  * @param num_parts The number of array items of "parts" parameter.
  * @param parts An array of pointers to the memory partitions. Can be NULL
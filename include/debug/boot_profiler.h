@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_BOOT_PROFILER_H_
+#define ZEPHYR_INCLUDE_DEBUG_BOOT_PROFILER_H_
+
+#include <stdbool.h>
+#include <zephyr/types.h>
+#include <timing/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup boot_profiler Boot profiler
+ *  @brief Timestamps of the steps of the system boot
+ *
+ *  With CONFIG_BOOT_PROFILER the kernel records, with the timing
+ *  functions' counter, when every init entry of every init level
+ *  starts and returns, when main() is entered and how long each static
+ *  thread waits between being started and first being scheduled.  The
+ *  records are kept in a fixed size table, in the order the steps
+ *  started.
+ *  @{
+ */
+
+/** Kind of boot step */
+enum boot_prof_type {
+	/** Init entry: device init function or SYS_INIT() hook */
+	BOOT_PROF_INIT,
+	/** Entry into main(), start and end are equal */
+	BOOT_PROF_MAIN,
+	/** Static thread, from being started to first being scheduled */
+	BOOT_PROF_THREAD,
+};
+
+/** Boot step */
+struct boot_prof_record {
+	/** Init function, or thread, NULL for main() */
+	const void *id;
+	/** Device or thread name, NULL for SYS_INIT() hooks */
+	const char *name;
+	/** Timing counter when the step started and ended */
+	timing_t start;
+	timing_t end;
+	/** One of enum boot_prof_type */
+	uint8_t type;
+	/** Init level for init entries, -1 otherwise */
+	int8_t level;
+	/** False while the step is in progress (or the thread not run) */
+	bool done;
+};
+
+/** @brief Record callback, see boot_prof_foreach() */
+typedef void (*boot_prof_cb_t)(const struct boot_prof_record *record,
+			       void *user_data);
+
+/** @brief Iterate over the boot steps recorded
+ *
+ * @param cb Callback, called with a snapshot of each record in order
+ * @param user_data Passed to the callback
+ */
+void boot_prof_foreach(boot_prof_cb_t cb, void *user_data);
+
+/** @brief Get the number of boot steps which did not fit in the table
+ *
+ * @return Steps not recorded
+ */
+uint32_t boot_prof_dropped(void);
+
+/** @brief Name of an init level
+ *
+ * @param level Init level, as in struct boot_prof_record
+ *
+ * @return Level name, "-" if not an init level
+ */
+const char *boot_prof_level_name(int level);
+
+/** @} */
+
+struct init_entry;
+struct k_thread;
+struct _static_thread_data;
+
+/* Kernel hooks */
+int z_boot_prof_init_enter(const struct init_entry *entry);
+void z_boot_prof_init_exit(int record);
+void z_boot_prof_main(void);
+void z_boot_prof_thread_start(const struct _static_thread_data *data);
+void z_boot_prof_switched_in(struct k_thread *thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_BOOT_PROFILER_H_ */
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_HEAP_PROFILER_H_
+#define ZEPHYR_INCLUDE_DEBUG_HEAP_PROFILER_H_
+
+#include <stddef.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup heap_profiler Heap profiler
+ *  @brief Attribution of heap allocations to call sites
+ *
+ *  With CONFIG_HEAP_PROFILER every sys_heap allocation (and hence
+ *  every k_heap, k_malloc() and minimal libc malloc() allocation) is
+ *  recorded in a bounded table together with its call site, size and
+ *  timestamp, and per call site counters are kept.  The call site is
+ *  the return address of the outermost allocator API called, e.g.
+ *  the caller of k_malloc() rather than the k_heap code underneath.
+ *  @{
+ */
+
+/** Per call site statistics */
+struct heap_prof_site {
+	/** Return address of the allocation call, NULL for the bucket
+	 * collecting sites that did not fit in the site table
+	 */
+	void *site;
+	/** Bytes currently allocated from this site */
+	uint32_t live_bytes;
+	/** Blocks currently allocated from this site */
+	uint32_t live_count;
+	/** High watermark of live_bytes */
+	uint32_t peak_bytes;
+	/** Allocations since the site was first seen (or reset) */
+	uint32_t allocs;
+	/** Frees since the site was first seen (or reset) */
+	uint32_t frees;
+	/** Uptime in ms of the first and last allocation */
+	uint32_t first_ms;
+	uint32_t last_ms;
+};
+
+/** Profiler bookkeeping */
+struct heap_prof_stats {
+	/** Allocations currently tracked in the live table */
+	uint32_t tracked;
+	/** Allocations not tracked because the live table was full */
+	uint32_t dropped;
+	/** Frees of blocks which were not tracked */
+	uint32_t untracked_frees;
+	/** Call sites in use */
+	uint32_t sites;
+};
+
+/** @brief Call site callback, see heap_prof_site_foreach() */
+typedef void (*heap_prof_site_cb_t)(const struct heap_prof_site *site,
+				    void *user_data);
+
+/** @brief Live allocation callback, see heap_prof_live_foreach() */
+typedef void (*heap_prof_live_cb_t)(void *mem, size_t bytes, void *site,
+				    uint32_t timestamp_ms, void *user_data);
+
+/** @brief Iterate over the call sites
+ *
+ * The callback gets a snapshot of each site and runs unlocked, so it
+ * may print or allocate.
+ *
+ * @param cb Callback
+ * @param user_data Passed to the callback
+ */
+void heap_prof_site_foreach(heap_prof_site_cb_t cb, void *user_data);
+
+/** @brief Iterate over the tracked live allocations
+ *
+ * @param cb Callback
+ * @param user_data Passed to the callback
+ */
+void heap_prof_live_foreach(heap_prof_live_cb_t cb, void *user_data);
+
+/** @brief Get the profiler bookkeeping counters
+ *
+ * @param stats Struct into which to store the counters
+ */
+void heap_prof_stats_get(struct heap_prof_stats *stats);
+
+/** @brief Reset the allocation counters
+ *
+ * Resets the alloc/free counts, rate windows and peaks of all sites
+ * (peaks to the current live bytes).  Live allocations stay tracked.
+ */
+void heap_prof_reset(void);
+
+/** @} */
+
+/* Internal hooks for the allocators */
+void z_heap_prof_alloc(void *mem, size_t bytes, void *caller);
+void z_heap_prof_free(void *mem);
+void *z_heap_prof_site_enter(void *site);
+void z_heap_prof_site_exit(void *prev);
+
+/* Allocator front ends bracket their work with these so that the
+ * sys_heap hooks underneath attribute to the front end's caller.
+ * Only the outermost front end sets the site.
+ */
+#ifdef CONFIG_HEAP_PROFILER
+#define Z_HEAP_PROF_SITE_ENTER() \
+	void *z_heap_prof_prev = z_heap_prof_site_enter(__builtin_return_address(0))
+#define Z_HEAP_PROF_SITE_EXIT() z_heap_prof_site_exit(z_heap_prof_prev)
+#else
+#define Z_HEAP_PROF_SITE_ENTER() do { } while (false)
+#define Z_HEAP_PROF_SITE_EXIT() do { } while (false)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_HEAP_PROFILER_H_ */
@@ -19,6 +19,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include <toolchain.h>
+#include <sys/multi_heap.h>
 
 #ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
 #include <timing/timing.h>
@@ -525,10 +526,35 @@ __syscall void k_wakeup(k_tid_t thread);
 /**
  * @brief Get thread ID of the current thread.
  *
+ * Unlike k_current_get(), this always makes a system call when invoked
+ * from user mode.
+ *
+ * @return ID of current thread.
+ */
+__syscall k_tid_t z_current_get(void);
+
+#ifdef CONFIG_CURRENT_THREAD_USE_TLS
+/* Thread-local cache of the current thread ID, set in z_thread_entry() */
+extern __thread k_tid_t z_tls_current;
+#endif
+
+/**
+ * @brief Get thread ID of the current thread.
+ *
+ * With CONFIG_CURRENT_THREAD_USE_TLS, the ID is read from thread local
+ * storage without a system call.
+ *
  * @return ID of current thread.
  *
  */
-__syscall k_tid_t k_current_get(void);
+static inline k_tid_t k_current_get(void)
+{
+#ifdef CONFIG_CURRENT_THREAD_USE_TLS
+	return z_tls_current;
+#else
+	return z_current_get();
+#endif
+}
 
 /**
  * @brief Abort a thread.
@@ -768,6 +794,44 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+#ifdef CONFIG_SCHED_BUDGET
+/**
+ * @brief Reserve a CPU budget for a thread
+ *
+ * This makes @a thread a hard constant bandwidth server: it may run for
+ * at most @a budget_us microseconds in every period of @a period_us
+ * microseconds.  Its deadline is the end of its current period, so it
+ * is scheduled earliest-deadline-first among the threads of its
+ * priority, and it is throttled, whatever its priority, once it has
+ * used up its budget, until the period ends.  The budget is then
+ * replenished and the deadline moves to the end of the next period.
+ *
+ * A thread waking up after sleeping or waiting keeps its deadline and
+ * remaining budget if running for all of that budget before the
+ * deadline doesn't exceed the reserved bandwidth, otherwise it starts
+ * a new period.
+ *
+ * The deadline of such a thread is managed by the kernel, calls to
+ * k_thread_deadline_set() only take effect until the next period
+ * starts.  User threads may only set a budget, or lower the share of
+ * the CPU a budget reserves.
+ *
+ * @note You should enable @option{CONFIG_SCHED_BUDGET} in your project
+ * configuration.
+ *
+ * @param thread A thread on which to set the budget
+ * @param budget_us Budget per period in microseconds, or zero to
+ *                  remove the budget of @a thread
+ * @param period_us Period in microseconds
+ *
+ * @retval 0 On success
+ * @retval -EINVAL The budget exceeds the period, or the period can't be
+ *                 represented as a deadline
+ */
+__syscall int k_thread_budget_set(k_tid_t thread, uint32_t budget_us,
+				  uint32_t period_us);
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 /**
  * @brief Sets all CPU enable masks to zero
@@ -1272,8 +1336,9 @@ const char *k_thread_state_str(k_tid_t thread_id);
 struct k_timer {
 	/*
 	 * _timeout structure must be first here if we want to use
-	 * dynamic timer allocation. timeout.node is used in the double-linked
-	 * list of free timers
+	 * dynamic timer allocation. timeout.node links the timer into the
+	 * timeout queue: a red-black tree node with
+	 * CONFIG_TIMEOUT_QUEUE_SCALABLE, a double-linked list node otherwise
 	 */
 	struct _timeout timeout;
 
@@ -1405,6 +1470,55 @@ extern void k_timer_init(struct k_timer *timer,
 __syscall void k_timer_start(struct k_timer *timer,
 			     k_timeout_t duration, k_timeout_t period);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Set the slack of a timer.
+ *
+ * This routine allows each expiry of the timer to be deferred by up to
+ * @a slack, so that the kernel can handle it together with other timer
+ * expirations in a single timer interrupt.  Expiry never happens
+ * earlier than requested.  Since the period of a periodic timer is
+ * counted from its actual expiry, the delays of successive periods
+ * can accumulate.
+ *
+ * The slack applies from the next call to k_timer_start(), and is
+ * reset to zero by k_timer_init().
+ *
+ * @param timer     Address of timer.
+ * @param slack     Maximum deferral of each expiry, K_NO_WAIT for none.
+ *
+ * @return N/A
+ */
+__syscall void k_timer_slack_set(struct k_timer *timer, k_timeout_t slack);
+
+/**
+ * @brief Timer slack statistics
+ */
+struct k_timer_slack_stats {
+	/** Timeouts expired */
+	uint32_t expired;
+	/** Distinct ticks at which timeouts expired */
+	uint32_t wakeups;
+	/** Slack timeouts moved onto an already pending expiry */
+	uint32_t coalesced;
+	/** Slack timeouts moved onto a shared tick boundary */
+	uint32_t aligned;
+};
+
+/**
+ * @brief Get timer slack statistics.
+ *
+ * The difference between the @a expired and @a wakeups counters is
+ * the number of expirations which did not need a timer wakeup of
+ * their own.
+ *
+ * @param stats Pointer to struct to copy statistics into.
+ *
+ * @return N/A
+ */
+void k_timer_slack_stats_get(struct k_timer_slack_stats *stats);
+#endif
+
 /**
  * @brief Stop a timer.
  *
@@ -1554,6 +1668,16 @@ static inline void *z_impl_k_timer_user_data_get(const struct k_timer *timer)
  * @{
  */
 
+/**
+ * @brief Get system uptime, in system ticks.
+ *
+ * Unlike k_uptime_ticks(), this always makes a system call when invoked
+ * from user mode.
+ *
+ * @return Current uptime in ticks.
+ */
+__syscall int64_t z_uptime_ticks(void);
+
 /**
  * @brief Get system uptime, in system ticks.
  *
@@ -1561,9 +1685,19 @@ static inline void *z_impl_k_timer_user_data_get(const struct k_timer *timer)
  * ticks (c.f. @option{CONFIG_SYS_CLOCK_TICKS_PER_SEC}), which is the
  * fundamental unit of resolution of kernel timekeeping.
  *
+ * With @option{CONFIG_USER_TIME_PAGE}, the uptime is read from the kernel
+ * time page without a system call.
+ *
  * @return Current uptime in ticks.
  */
-__syscall int64_t k_uptime_ticks(void);
+static inline int64_t k_uptime_ticks(void)
+{
+#ifdef CONFIG_USER_TIME_PAGE
+	return z_time_page_ticks();
+#else
+	return z_uptime_ticks();
+#endif
+}
 
 /**
  * @brief Get system uptime.
@@ -1654,21 +1788,33 @@ struct k_queue {
 	sys_sflist_t data_q;
 	struct k_spinlock lock;
 	_wait_q_t wait_q;
+#ifdef CONFIG_QUEUE_MPSC
+	bool mpsc;
+#endif
 
 	_POLL_EVENT;
 	_OBJECT_TRACING_NEXT_PTR(k_queue)
 	_OBJECT_TRACING_LINKED_FLAG
 };
 
-#define Z_QUEUE_INITIALIZER(obj) \
+#ifdef CONFIG_QUEUE_MPSC
+#define _QUEUE_MPSC_INIT(is_mpsc) .mpsc = is_mpsc,
+#else
+#define _QUEUE_MPSC_INIT(is_mpsc)
+#endif
+
+#define Z_QUEUE_INITIALIZER_MODE(obj, is_mpsc) \
 	{ \
 	.data_q = SYS_SFLIST_STATIC_INIT(&obj.data_q), \
 	.lock = { }, \
 	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q),	\
+	_QUEUE_MPSC_INIT(is_mpsc)		\
 	_POLL_EVENT_OBJ_INIT(obj)		\
 	_OBJECT_TRACING_INIT \
 	}
 
+#define Z_QUEUE_INITIALIZER(obj) Z_QUEUE_INITIALIZER_MODE(obj, false)
+
 extern void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
 
 /**
@@ -1692,6 +1838,31 @@ extern void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
  */
 __syscall void k_queue_init(struct k_queue *queue);
 
+#if defined(CONFIG_QUEUE_MPSC) || defined(__DOXYGEN__)
+/**
+ * @brief Initialize a multi-producer, single-consumer queue.
+ *
+ * This routine initializes a queue object like k_queue_init(), but for
+ * use by any number of producers and a single consumer thread. Appending
+ * to such a queue is lock-free: it takes an atomic exchange, and only
+ * the append that makes the queue non-empty takes the queue's lock to
+ * wake the consumer or signal k_poll() waiters. The consumer removes
+ * items without taking the lock unless it has to wait.
+ *
+ * Such a queue supports appending, with k_queue_append(),
+ * k_queue_alloc_append(), k_queue_append_list() and k_queue_merge_slist(),
+ * and getting with k_queue_get(). The consumer can also use k_poll(),
+ * k_queue_is_empty() and k_queue_peek_head(). Inserting elsewhere than
+ * at the tail, removing items with k_queue_remove() and getting items
+ * from more than one thread are not supported.
+ *
+ * @param queue Address of the queue.
+ *
+ * @return N/A
+ */
+void k_queue_init_mpsc(struct k_queue *queue);
+#endif
+
 /**
  * @brief Cancel waiting on a queue.
  *
@@ -2075,6 +2246,20 @@ struct k_fifo {
 #define k_fifo_init(fifo) \
 	k_queue_init(&(fifo)->_queue)
 
+/**
+ * @brief Initialize a multi-producer, single-consumer FIFO queue.
+ *
+ * This routine initializes a FIFO queue which any number of threads and
+ * ISRs may put items into without taking a lock, and which only a single
+ * thread gets items from. See k_queue_init_mpsc().
+ *
+ * @param fifo Address of the FIFO queue.
+ *
+ * @return N/A
+ */
+#define k_fifo_init_mpsc(fifo) \
+	k_queue_init_mpsc(&(fifo)->_queue)
+
 /**
  * @brief Cancel waiting on a FIFO queue.
  *
@@ -2241,6 +2426,17 @@ struct k_fifo {
 	Z_STRUCT_SECTION_ITERABLE_ALTERNATE(k_queue, k_fifo, name) = \
 		Z_FIFO_INITIALIZER(name)
 
+/**
+ * @brief Statically define a multi-producer, single-consumer FIFO queue.
+ *
+ * This is the static counterpart of k_fifo_init_mpsc().
+ *
+ * @param name Name of the FIFO queue.
+ */
+#define K_FIFO_DEFINE_MPSC(name) \
+	Z_STRUCT_SECTION_ITERABLE_ALTERNATE(k_queue, k_fifo, name) = \
+		{ ._queue = Z_QUEUE_INITIALIZER_MODE(name._queue, true) }
+
 /** @} */
 
 struct k_lifo {
@@ -2698,6 +2894,161 @@ __syscall int k_condvar_wait(struct k_condvar *condvar, struct k_mutex *mutex,
  * @cond INTERNAL_HIDDEN
  */
 
+struct k_rwlock {
+	/** Readers waiting for the lock */
+	_wait_q_t rd_wait_q;
+
+	/** Writers waiting for the lock */
+	_wait_q_t wr_wait_q;
+
+	/** Writer holding the lock, if any */
+	struct k_thread *writer;
+
+	/** Number of readers holding the lock */
+	uint32_t readers;
+
+	/** K_RWLOCK_* flags */
+	uint32_t flags;
+
+	/** Original priority of the writer holding the lock */
+	int owner_orig_prio;
+};
+
+#define Z_RWLOCK_INITIALIZER(obj, rwlock_flags)                                \
+	{                                                                      \
+		.rd_wait_q = Z_WAIT_Q_INIT(&obj.rd_wait_q),                    \
+		.wr_wait_q = Z_WAIT_Q_INIT(&obj.wr_wait_q),                    \
+		.writer = NULL,                                                \
+		.readers = 0,                                                  \
+		.flags = rwlock_flags,                                         \
+		.owner_orig_prio = K_LOWEST_THREAD_PRIO,                       \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup rwlock_apis Reader-Writer Lock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Keep new readers out whenever a writer is waiting
+ *
+ * By default a waiting writer only keeps out new readers of lower priority
+ * than itself.
+ */
+#define K_RWLOCK_PREFER_WRITER BIT(0)
+
+/**
+ * @brief Initialize a reader-writer lock.
+ *
+ * This routine initializes a reader-writer lock, prior to its first use.
+ *
+ * Upon completion, the lock is available and does not have an owner.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param flags 0 or K_RWLOCK_PREFER_WRITER.
+ *
+ * @retval 0 Reader-writer lock object created
+ * @retval -EINVAL Unknown flags
+ */
+__syscall int k_rwlock_init(struct k_rwlock *rwlock, uint32_t flags);
+
+/**
+ * @brief Lock a reader-writer lock for reading.
+ *
+ * This routine locks @a rwlock for reading.  Any number of threads may
+ * hold the lock for reading at the same time, unless a writer holds it.
+ * A waiting writer of higher priority than the calling thread, or any
+ * waiting writer if the lock was initialized with K_RWLOCK_PREFER_WRITER,
+ * also keeps the calling thread waiting.
+ *
+ * A thread must not lock a reader-writer lock for reading again while it
+ * holds it, as it may then wait behind a writer that waits for it.
+ *
+ * Reader-writer locks may not be used in ISRs.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the lock,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Lock locked for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_rwlock_read_lock(struct k_rwlock *rwlock,
+				 k_timeout_t timeout);
+
+/**
+ * @brief Lock a reader-writer lock for writing.
+ *
+ * This routine locks @a rwlock for writing, which excludes every other
+ * writer and reader.  Unlike a mutex, a reader-writer lock may not be
+ * locked recursively.
+ *
+ * While it holds the lock, the calling thread inherits the priority of
+ * the highest priority thread waiting on it, as it would for a mutex.
+ * Threads holding the lock for reading do not inherit priorities.
+ *
+ * Reader-writer locks may not be used in ISRs.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the lock,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Lock locked for writing.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_rwlock_write_lock(struct k_rwlock *rwlock,
+				  k_timeout_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock.
+ *
+ * This routine releases the calling thread's hold on @a rwlock, either for
+ * writing or for reading.  When the last reader or the writer releases
+ * the lock, it is handed to the waiting threads it would have been granted
+ * to, had they tried to lock it then.
+ *
+ * Reader-writer locks may not be used in ISRs.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Lock unlocked.
+ * @retval -EPERM Another thread holds the lock for writing.
+ * @retval -EINVAL The lock is not locked.
+ */
+__syscall int k_rwlock_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Statically define and initialize a reader-writer lock.
+ *
+ * The reader-writer lock can be accessed outside the module where it is
+ * defined using:
+ *
+ * @code extern struct k_rwlock <name>; @endcode
+ *
+ * @param name Name of the reader-writer lock.
+ * @param flags 0 or K_RWLOCK_PREFER_WRITER.
+ */
+#define K_RWLOCK_DEFINE(name, flags)                                           \
+	Z_STRUCT_SECTION_ITERABLE(k_rwlock, name) =                            \
+		Z_RWLOCK_INITIALIZER(name, flags)
+
+/**
+ * @}
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
 struct k_sem {
 	_wait_q_t wait_q;
 	unsigned int count;
@@ -3046,6 +3397,46 @@ void k_work_queue_start(struct k_work_q *queue,
 			k_thread_stack_t *stack, size_t stack_size,
 			int prio, const struct k_work_queue_config *cfg);
 
+/** @brief Add a worker thread to a work queue.
+ *
+ * Each worker, including the thread started by k_work_queue_start(), has
+ * its own list of pending items.  Items submitted from outside the queue
+ * are spread over the lists round robin, items submitted by a work
+ * handler go to the list of the thread running it.  A thread with an
+ * empty list steals the oldest item from the list of another.
+ *
+ * A work item is never run by two threads at the same time: an item
+ * resubmitted while running is only taken by the thread running it.
+ * Items of the same queue may run concurrently otherwise, so the queue
+ * no longer serializes its handlers.  Flush, cancel and delayable work
+ * behave as on a single threaded queue.
+ *
+ * Workers should be added right after k_work_queue_start(), before any
+ * work is submitted or flushed, and cannot be removed again.
+ *
+ * @note Requires CONFIG_WORK_QUEUE_WORKERS.
+ *
+ * @param queue pointer to a started queue.
+ *
+ * @param worker pointer to the worker structure.
+ *
+ * @param stack pointer to the worker thread stack area.
+ *
+ * @param stack_size size of the the worker thread stack area, in bytes.
+ *
+ * @param prio initial thread priority
+ *
+ * @param cpu CPU the worker is pinned to, or -1 to let it run on any CPU.
+ * Pinning requires CONFIG_SCHED_CPU_MASK.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if @p cpu is out of range or pinning is unsupported
+ */
+int k_work_queue_add_worker(struct k_work_q *queue,
+			    struct k_work_q_worker *worker,
+			    k_thread_stack_t *stack, size_t stack_size,
+			    int prio, int cpu);
+
 /** @brief Access the thread that animates a work queue.
  *
  * This is necessary to grant a work queue thread access to things the work
@@ -3113,6 +3504,27 @@ int k_work_queue_unplug(struct k_work_q *queue);
 void k_work_init_delayable(struct k_work_delayable *dwork,
 			   k_work_handler_t handler);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/** @brief Set the slack of a delayable work item.
+ *
+ * Allows the submission of the work item after its delay to be
+ * deferred by up to @p slack, so that its timeout can share a timer
+ * interrupt with other expirations.  It is never submitted earlier
+ * than requested.
+ *
+ * The slack applies to subsequent schedule and reschedule calls, and
+ * is reset to zero by k_work_init_delayable().
+ *
+ * @note Safe to invoke from ISRs.
+ *
+ * @param dwork pointer to the delayable work item.
+ *
+ * @param slack maximum deferral of the submission, K_NO_WAIT for none.
+ */
+void k_work_delayable_slack_set(struct k_work_delayable *dwork,
+				k_timeout_t slack);
+#endif
+
 /**
  * @brief Get the parent delayable work structure from a work pointer.
  *
@@ -3511,10 +3923,19 @@ struct k_work_delayable {
  * processing) the item, and will be processed as soon as the item
  * completes.  When the flusher is processed the semaphore will be
  * signaled, releasing the thread waiting for the flush.
+ *
+ * On a queue with several workers the flusher could be stolen by
+ * another worker and run before the item completes, so there it is
+ * instead put on a global list of pending flushes and counts down
+ * the runs of the item it waits for.
  */
 struct z_work_flusher {
 	struct k_work work;
 	struct k_sem sem;
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	struct k_work *target;
+	uint32_t runs;
+#endif
 };
 
 /* Record used to wait for work to complete a cancellation.
@@ -3581,6 +4002,31 @@ struct k_work_queue_config {
 	bool no_yield;
 };
 
+/** @brief An additional thread processing the items of a work queue.
+ *
+ * See k_work_queue_add_worker().
+ */
+struct k_work_q_worker {
+	/* The thread that animates the worker. */
+	struct k_thread thread;
+
+	/* All the following fields must be accessed only while the
+	 * work module spinlock is held.
+	 */
+
+	/* The queue this worker belongs to. */
+	struct k_work_q *queue;
+
+	/* Next worker of the same queue. */
+	struct k_work_q_worker *next;
+
+	/* Local list of k_work items to be worked. */
+	sys_slist_t pending;
+
+	/* The item being processed, if any. */
+	struct k_work *running;
+};
+
 /** @brief A structure used to hold work until it can be processed. */
 struct k_work_q {
 	/* The thread that animates the work. */
@@ -3601,6 +4047,22 @@ struct k_work_q {
 
 	/* Flags describing queue state. */
 	uint32_t flags;
+
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	/* The item being processed by the thread above, if any. */
+	struct k_work *running;
+
+	/* Additional workers, each with its own pending list. */
+	struct k_work_q_worker *workers;
+
+	/* Worker receiving the next submission from outside the
+	 * queue, NULL for the thread above.
+	 */
+	struct k_work_q_worker *next_worker;
+
+	/* Number of threads processing an item. */
+	uint8_t busy;
+#endif
 };
 
 /* Provide the implementation for inline functions declared above */
@@ -4124,6 +4586,10 @@ struct k_msgq {
 	char *write_ptr;
 	/** Number of used messages */
 	uint32_t used_msgs;
+	/** Threads waiting in k_msgq_put_claim() or k_msgq_get_claim() */
+	_wait_q_t claim_wait_q;
+	/** Number of messages held by k_msgq_get_claim() */
+	uint32_t claimed_msgs;
 
 	_OBJECT_TRACING_NEXT_PTR(k_msgq)
 	_OBJECT_TRACING_LINKED_FLAG
@@ -4146,6 +4612,8 @@ struct k_msgq {
 	.read_ptr = q_buffer, \
 	.write_ptr = q_buffer, \
 	.used_msgs = 0, \
+	.claim_wait_q = Z_WAIT_Q_INIT(&obj.claim_wait_q), \
+	.claimed_msgs = 0, \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -4155,6 +4623,8 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+/* A slot is held by k_msgq_put_claim() */
+#define K_MSGQ_FLAG_PUT_CLAIM	BIT(1)
 
 /**
  * @brief Message Queue Attributes
@@ -4309,12 +4779,125 @@ __syscall int k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout);
  */
 __syscall int k_msgq_peek(struct k_msgq *msgq, void *data);
 
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a max_msgs messages in a "first in, first
+ * out" manner, waiting only for the first one. The messages are stored
+ * back to back in @a data.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Address of area to hold @a max_msgs messages.
+ * @param max_msgs Maximum number of messages to receive.
+ * @param timeout Waiting period to receive the first message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Number of messages received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Messages are held by k_msgq_get_claim().
+ * @retval -EINVAL @a max_msgs is zero.
+ */
+__syscall int k_msgq_get_batch(struct k_msgq *msgq, void *data,
+			       uint32_t max_msgs, k_timeout_t timeout);
+
+/**
+ * @brief Claim a message slot for in place writing.
+ *
+ * This routine hands out a pointer to the next free slot of the message
+ * queue's ring buffer, so the producer can build the message in place
+ * instead of having it copied by k_msgq_put(). The message is only sent
+ * by k_msgq_put_finish().
+ *
+ * One put claim at a time is supported. While it is held, k_msgq_put()
+ * fails with -EBUSY.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @note Not available from user mode, the slot is kernel memory.
+ *
+ * @param msgq Address of the message queue.
+ * @param slot Set to the address of the claimed slot.
+ * @param timeout Waiting period for a free slot,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Slot claimed.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another put claim is held or being waited for.
+ */
+int k_msgq_put_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout);
+
+/**
+ * @brief Release the slot claimed by k_msgq_put_claim().
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param msgq Address of the message queue.
+ * @param commit True to send the message, false to drop it.
+ *
+ * @retval 0 Slot released.
+ * @retval -EINVAL No put claim is held.
+ */
+int k_msgq_put_finish(struct k_msgq *msgq, bool commit);
+
+/**
+ * @brief Claim messages for in place reading.
+ *
+ * This routine hands out a pointer to the oldest message in the message
+ * queue's ring buffer, and the number of messages following it back to
+ * back, so the consumer can process them in place instead of having them
+ * copied by k_msgq_get(). The messages stay in the queue until released
+ * by k_msgq_get_finish().
+ *
+ * One get claim at a time is supported. While it is held, k_msgq_get()
+ * and k_msgq_get_batch() fail with -EBUSY.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @note Not available from user mode, the messages are kernel memory.
+ *
+ * @param msgq Address of the message queue.
+ * @param msgs Set to the address of the first claimed message.
+ * @param max_msgs Maximum number of messages to claim.
+ * @param timeout Waiting period for a message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Number of messages claimed.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another get claim is held or being waited for.
+ * @retval -EINVAL @a max_msgs is zero.
+ */
+int k_msgq_get_claim(struct k_msgq *msgq, void **msgs, uint32_t max_msgs,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Release messages claimed by k_msgq_get_claim().
+ *
+ * The first @a num_msgs claimed messages are removed from the queue, the
+ * others are left at its head.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param msgq Address of the message queue.
+ * @param num_msgs Number of messages consumed.
+ *
+ * @retval 0 Messages released.
+ * @retval -EINVAL More messages than claimed.
+ */
+int k_msgq_get_finish(struct k_msgq *msgq, uint32_t num_msgs);
+
 /**
  * @brief Purge a message queue.
  *
  * This routine discards all unreceived messages in a message queue's ring
- * buffer. Any threads that are blocked waiting to send a message to the
- * message queue are unblocked and see an -ENOMSG error code.
+ * buffer, including messages held by k_msgq_get_claim(). Any threads that
+ * are blocked waiting to send a message to the message queue or to claim a
+ * slot are unblocked and see an -ENOMSG error code.
  *
  * @param msgq Address of the message queue.
  *
@@ -4550,6 +5133,8 @@ struct k_pipe {
 	size_t         bytes_used;      /**< # bytes used in buffer */
 	size_t         read_index;      /**< Where in buffer to read from */
 	size_t         write_index;     /**< Where in buffer to write */
+	size_t         put_claimed;     /**< # bytes held by k_pipe_put_claim() */
+	size_t         get_claimed;     /**< # bytes held by k_pipe_get_claim() */
 	struct k_spinlock lock;		/**< Synchronization lock */
 
 	struct {
@@ -4574,6 +5159,8 @@ struct k_pipe {
 	.bytes_used = 0,                                            \
 	.read_index = 0,                                            \
 	.write_index = 0,                                           \
+	.put_claimed = 0,                                           \
+	.get_claimed = 0,                                           \
 	.lock = {},                                                 \
 	.wait_q = {                                                 \
 		.readers = Z_WAIT_Q_INIT(&obj.wait_q.readers),       \
@@ -4716,14 +5303,126 @@ __syscall size_t k_pipe_read_avail(struct k_pipe *pipe);
  */
 __syscall size_t k_pipe_write_avail(struct k_pipe *pipe);
 
+/**
+ * @brief Claim free space of a pipe's ring buffer for in place writing.
+ *
+ * This routine hands out a pointer into the pipe's ring buffer, so the
+ * producer can build data in place instead of having it copied by
+ * k_pipe_put(). The claimed space is contiguous, so less than @a size bytes
+ * may be claimed when the free space wraps around the end of the buffer.
+ * The data is only written by k_pipe_put_finish().
+ *
+ * One put claim at a time is supported. While it is held, k_pipe_put()
+ * fails with -EBUSY.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @note Not available from user mode, the buffer is kernel memory.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the address of the claimed space.
+ * @param size Maximum number of bytes to claim.
+ * @param timeout Waiting period for free space,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of bytes claimed.
+ * @retval -EIO Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A put claim is already held.
+ * @retval -EINVAL Pipe has no buffer or @a size is zero.
+ */
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t size,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Write data claimed by k_pipe_put_claim().
+ *
+ * The first @a size claimed bytes are added to the pipe, the rest of the
+ * claim is dropped. Waiting readers are served from the new data.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes written.
+ *
+ * @retval 0 Claim released.
+ * @retval -EINVAL More bytes than claimed.
+ */
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim data in a pipe's ring buffer for in place reading.
+ *
+ * This routine hands out a pointer to the oldest data in the pipe's ring
+ * buffer, so the consumer can process it in place instead of having it
+ * copied by k_pipe_get(). The claimed data is contiguous, so less than
+ * @a size bytes may be claimed when the data wraps around the end of the
+ * buffer. It stays in the pipe until released by k_pipe_get_finish().
+ *
+ * One get claim at a time is supported. While it is held, k_pipe_get()
+ * fails with -EBUSY.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @note Not available from user mode, the buffer is kernel memory.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the address of the claimed data.
+ * @param size Maximum number of bytes to claim.
+ * @param timeout Waiting period for data,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of bytes claimed.
+ * @retval -EIO Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A get claim is already held.
+ * @retval -EINVAL Pipe has no buffer or @a size is zero.
+ */
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t size,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Release data claimed by k_pipe_get_claim().
+ *
+ * The first @a size claimed bytes are removed from the pipe, the rest is
+ * left at its head. Waiting writers are served from the freed space.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes consumed.
+ *
+ * @retval 0 Claim released.
+ * @retval -EINVAL More bytes than claimed.
+ */
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size);
+
 /** @} */
 
 /**
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+struct z_mem_slab_magazine {
+	uint32_t count;
+	void *rounds[CONFIG_MEM_SLAB_MAGAZINE_SIZE];
+};
+
+/* Per-CPU front end of a memory slab.  The lock is only ever
+ * contended when another CPU reclaims the cached blocks.
+ */
+struct z_mem_slab_cache {
+	struct k_spinlock lock;
+	struct z_mem_slab_magazine loaded;
+	struct z_mem_slab_magazine previous;
+	uint32_t alloc_hits;
+	uint32_t free_hits;
+	uint32_t exchanges;
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
+	struct k_spinlock lock;
 	uint32_t num_blocks;
 	size_t block_size;
 	char *buffer;
@@ -4732,6 +5431,14 @@ struct k_mem_slab {
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	uint32_t max_used;
 #endif
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	/* threads about to pend or pending on wait_q */
+	atomic_t waiters;
+	uint32_t alloc_misses;
+	uint32_t free_misses;
+	uint32_t max_out;
+	struct z_mem_slab_cache cache[CONFIG_MP_NUM_CPUS];
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 	_OBJECT_TRACING_LINKED_FLAG
@@ -4741,6 +5448,7 @@ struct k_mem_slab {
 			       slab_num_blocks) \
 	{ \
 	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.lock = {}, \
 	.num_blocks = slab_num_blocks, \
 	.block_size = slab_block_size, \
 	.buffer = slab_buffer, \
@@ -4855,10 +5563,14 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  *
  * @return Number of allocated memory blocks.
  */
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab);
+#else
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
 	return slab->num_used;
 }
+#endif
 
 /**
  * @brief Get the number of maximum used blocks so far in a memory slab.
@@ -4892,9 +5604,48 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+/**
+ * @brief Memory slab per-CPU cache statistics
+ */
+struct k_mem_slab_cache_stats {
+	/** Allocations served from a CPU cache */
+	uint32_t alloc_hits;
+	/** Allocations which had to go to the shared free list */
+	uint32_t alloc_misses;
+	/** Frees absorbed by a CPU cache */
+	uint32_t free_hits;
+	/** Frees which had to go to the shared free list */
+	uint32_t free_misses;
+	/** Bulk magazine exchanges with the shared free list */
+	uint32_t exchanges;
+	/** Blocks currently held in CPU caches */
+	uint32_t cached;
+	/** High watermark of blocks out of the shared free list,
+	 * including cached ones
+	 */
+	uint32_t max_out;
+};
+
+/**
+ * @brief Get the per-CPU cache statistics of a memory slab.
+ *
+ * Counters are summed over all CPUs.  They are read without stopping
+ * other CPUs, so they are only a consistent snapshot when the slab
+ * is idle.
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Pointer to struct to copy statistics into.
+ *
+ * @return N/A
+ */
+void k_mem_slab_cache_stats_get(struct k_mem_slab *slab,
+				struct k_mem_slab_cache_stats *stats);
+#endif
+
 /** @} */
 
 /**
@@ -4979,6 +5730,19 @@ static inline void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+/**
+ * @brief Get the runtime statistics of a k_heap
+ *
+ * Takes a consistent snapshot of the heap's allocated and free byte
+ * counts, allocation high watermark, largest free chunk and free
+ * chunk counts per size bucket.  See struct sys_heap_runtime_stats.
+ *
+ * @param h Heap to query
+ * @param stats Struct into which to store the statistics
+ */
+void k_heap_runtime_stats_get(struct k_heap *h,
+			      struct sys_heap_runtime_stats *stats);
+
 /**
  * @brief Define a static k_heap
  *
@@ -5028,6 +5792,74 @@ void k_heap_free(struct k_heap *h, void *mem);
  */
 extern void *k_aligned_alloc(size_t align, size_t size);
 
+/**
+ * @brief Allocate memory with given attributes from the heap.
+ *
+ * Like k_aligned_alloc(), but routes the allocation across the heap
+ * memory pool and the regions added with k_malloc_region_add() by
+ * the requested SYS_MHEAP_ATTR_* attributes.  SYS_MHEAP_ATTR_DMA is
+ * a requirement, the other attributes are preferences, see
+ * sys/multi_heap.h.  Without CONFIG_HEAP_MEM_POOL_REGIONS the
+ * attributes are ignored.
+ *
+ * @param attr Requested SYS_MHEAP_ATTR_* attributes.
+ * @param align Alignment of memory requested (in bytes).
+ * @param size Amount of memory requested (in bytes).
+ *
+ * @return Address of the allocated memory if successful; otherwise NULL.
+ */
+extern void *k_aligned_alloc_attr(uint32_t attr, size_t align, size_t size);
+
+/**
+ * @brief Allocate memory with given attributes from the heap.
+ *
+ * Same as k_aligned_alloc_attr() with k_malloc() alignment.  The
+ * memory is freed with k_free().
+ *
+ * @param attr Requested SYS_MHEAP_ATTR_* attributes.
+ * @param size Amount of memory requested (in bytes).
+ *
+ * @return Address of the allocated memory if successful; otherwise NULL.
+ */
+static inline void *k_malloc_attr(uint32_t attr, size_t size)
+{
+	return k_aligned_alloc_attr(attr, sizeof(void *), size);
+}
+
+#if (CONFIG_HEAP_MEM_POOL_REGIONS > 0)
+/**
+ * @brief Add a memory region to the heap.
+ *
+ * Makes the memory available to k_malloc() and friends, tagged with
+ * the given attributes.  Regions are tried in the order they were
+ * added, after the heap memory pool.  Requires
+ * CONFIG_HEAP_MEM_POOL_REGIONS > 0.
+ *
+ * @param mem Untyped pointer to unused memory.
+ * @param bytes Size of region pointed to by @a mem.
+ * @param attr SYS_MHEAP_ATTR_* attributes of the memory.
+ *
+ * @return Index of the new region, -ENOMEM if
+ *         CONFIG_HEAP_MEM_POOL_REGIONS regions were already added.
+ */
+extern int k_malloc_region_add(void *mem, size_t bytes, uint32_t attr);
+
+/**
+ * @brief Get the statistics of one heap region.
+ *
+ * Region 0 is the heap memory pool, the others are numbered as
+ * returned by k_malloc_region_add().  Requires
+ * CONFIG_HEAP_MEM_POOL_REGIONS > 0.
+ *
+ * @param region Region index.
+ * @param stats Struct into which to store the statistics.
+ *
+ * @return 0 on success, -EINVAL for an invalid region index.
+ */
+extern int k_malloc_region_stats_get(int region,
+				     struct sys_multi_heap_region_stats *stats);
+#endif /* CONFIG_HEAP_MEM_POOL_REGIONS > 0 */
+
 /**
  * @brief Allocate memory from the heap.
  *
@@ -5071,6 +5903,18 @@ extern void k_free(void *ptr);
  */
 extern void *k_calloc(size_t nmemb, size_t size);
 
+/**
+ * @brief Get the runtime statistics of the k_malloc() heap
+ *
+ * Note that the byte counts include the small per-allocation header
+ * k_malloc() uses to find the heap again on k_free().
+ *
+ * @param stats Struct into which to store the statistics
+ *
+ * @return N/A
+ */
+extern void k_malloc_runtime_stats_get(struct sys_heap_runtime_stats *stats);
+
 /** @} */
 
 /* polling API - PRIVATE */
@@ -5375,6 +6219,134 @@ __syscall void k_poll_signal_check(struct k_poll_signal *sig,
 
 __syscall int k_poll_signal_raise(struct k_poll_signal *sig, int result);
 
+/**
+ * @brief Persistent poll set
+ *
+ * Unlike the event array passed to k_poll(), entries of a poll set are
+ * registered with their objects once and stay registered across waits.
+ * When an object becomes ready its entry is moved to the set's ready
+ * list, so k_poll_set_wait() costs O(ready entries) instead of O(entries).
+ */
+struct k_poll_set {
+	/** PRIVATE - entry storage, free entries have a NULL obj */
+	struct k_poll_event *events;
+
+	/** PRIVATE - number of entries in storage */
+	int num_events;
+
+	/** PRIVATE - entries signaled and not yet found consumed */
+	sys_dlist_t ready;
+
+	/** PRIVATE - threads in k_poll_set_wait() */
+	_wait_q_t wait_q;
+
+	/** PRIVATE - poller all entries are registered with */
+	struct z_poller poller;
+};
+
+/**
+ * @brief Ready entry reported by k_poll_set_wait()
+ */
+struct k_poll_set_result {
+	/** entry identifier, as returned by k_poll_set_add() */
+	int id;
+
+	/** bitfield of K_POLL_STATE_xxx values */
+	uint32_t state;
+};
+
+#define Z_POLL_SET_INITIALIZER(obj, _events, _num_events) \
+	{ \
+	.events = _events, \
+	.num_events = _num_events, \
+	.ready = SYS_DLIST_STATIC_INIT(&obj.ready), \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	}
+
+/**
+ * @brief Statically define and initialize a poll set.
+ *
+ * The poll set can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_poll_set <name>; @endcode
+ *
+ * @param name Name of the poll set.
+ * @param max_events Maximum number of entries in the set.
+ */
+#define K_POLL_SET_DEFINE(name, max_events) \
+	static struct k_poll_event _k_poll_set_events_##name[max_events]; \
+	Z_STRUCT_SECTION_ITERABLE(k_poll_set, name) = \
+		Z_POLL_SET_INITIALIZER(name, _k_poll_set_events_##name, \
+				       max_events)
+
+/**
+ * @brief Initialize a poll set.
+ *
+ * The entry storage is owned by the set from then on. It must be kernel
+ * memory if the set is used from user mode.
+ *
+ * @param set Address of the poll set.
+ * @param events Entry storage.
+ * @param num_events Maximum number of entries in the set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set,
+			    struct k_poll_event *events, int num_events);
+
+/**
+ * @brief Add an entry to a poll set.
+ *
+ * The entry stays registered with @a obj until it is removed with
+ * k_poll_set_remove(). As with k_poll(), threads pending on the object
+ * itself have precedence over the set.
+ *
+ * @param set Address of the poll set.
+ * @param type One of K_POLL_TYPE_SEM_AVAILABLE, K_POLL_TYPE_DATA_AVAILABLE
+ *             or K_POLL_TYPE_SIGNAL.
+ * @param obj Kernel object or poll signal.
+ *
+ * @return Non-negative entry identifier.
+ * @retval -ENOMEM The set is full.
+ * @retval -EINVAL Bad type (user mode only)
+ */
+__syscall int k_poll_set_add(struct k_poll_set *set, uint32_t type, void *obj);
+
+/**
+ * @brief Remove an entry from a poll set.
+ *
+ * @param set Address of the poll set.
+ * @param id Entry identifier returned by k_poll_set_add().
+ *
+ * @retval 0 Entry removed.
+ * @retval -EINVAL No such entry.
+ */
+__syscall int k_poll_set_remove(struct k_poll_set *set, int id);
+
+/**
+ * @brief Wait for entries of a poll set to become ready
+ *
+ * Readiness is level triggered: an entry whose object is still available
+ * is reported again by the next wait, so the caller has to consume the
+ * object (take the semaphore, get the data, reset the signal) to stop
+ * it from being reported. Entries are reported round robin if more are
+ * ready than fit in @a results.
+ *
+ * @param set Address of the poll set.
+ * @param results Array filled with the ready entries.
+ * @param num_results Size of @a results.
+ * @param timeout Waiting period for an entry to be ready,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of entries written to @a results.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL Bad parameters.
+ * @retval -ENOMEM No memory for the results (user mode only)
+ */
+__syscall int k_poll_set_wait(struct k_poll_set *set,
+			      struct k_poll_set_result *results,
+			      int num_results, k_timeout_t timeout);
+
 /**
  * @internal
  */
@@ -5588,6 +6560,32 @@ __syscall int k_float_disable(struct k_thread *thread);
  */
 __syscall int k_float_enable(struct k_thread *thread, unsigned int options);
 
+#ifdef CONFIG_SCHED_IPI_STATS
+
+/**
+ * @brief Scheduler IPI statistics of one CPU
+ */
+struct k_ipi_stats {
+	/** Scheduler IPIs sent by this CPU to other CPUs */
+	uint32_t sent;
+	/** Scheduler IPIs received by this CPU */
+	uint32_t received;
+	/** Received IPIs which resulted in a context switch */
+	uint32_t switched;
+};
+
+/**
+ * @brief Get the scheduler IPI statistics of a CPU
+ *
+ * @param cpu CPU index
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if the CPU index is invalid or stats is NULL,
+ *         otherwise 0
+ */
+int k_sched_ipi_stats_get(int cpu, struct k_ipi_stats *stats);
+
+#endif
+
 #ifdef CONFIG_THREAD_RUNTIME_STATS
 
 /**
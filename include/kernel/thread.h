@@ -90,6 +90,20 @@ struct _thread_base {
 	int prio_deadline;
 #endif
 
+#ifdef CONFIG_SCHED_BUDGET
+	/* CPU budget per period, in cycles, zero when unlimited */
+	uint32_t budget;
+	uint32_t budget_period;
+
+	/* execution cycles at the start of the current period */
+	uint64_t budget_base;
+
+	/* fires when the budget may be used up or, while throttled,
+	 * when it is replenished
+	 */
+	struct _timeout budget_timeout;
+#endif
+
 	uint32_t order_key;
 
 #ifdef CONFIG_SMP
@@ -104,6 +118,11 @@ struct _thread_base {
 
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU whose ready queue holds this thread while queued */
+	uint8_t runq_cpu;
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 	/* "May run on" bits for each CPU */
 	uint8_t cpu_mask;
@@ -273,6 +292,11 @@ struct k_thread {
 	/** resource pool */
 	struct k_heap *resource_pool;
 
+#ifdef CONFIG_HEAP_PROFILER
+	/** Call site of the allocator API call in progress, if any */
+	void *heap_prof_site;
+#endif
+
 #if defined(CONFIG_THREAD_LOCAL_STORAGE)
 	/* Pointer to arch-specific TLS area */
 	uintptr_t tls;
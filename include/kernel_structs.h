@@ -61,6 +61,9 @@
 /* Thread is being aborted */
 #define _THREAD_ABORTING (BIT(5))
 
+/* Thread has used up its CPU budget for the current period */
+#define _THREAD_THROTTLED (BIT(6))
+
 /* Thread is present in the ready queue */
 #define _THREAD_QUEUED (BIT(7))
 
@@ -125,6 +128,23 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	uint8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* threads queued to run on this CPU */
+	struct _ready_q ready_q;
+#endif
+
+#ifdef CONFIG_SCHED_IPI_STATS
+	/* scheduler IPIs sent by / received on this CPU */
+	uint32_t ipi_sent;
+	uint32_t ipi_received;
+
+	/* received IPIs which led to a context switch */
+	uint32_t ipi_switched;
+
+	/* set between IPI receipt and the following scheduling point */
+	uint8_t ipi_pending;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -215,6 +235,22 @@ typedef struct {
 struct _timeout;
 typedef void (*_timeout_func_t)(struct _timeout *t);
 
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+struct _timeout {
+	struct rbnode node;
+	_timeout_func_t fn;
+	/* Absolute expiry tick (not a delta) in the scalable backend */
+	int64_t dticks;
+	/* Insertion order for timeouts expiring on the same tick,
+	 * zero when the timeout is not queued
+	 */
+	uint32_t seq;
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* Ticks by which expiry may be deferred to share a wakeup */
+	uint32_t slack;
+#endif
+};
+#else
 struct _timeout {
 	sys_dnode_t node;
 	_timeout_func_t fn;
@@ -224,7 +260,12 @@ struct _timeout {
 #else
 	int32_t dticks;
 #endif
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* Ticks by which expiry may be deferred to share a wakeup */
+	uint32_t slack;
+#endif
 };
+#endif
 
 #endif /* _ASMLANGUAGE */
 
@@ -838,8 +838,13 @@ struct ifreq {
 #define SO_PROTOCOL 38
 
 /* Socket options for IPPROTO_TCP level */
-/** sockopt: Disable TCP buffering (ignored, for compatibility) */
+/** sockopt: Disable Nagle's algorithm, send partial segments at once */
 #define TCP_NODELAY 1
+/** sockopt: Hold back partial segments until the option is cleared.
+ * Unlike on Linux, there is no 200 ms limit after which they are sent
+ * anyway.
+ */
+#define TCP_CORK 3
 
 /* Socket options for IPPROTO_IPV6 level */
 /** sockopt: Don't support IPv4 access (ignored, for compatibility) */
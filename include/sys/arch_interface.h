@@ -381,6 +381,19 @@ static inline struct _cpu *arch_curr_cpu(void);
  * This will invoke z_sched_ipi() on other CPUs in the system.
  */
 void arch_sched_ipi(void);
+
+#ifdef CONFIG_ARCH_HAS_DIRECTED_IPIS
+/**
+ * Send an interrupt to a subset of CPUs
+ *
+ * This will invoke z_sched_ipi() on each CPU whose bit is set in
+ * @a cpu_bitmap (bit N for CPU index N).  The bit of the calling CPU
+ * is ignored.
+ *
+ * @param cpu_bitmap Bitmask of target CPU indexes
+ */
+void arch_sched_directed_ipi(uint32_t cpu_bitmap);
+#endif
 #endif /* CONFIG_SMP */
 
 /** @} */
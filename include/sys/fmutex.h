@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief public sys_fmutex and sys_fcondvar APIs.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_FMUTEX_H_
+#define ZEPHYR_INCLUDE_SYS_FMUTEX_H_
+
+/*
+ * sys_fmutex and sys_fcondvar exist in user memory.  When user mode is
+ * enabled they are built on k_futex: uncontended operations are done with
+ * atomic operations only, and the futex syscalls are made only to wait
+ * for or to wake up other threads.  When user mode isn't enabled, they
+ * behave like k_mutex and k_condvar.
+ */
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * sys_fmutex structure
+ */
+struct sys_fmutex {
+#ifdef CONFIG_USERSPACE
+	/* 0: unlocked, 1: locked, 2: locked with possible waiters */
+	struct k_futex futex;
+	k_tid_t owner;
+	uint32_t lock_count;
+#else
+	struct k_mutex kernel_mutex;
+#endif
+};
+
+/**
+ * sys_fcondvar structure
+ */
+struct sys_fcondvar {
+#ifdef CONFIG_USERSPACE
+	/* sequence number, bumped by every signal */
+	struct k_futex futex;
+	atomic_t waiters;
+#else
+	struct k_condvar kernel_condvar;
+#endif
+};
+
+/**
+ * @defgroup user_fmutex_apis User mode futex based mutex APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define and initialize a sys_fmutex
+ *
+ * The mutex can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct sys_fmutex <name>; @endcode
+ *
+ * Route this to memory domains using K_APP_DMEM().
+ *
+ * @param _name Name of the mutex.
+ */
+#ifdef CONFIG_USERSPACE
+#define SYS_FMUTEX_DEFINE(_name) \
+	struct sys_fmutex _name = { \
+		.futex = { 0 }, \
+	}
+#else
+/* Stuff this in the section with the rest of the k_mutex objects, since
+ * they are identical and can be treated as a k_mutex in the boot
+ * initialization code
+ */
+#define SYS_FMUTEX_DEFINE(_name) \
+	Z_STRUCT_SECTION_ITERABLE_ALTERNATE(k_mutex, sys_fmutex, _name) = { \
+		.kernel_mutex = Z_MUTEX_INITIALIZER(_name.kernel_mutex) \
+	}
+#endif
+
+/**
+ * @brief Statically define and initialize a sys_fcondvar
+ *
+ * The condition variable can be accessed outside the module where it is
+ * defined using:
+ *
+ * @code extern struct sys_fcondvar <name>; @endcode
+ *
+ * Route this to memory domains using K_APP_DMEM().
+ *
+ * @param _name Name of the condition variable.
+ */
+#ifdef CONFIG_USERSPACE
+#define SYS_FCONDVAR_DEFINE(_name) \
+	struct sys_fcondvar _name = { \
+		.futex = { 0 }, \
+	}
+#else
+#define SYS_FCONDVAR_DEFINE(_name) \
+	Z_STRUCT_SECTION_ITERABLE_ALTERNATE(k_condvar, sys_fcondvar, _name) = { \
+		.kernel_condvar = Z_CONDVAR_INITIALIZER(_name.kernel_condvar) \
+	}
+#endif
+
+/**
+ * @brief Initialize a mutex.
+ *
+ * This routine initializes a mutex, prior to its first use.
+ *
+ * Upon completion, the mutex is available and does not have an owner.
+ *
+ * When user mode is enabled, the mutex must have been defined with
+ * SYS_FMUTEX_DEFINE(), as its futex must be known to the kernel.
+ *
+ * @param mutex Address of the mutex.
+ *
+ * @retval 0 Mutex initialized.
+ */
+int sys_fmutex_init(struct sys_fmutex *mutex);
+
+/**
+ * @brief Lock a mutex.
+ *
+ * This routine locks @a mutex. If the mutex is locked by another thread,
+ * the calling thread waits until the mutex becomes available or until
+ * a timeout occurs.
+ *
+ * A thread is permitted to lock a mutex it has already locked. The operation
+ * completes immediately and the lock count is increased by 1.
+ *
+ * Unlike k_mutex and sys_mutex, the owner of a sys_fmutex does not inherit
+ * the priority of waiting threads.  With CONFIG_CURRENT_THREAD_USE_TLS,
+ * locking an uncontended mutex from user mode makes no system call.
+ *
+ * @param mutex Address of the mutex, which may reside in user memory
+ * @param timeout Waiting period to lock the mutex,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *                The waiting period restarts if the thread is woken up
+ *                but loses the mutex to another thread.
+ *
+ * @retval 0 Mutex locked.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EACCES Caller has no access to provided mutex address
+ * @retval -EINVAL Provided mutex not recognized by the kernel
+ */
+int sys_fmutex_lock(struct sys_fmutex *mutex, k_timeout_t timeout);
+
+/**
+ * @brief Unlock a mutex.
+ *
+ * This routine unlocks @a mutex. The mutex must already be locked by the
+ * calling thread.
+ *
+ * The mutex cannot be claimed by another thread until it has been unlocked by
+ * the calling thread as many times as it was previously locked by that
+ * thread.  A system call is only made if other threads wait for the mutex.
+ *
+ * @param mutex Address of the mutex, which may reside in user memory
+ *
+ * @retval 0 Mutex unlocked
+ * @retval -EACCES Caller has no access to provided mutex address
+ * @retval -EINVAL Provided mutex not recognized by the kernel or mutex wasn't
+ *                 locked
+ * @retval -EPERM Caller does not own the mutex
+ */
+int sys_fmutex_unlock(struct sys_fmutex *mutex);
+
+/**
+ * @brief Initialize a condition variable.
+ *
+ * When user mode is enabled, the condition variable must have been
+ * defined with SYS_FCONDVAR_DEFINE(), as its futex must be known to the
+ * kernel.
+ *
+ * @param condvar Address of the condition variable.
+ *
+ * @retval 0 Condition variable initialized.
+ */
+int sys_fcondvar_init(struct sys_fcondvar *condvar);
+
+/**
+ * @brief Wake up one thread waiting on a condition variable.
+ *
+ * A system call is only made if threads wait on @a condvar.
+ *
+ * @param condvar Address of the condition variable.
+ *
+ * @retval 0 On success
+ * @retval -EACCES Caller has no access to provided condition variable
+ * @retval -EINVAL Provided condition variable not recognized by the kernel
+ */
+int sys_fcondvar_signal(struct sys_fcondvar *condvar);
+
+/**
+ * @brief Wake up all threads waiting on a condition variable.
+ *
+ * A system call is only made if threads wait on @a condvar.
+ *
+ * @param condvar Address of the condition variable.
+ *
+ * @retval 0 On success
+ * @retval -EACCES Caller has no access to provided condition variable
+ * @retval -EINVAL Provided condition variable not recognized by the kernel
+ */
+int sys_fcondvar_broadcast(struct sys_fcondvar *condvar);
+
+/**
+ * @brief Wait on a condition variable.
+ *
+ * This routine atomically releases @a mutex, which must be locked by the
+ * calling thread, waits on @a condvar, and locks @a mutex again, with the
+ * lock count it had, before returning.  The thread may be woken up
+ * spuriously, callers must check their condition again.
+ *
+ * @param condvar Address of the condition variable.
+ * @param mutex Address of the mutex.
+ * @param timeout Waiting period for the condition variable,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 On success
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EPERM Caller does not own the mutex
+ * @retval -EACCES Caller has no access to provided condition variable
+ * @retval -EINVAL Provided condition variable not recognized by the kernel
+ */
+int sys_fcondvar_wait(struct sys_fcondvar *condvar, struct sys_fmutex *mutex,
+		      k_timeout_t timeout);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_FMUTEX_H_ */
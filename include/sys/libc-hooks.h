@@ -34,6 +34,16 @@ __syscall int zephyr_fputc(int c, FILE * stream);
 
 __syscall size_t zephyr_fwrite(const void *_MLIBC_RESTRICT ptr, size_t size,
 				size_t nitems, FILE *_MLIBC_RESTRICT stream);
+
+#ifdef CONFIG_MINIMAL_LIBC_MALLOC
+struct sys_heap_runtime_stats;
+
+/* Runtime statistics of the malloc() arena, see
+ * sys_heap_runtime_stats_get().  Returns -ENOMEM if there is no arena
+ * (CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE is 0).
+ */
+int malloc_runtime_stats_get(struct sys_heap_runtime_stats *stats);
+#endif
 #endif /* CONFIG_NEWLIB_LIBC */
 
 #ifdef CONFIG_USERSPACE
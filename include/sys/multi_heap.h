@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_SYS_MULTI_HEAP_H_
+#define ZEPHYR_INCLUDE_SYS_MULTI_HEAP_H_
+
+#include <sys/sys_heap.h>
+#include <sys/util.h>
+
+/* Multi-region heap front end.
+ *
+ * Many boards have several kinds of RAM: a little fast SRAM (TCM,
+ * CCM), a lot of slower external RAM, regions that can or cannot be
+ * reached by DMA.  A sys_multi_heap manages one sys_heap per such
+ * region, tagged with attribute bits, and routes each allocation to
+ * a region by the attributes the caller asks for.
+ *
+ * Attributes in SYS_MHEAP_ATTR_REQUIRED (DMA) are hard requirements:
+ * such memory is never returned from a region lacking them.  The
+ * others are preferences.  Regions are tried in the order they were
+ * added, in two passes: first those that have every requested
+ * attribute (and are not fast memory, unless fast memory was asked
+ * for, so that default allocations don't eat it up), then as a
+ * fallback any region meeting the hard requirements.
+ */
+
+/** Fast memory (TCM, CCM, on-chip SRAM) */
+#define SYS_MHEAP_ATTR_FAST		BIT(0)
+/** Memory reachable by DMA masters */
+#define SYS_MHEAP_ATTR_DMA		BIT(1)
+/** Cached memory */
+#define SYS_MHEAP_ATTR_CACHEABLE	BIT(2)
+
+/** No particular requirements */
+#define SYS_MHEAP_ATTR_DEFAULT		0
+
+/** Attributes which are requirements rather than preferences */
+#define SYS_MHEAP_ATTR_REQUIRED		SYS_MHEAP_ATTR_DMA
+
+/* Region selection policy, shared with the kernel's k_malloc()
+ * regions.  Pass 0 is the preferred match, pass 1 the fallback.
+ */
+#define Z_MHEAP_PASSES 2
+
+static inline bool z_multi_heap_attr_match(uint32_t region_attr,
+					   uint32_t attr, int pass)
+{
+	uint32_t need = pass == 0 ? attr : (attr & SYS_MHEAP_ATTR_REQUIRED);
+
+	if ((region_attr & need) != need) {
+		return false;
+	}
+
+	return pass != 0 || (attr & SYS_MHEAP_ATTR_FAST) != 0U ||
+		(region_attr & SYS_MHEAP_ATTR_FAST) == 0U;
+}
+
+#ifdef CONFIG_SYS_MULTI_HEAP
+struct sys_multi_heap_region {
+	struct sys_heap heap;
+	uintptr_t start;
+	uintptr_t end;
+	uint32_t attr;
+	uint32_t allocs;
+	uint32_t fallback_allocs;
+};
+
+struct sys_multi_heap {
+	int num_regions;
+	uint32_t failures;
+	struct sys_multi_heap_region regions[CONFIG_SYS_MULTI_HEAP_MAX_REGIONS];
+};
+#endif
+
+/** @brief Per-region multi-heap statistics */
+struct sys_multi_heap_region_stats {
+	/** Attributes of the region */
+	uint32_t attr;
+	/** Successful allocations from this region */
+	uint32_t allocs;
+	/** How many of those were fallbacks, i.e. the region did not
+	 * have all the requested attributes
+	 */
+	uint32_t fallback_allocs;
+	/** Usage of the region's heap */
+	struct sys_heap_runtime_stats heap;
+};
+
+/** @brief Initialize a multi-heap
+ *
+ * Initializes an empty multi-heap.  Add memory regions with
+ * sys_multi_heap_add_region().
+ *
+ * @param mheap Multi-heap to initialize
+ */
+void sys_multi_heap_init(struct sys_multi_heap *mheap);
+
+/** @brief Add a memory region to a multi-heap
+ *
+ * Initializes a sys_heap over the region and adds it to the end of
+ * the multi-heap's fallback order.  Regions must not overlap.
+ *
+ * @param mheap Multi-heap to add to
+ * @param mem Untyped pointer to unused memory
+ * @param bytes Size of region pointed to by @a mem
+ * @param attr SYS_MHEAP_ATTR_* attributes of the memory
+ * @return Index of the new region, or -ENOMEM if
+ *         CONFIG_SYS_MULTI_HEAP_MAX_REGIONS regions already exist
+ */
+int sys_multi_heap_add_region(struct sys_multi_heap *mheap, void *mem,
+			      size_t bytes, uint32_t attr);
+
+/** @brief Allocate aligned memory from a multi-heap
+ *
+ * Allocates from the first region in fallback order that matches
+ * @a attr and has room, see above.  Like sys_heap, this is not
+ * internally synchronized.
+ *
+ * @param mheap Multi-heap from which to allocate
+ * @param attr Requested SYS_MHEAP_ATTR_* attributes
+ * @param align Alignment in bytes, must be a power of two (or 0)
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *sys_multi_heap_aligned_alloc(struct sys_multi_heap *mheap,
+				   uint32_t attr, size_t align, size_t bytes);
+
+/** @brief Allocate memory from a multi-heap
+ *
+ * Same as sys_multi_heap_aligned_alloc() with no alignment
+ * requirement.
+ */
+static inline void *sys_multi_heap_alloc(struct sys_multi_heap *mheap,
+					 uint32_t attr, size_t bytes)
+{
+	return sys_multi_heap_aligned_alloc(mheap, attr, 0, bytes);
+}
+
+/** @brief Free memory into a multi-heap
+ *
+ * The owning region is found from the address.  Passing NULL is
+ * legal and has no effect.
+ *
+ * @param mheap Multi-heap to which to return the memory
+ * @param mem A pointer previously returned from this multi-heap
+ */
+void sys_multi_heap_free(struct sys_multi_heap *mheap, void *mem);
+
+/** @brief Get the statistics of one multi-heap region
+ *
+ * @param mheap Multi-heap to query
+ * @param region Region index, as returned by sys_multi_heap_add_region()
+ * @param stats Struct into which to store the statistics
+ * @return 0 on success, -EINVAL for an invalid region index
+ */
+int sys_multi_heap_region_stats_get(struct sys_multi_heap *mheap, int region,
+				    struct sys_multi_heap_region_stats *stats);
+
+#endif /* ZEPHYR_INCLUDE_SYS_MULTI_HEAP_H_ */
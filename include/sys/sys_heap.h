@@ -120,6 +120,17 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes);
  */
 void sys_heap_free(struct sys_heap *heap, void *mem);
 
+/** @brief Return the usable size of an allocation
+ *
+ * Returns the number of bytes the caller may use starting at @a mem,
+ * which is at least the number of bytes that were requested.
+ *
+ * @param heap Heap the memory was allocated from
+ * @param mem A pointer previously returned from an allocation
+ * @return Usable size of the block in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem);
+
 /** @brief Expand the size of an existing allocation
  *
  * Returns a pointer to a new memory region with the same contents,
@@ -149,6 +160,59 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 #define sys_heap_realloc(heap, ptr, bytes) \
 	sys_heap_aligned_realloc(heap, ptr, 0, bytes)
 
+/* Enough for the largest heap sys_heap_init() accepts */
+#define SYS_HEAP_MAX_BUCKETS 32
+
+/** @brief sys_heap runtime statistics
+ *
+ * Byte counts are in units of whole chunks and include the chunk
+ * headers, so allocated_bytes is slightly more than the sum of the
+ * sizes requested by the users.
+ */
+struct sys_heap_runtime_stats {
+	/** Bytes currently allocated */
+	size_t allocated_bytes;
+	/** Bytes currently free */
+	size_t free_bytes;
+	/** High watermark of allocated_bytes */
+	size_t max_allocated_bytes;
+	/** Size of the largest single allocation that can succeed
+	 * right now.  free_bytes much larger than this means the
+	 * heap is fragmented.
+	 */
+	size_t largest_free_bytes;
+	/** Number of valid entries in @a bucket_free_chunks */
+	uint32_t num_buckets;
+	/** Number of free chunks per power-of-two size bucket.
+	 * Bucket n holds chunks of roughly 2^n to 2^(n+1) - 1 units
+	 * of 8 bytes.
+	 */
+	uint32_t bucket_free_chunks[SYS_HEAP_MAX_BUCKETS];
+};
+
+/** @brief Get sys_heap runtime statistics
+ *
+ * The statistics are maintained incrementally by the allocator, so
+ * this is cheap: only the largest free chunk needs a (short) search,
+ * of the single highest non-empty bucket.
+ *
+ * @note Like the rest of the sys_heap API this is not synchronized;
+ * the caller must provide locking.
+ *
+ * @param heap Heap to query
+ * @param stats Struct into which to store the statistics
+ */
+void sys_heap_runtime_stats_get(struct sys_heap *heap,
+				struct sys_heap_runtime_stats *stats);
+
+/** @brief Reset the sys_heap allocation high watermark
+ *
+ * Sets max_allocated_bytes to the current allocated_bytes.
+ *
+ * @param heap Heap to reset
+ */
+void sys_heap_runtime_stats_reset_max(struct sys_heap *heap);
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Kernel time page, readable by user threads without a system call
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_TIME_PAGE_H_
+#define ZEPHYR_INCLUDE_SYS_TIME_PAGE_H_
+
+#ifdef CONFIG_USER_TIME_PAGE
+
+#include <toolchain.h>
+#include <zephyr/types.h>
+#include <sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Z_TIME_PAGE_SIZE CONFIG_MMU_PAGE_SIZE
+
+/*
+ * The time page is a page of kernel memory which every memory domain maps
+ * read-only for user threads.  It is only written by the kernel, under
+ * its timeout lock, and it is read locklessly: the sequence number is odd
+ * while an update is in progress and changes with every update, so that
+ * readers retry if it was odd or has changed while they read the page.
+ * The tick count is stored as two words so that every access to the page
+ * is a single atomic one, which orders it against the sequence number.
+ */
+struct z_time_page {
+	atomic_t seq;
+	atomic_t ticks_lo;
+	atomic_t ticks_hi;
+	atomic_t hw_cycles_per_sec;
+};
+
+union z_time_page_storage {
+	struct z_time_page page;
+	/* nothing else may share the page with the time */
+	uint8_t data[Z_TIME_PAGE_SIZE];
+};
+
+extern union z_time_page_storage z_time_page;
+
+static inline atomic_val_t z_time_page_read_begin(void)
+{
+	atomic_val_t seq;
+
+	do {
+		seq = atomic_get(&z_time_page.page.seq);
+	} while ((seq & 1) != 0);
+
+	return seq;
+}
+
+static inline bool z_time_page_read_retry(atomic_val_t seq)
+{
+	return atomic_get(&z_time_page.page.seq) != seq;
+}
+
+/* Uptime in ticks, as last announced by the system timer driver */
+static inline int64_t z_time_page_ticks(void)
+{
+	atomic_val_t seq;
+	uint32_t lo, hi;
+
+	do {
+		seq = z_time_page_read_begin();
+		lo = (uint32_t)atomic_get(&z_time_page.page.ticks_lo);
+		hi = (uint32_t)atomic_get(&z_time_page.page.ticks_hi);
+	} while (z_time_page_read_retry(seq));
+
+	return (int64_t)(((uint64_t)hi << 32) | lo);
+}
+
+/* Hardware cycle rate, a single word which needs no retry */
+static inline int z_time_page_hw_cycles_per_sec(void)
+{
+	return (int)atomic_get(&z_time_page.page.hw_cycles_per_sec);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_USER_TIME_PAGE */
+
+#endif /* ZEPHYR_INCLUDE_SYS_TIME_PAGE_H_ */
@@ -7,6 +7,8 @@
 #ifndef ZEPHYR_INCLUDE_TIME_UNITS_H_
 #define ZEPHYR_INCLUDE_TIME_UNITS_H_
 
+#include <sys/time_page.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -49,7 +51,10 @@ static inline int z_impl_sys_clock_hw_cycles_per_sec_runtime_get(void)
 
 static TIME_CONSTEXPR inline int sys_clock_hw_cycles_per_sec(void)
 {
-#if defined(CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME)
+#if defined(CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME) && \
+	defined(CONFIG_USER_TIME_PAGE)
+	return z_time_page_hw_cycles_per_sec();
+#elif defined(CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME)
 	return sys_clock_hw_cycles_per_sec_runtime_get();
 #else
 	return CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
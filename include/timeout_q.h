@@ -22,10 +22,36 @@ extern "C" {
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+static inline void z_init_timeout(struct _timeout *to)
+{
+	to->seq = 0U;
+#ifdef CONFIG_TIMEOUT_SLACK
+	to->slack = 0U;
+#endif
+}
+#else
 static inline void z_init_timeout(struct _timeout *to)
 {
 	sys_dnode_init(&to->node);
+#ifdef CONFIG_TIMEOUT_SLACK
+	to->slack = 0U;
+#endif
 }
+#endif
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Sets how far (in ticks) the expiry of a timeout may be deferred so
+ * it can share a wakeup with other timeouts.  Takes effect the next
+ * time the timeout is added.
+ */
+static inline void z_set_timeout_slack(struct _timeout *to, k_timeout_t slack)
+{
+	__ASSERT(!K_TIMEOUT_EQ(slack, K_FOREVER), "slack can't be K_FOREVER");
+
+	to->slack = (uint32_t)CLAMP(slack.ticks, 0, INT32_MAX - 1);
+}
+#endif
 
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 		   k_timeout_t timeout);
@@ -34,7 +60,11 @@ int z_abort_timeout(struct _timeout *to);
 
 static inline bool z_is_inactive_timeout(const struct _timeout *to)
 {
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	return to->seq == 0U;
+#else
 	return !sys_dnode_is_linked(&to->node);
+#endif
 }
 
 static inline void z_init_thread_timeout(struct _thread_base *thread_base)
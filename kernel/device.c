@@ -8,6 +8,10 @@
 #include <device.h>
 #include <sys/atomic.h>
 #include <syscall_handler.h>
+#include <kernel_internal.h>
+#include <debug/boot_profiler.h>
+#include <logging/log.h>
+LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
 extern const struct init_entry __init_start[];
 extern const struct init_entry __init_PRE_KERNEL_1_start[];
@@ -57,6 +61,204 @@ void z_device_state_init(void)
 	}
 }
 
+static void init_entry_run(const struct init_entry *entry)
+{
+	const struct device *dev = entry->dev;
+#ifdef CONFIG_BOOT_PROFILER
+	int record = z_boot_prof_init_enter(entry);
+#endif
+	int rc = entry->init(dev);
+
+#ifdef CONFIG_BOOT_PROFILER
+	z_boot_prof_init_exit(record);
+#endif
+	if (dev != NULL) {
+		/* Mark device initialized.  If initialization
+		 * failed, record the error condition.
+		 */
+		if (rc != 0) {
+			if (rc < 0) {
+				rc = -rc;
+			}
+			if (rc > UINT8_MAX) {
+				rc = UINT8_MAX;
+			}
+			dev->state->init_res = rc;
+		}
+		dev->state->initialized = true;
+	}
+}
+
+#ifdef CONFIG_DEVICE_INIT_PARALLEL
+/*
+ * Parallel initialization: the calling thread walks the entries of a
+ * level in their usual order and hands each device entry to an idle
+ * worker thread as soon as none of the devices it requires is still
+ * being initialized by another worker.  Entries which carry no
+ * dependency information (SYS_INIT() hooks and devices without
+ * devicetree handles) may rely on anything earlier in the level, so
+ * they wait for every worker to be idle and run in the calling thread.
+ * The workers only exist for the duration of a level.
+ */
+struct init_worker {
+	struct k_thread thread;
+	struct k_sem start;
+	/* Entry being initialized, NULL when idle */
+	const struct init_entry *entry;
+};
+
+static struct init_worker init_workers[CONFIG_DEVICE_INIT_PARALLEL_THREADS];
+static K_KERNEL_STACK_ARRAY_DEFINE(init_worker_stacks,
+				   CONFIG_DEVICE_INIT_PARALLEL_THREADS,
+				   CONFIG_DEVICE_INIT_PARALLEL_STACK_SIZE);
+static struct k_spinlock init_lock;
+static struct k_sem init_done;
+
+static void init_worker_main(void *p1, void *p2, void *p3)
+{
+	struct init_worker *worker = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		const struct init_entry *entry;
+		uint32_t start;
+
+		(void)k_sem_take(&worker->start, K_FOREVER);
+		entry = worker->entry;
+		if (entry == NULL) {
+			/* End of the level */
+			return;
+		}
+
+		start = k_cycle_get_32();
+		init_entry_run(entry);
+		LOG_DBG("%s init: %u us", entry->dev->name,
+			k_cyc_to_us_ceil32(k_cycle_get_32() - start));
+
+		k_spinlock_key_t key = k_spin_lock(&init_lock);
+
+		worker->entry = NULL;
+		k_spin_unlock(&init_lock, key);
+		k_sem_give(&init_done);
+	}
+}
+
+static bool init_entry_independent(const struct init_entry *entry)
+{
+	return (entry->dev != NULL) && (entry->dev->handles != NULL);
+}
+
+static bool init_worker_busy_with(device_handle_t handle)
+{
+	for (int i = 0; i < ARRAY_SIZE(init_workers); i++) {
+		const struct init_entry *entry = init_workers[i].entry;
+
+		if ((entry != NULL) &&
+		    (device_handle_get(entry->dev) == handle)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Idle worker able to take the entry now, if any */
+static struct init_worker *init_worker_find(const struct init_entry *entry)
+{
+	struct init_worker *idle = NULL;
+	size_t count;
+	const device_handle_t *handles =
+		device_required_handles_get(entry->dev, &count);
+	k_spinlock_key_t key = k_spin_lock(&init_lock);
+
+	for (size_t i = 0; i < count; i++) {
+		if (init_worker_busy_with(handles[i])) {
+			goto out;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(init_workers); i++) {
+		if (init_workers[i].entry == NULL) {
+			idle = &init_workers[i];
+			idle->entry = entry;
+			break;
+		}
+	}
+
+out:
+	k_spin_unlock(&init_lock, key);
+
+	return idle;
+}
+
+static bool init_workers_idle(void)
+{
+	bool idle = true;
+	k_spinlock_key_t key = k_spin_lock(&init_lock);
+
+	for (int i = 0; i < ARRAY_SIZE(init_workers); i++) {
+		if (init_workers[i].entry != NULL) {
+			idle = false;
+			break;
+		}
+	}
+	k_spin_unlock(&init_lock, key);
+
+	return idle;
+}
+
+static void init_workers_wait(void)
+{
+	while (!init_workers_idle()) {
+		(void)k_sem_take(&init_done, K_FOREVER);
+	}
+}
+
+static void init_run_parallel(const struct init_entry *first,
+			      const struct init_entry *end)
+{
+	const struct init_entry *entry;
+	struct init_worker *worker;
+
+	k_sem_init(&init_done, 0, K_SEM_MAX_LIMIT);
+	for (int i = 0; i < ARRAY_SIZE(init_workers); i++) {
+		worker = &init_workers[i];
+		worker->entry = NULL;
+		k_sem_init(&worker->start, 0, 1);
+		k_thread_create(&worker->thread, init_worker_stacks[i],
+				K_KERNEL_STACK_SIZEOF(init_worker_stacks[i]),
+				init_worker_main, worker, NULL, NULL,
+				CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
+		k_thread_name_set(&worker->thread, "init");
+	}
+
+	for (entry = first; entry < end; entry++) {
+		if (!init_entry_independent(entry)) {
+			init_workers_wait();
+			init_entry_run(entry);
+			continue;
+		}
+
+		while ((worker = init_worker_find(entry)) == NULL) {
+			(void)k_sem_take(&init_done, K_FOREVER);
+		}
+		k_sem_give(&worker->start);
+	}
+
+	init_workers_wait();
+	for (int i = 0; i < ARRAY_SIZE(init_workers); i++) {
+		k_sem_give(&init_workers[i].start);
+		(void)k_thread_join(&init_workers[i].thread, K_FOREVER);
+	}
+}
+#endif /* CONFIG_DEVICE_INIT_PARALLEL */
+
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+uint32_t z_timestamp_init_level[Z_SYS_INIT_LEVEL_COUNT];
+#endif
+
 /**
  * @brief Execute all the init entry initialization functions at a given level
  *
@@ -64,7 +266,9 @@ void z_device_state_init(void)
  * created by the INIT_ENTRY_DEFINE() macro using the specified level.
  * The linker script places the init entry objects in memory in the order
  * they need to be invoked, with symbols indicating where one level leaves
- * off and the next one begins.
+ * off and the next one begins.  With CONFIG_DEVICE_INIT_PARALLEL, the
+ * levels which run after the kernel has started may initialize devices
+ * which do not depend on each other concurrently.
  *
  * @param level init level to run.
  */
@@ -82,27 +286,28 @@ void z_sys_init_run_level(int32_t level)
 		__init_end,
 	};
 	const struct init_entry *entry;
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+	/* The system timer is not initialized before POST_KERNEL */
+	bool timed = level >= _SYS_INIT_LEVEL_POST_KERNEL;
+	uint32_t start = timed ? k_cycle_get_32() : 0U;
+#endif
 
-	for (entry = levels[level]; entry < levels[level+1]; entry++) {
-		const struct device *dev = entry->dev;
-		int rc = entry->init(dev);
-
-		if (dev != NULL) {
-			/* Mark device initialized.  If initialization
-			 * failed, record the error condition.
-			 */
-			if (rc != 0) {
-				if (rc < 0) {
-					rc = -rc;
-				}
-				if (rc > UINT8_MAX) {
-					rc = UINT8_MAX;
-				}
-				dev->state->init_res = rc;
-			}
-			dev->state->initialized = true;
+#ifdef CONFIG_DEVICE_INIT_PARALLEL
+	if (level >= _SYS_INIT_LEVEL_POST_KERNEL) {
+		init_run_parallel(levels[level], levels[level+1]);
+	} else
+#endif
+	{
+		for (entry = levels[level]; entry < levels[level+1]; entry++) {
+			init_entry_run(entry);
 		}
 	}
+
+#ifdef CONFIG_BOOT_TIME_MEASUREMENT
+	if (timed) {
+		z_timestamp_init_level[level] = k_cycle_get_32() - start;
+	}
+#endif
 }
 
 const struct device *z_impl_device_get_binding(const char *name)
@@ -130,6 +130,12 @@ extern int z_stack_adjust_initialized;
 #ifdef CONFIG_BOOT_TIME_MEASUREMENT
 extern uint32_t z_timestamp_main; /* timestamp when main task starts */
 extern uint32_t z_timestamp_idle; /* timestamp when CPU goes idle */
+
+/* Cycles spent running each init level, SMP included.  The PRE_KERNEL
+ * levels run before the system timer is initialized and stay at 0.
+ */
+#define Z_SYS_INIT_LEVEL_COUNT (_SYS_INIT_LEVEL_APPLICATION + 2)
+extern uint32_t z_timestamp_init_level[Z_SYS_INIT_LEVEL_COUNT];
 #endif
 
 extern struct k_thread z_main_thread;
@@ -165,6 +171,11 @@ void z_mem_domain_exit_thread(struct k_thread *thread);
  * not recommended.
  */
 extern struct k_spinlock z_mem_domain_lock;
+
+#ifdef CONFIG_USER_TIME_PAGE
+/* The kernel time page, mapped read-only into every memory domain */
+extern struct k_mem_partition z_time_page_partition;
+#endif
 #endif /* CONFIG_USERSPACE */
 
 #ifdef CONFIG_GDBSTUB
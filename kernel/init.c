@@ -32,6 +32,7 @@
 #include <tracing/tracing.h>
 #include <stdbool.h>
 #include <debug/gcov.h>
+#include <debug/boot_profiler.h>
 #include <kswap.h>
 #include <timing/timing.h>
 #include <logging/log.h>
@@ -146,6 +147,9 @@ static void bg_thread_main(void *unused1, void *unused2, void *unused3)
 #endif /* CONFIG_MMU */
 	z_sys_post_kernel = true;
 
+#ifdef CONFIG_DEVICE_INIT_PARALLEL_EARLY_SMP
+	z_smp_init();
+#endif
 	z_sys_init_run_level(_SYS_INIT_LEVEL_POST_KERNEL);
 #if CONFIG_STACK_POINTER_RANDOM
 	z_stack_adjust_initialized = 1;
@@ -170,13 +174,18 @@ static void bg_thread_main(void *unused1, void *unused2, void *unused3)
 #endif
 
 #ifdef CONFIG_SMP
+#ifndef CONFIG_DEVICE_INIT_PARALLEL_EARLY_SMP
 	z_smp_init();
+#endif
 	z_sys_init_run_level(_SYS_INIT_LEVEL_SMP);
 #endif
 
 #ifdef CONFIG_BOOT_TIME_MEASUREMENT
 	z_timestamp_main = k_cycle_get_32();
 #endif
+#ifdef CONFIG_BOOT_PROFILER
+	z_boot_prof_main();
+#endif
 
 	extern void main(void);
 
@@ -8,6 +8,7 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
+#include <debug/heap_profiler.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
@@ -35,6 +36,8 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
+	Z_HEAP_PROF_SITE_ENTER();
+
 	while (ret == NULL) {
 		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
 
@@ -48,6 +51,8 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 		key = k_spin_lock(&h->lock);
 	}
 
+	Z_HEAP_PROF_SITE_EXIT();
+
 	k_spin_unlock(&h->lock, key);
 	return ret;
 }
@@ -64,3 +69,12 @@ void k_heap_free(struct k_heap *h, void *mem)
 		k_spin_unlock(&h->lock, key);
 	}
 }
+
+void k_heap_runtime_stats_get(struct k_heap *h,
+			      struct sys_heap_runtime_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	sys_heap_runtime_stats_get(&h->heap, stats);
+	k_spin_unlock(&h->lock, key);
+}
@@ -20,6 +20,13 @@ static uint8_t max_partitions;
 
 struct k_mem_domain k_mem_domain_default;
 
+/* Partitions the kernel adds to every memory domain */
+#ifdef CONFIG_USER_TIME_PAGE
+#define RESERVED_PARTITIONS 1U
+#else
+#define RESERVED_PARTITIONS 0U
+#endif
+
 #if __ASSERT_ON
 static bool check_add_partition(struct k_mem_domain *domain,
 				struct k_mem_partition *part)
@@ -86,6 +93,18 @@ static bool check_add_partition(struct k_mem_domain *domain,
 }
 #endif
 
+static void init_partition_locked(struct k_mem_domain *domain,
+				  struct k_mem_partition *part)
+{
+	uint8_t p_idx = domain->num_partitions;
+
+	domain->partitions[p_idx] = *part;
+	domain->num_partitions++;
+#ifdef CONFIG_ARCH_MEM_DOMAIN_SYNCHRONOUS_API
+	arch_mem_domain_partition_add(domain, p_idx);
+#endif
+}
+
 void k_mem_domain_init(struct k_mem_domain *domain, uint8_t num_parts,
 		       struct k_mem_partition *parts[])
 {
@@ -94,9 +113,9 @@ void k_mem_domain_init(struct k_mem_domain *domain, uint8_t num_parts,
 	__ASSERT_NO_MSG(domain != NULL);
 	__ASSERT(num_parts == 0U || parts != NULL,
 		 "parts array is NULL and num_parts is nonzero");
-	__ASSERT(num_parts <= max_partitions,
+	__ASSERT(num_parts + RESERVED_PARTITIONS <= max_partitions,
 		 "num_parts of %d exceeds maximum allowable partitions (%d)",
-		 num_parts, max_partitions);
+		 num_parts, max_partitions - RESERVED_PARTITIONS);
 
 	key = k_spin_lock(&z_mem_domain_lock);
 
@@ -116,6 +135,9 @@ void k_mem_domain_init(struct k_mem_domain *domain, uint8_t num_parts,
 			domain, ret);
 		k_panic();
 	}
+#endif
+#ifdef CONFIG_USER_TIME_PAGE
+	init_partition_locked(domain, &z_time_page_partition);
 #endif
 	if (num_parts != 0U) {
 		uint32_t i;
@@ -125,11 +147,7 @@ void k_mem_domain_init(struct k_mem_domain *domain, uint8_t num_parts,
 				 "invalid partition index %d (%p)",
 				 i, parts[i]);
 
-			domain->partitions[i] = *parts[i];
-			domain->num_partitions++;
-#ifdef CONFIG_ARCH_MEM_DOMAIN_SYNCHRONOUS_API
-			arch_mem_domain_partition_add(domain, i);
-#endif
+			init_partition_locked(domain, parts[i]);
 		}
 	}
 
@@ -14,8 +14,7 @@
 #include <ksched.h>
 #include <init.h>
 #include <sys/check.h>
-
-static struct k_spinlock lock;
+#include <string.h>
 
 #ifdef CONFIG_OBJECT_TRACING
 struct k_mem_slab *_trace_list_k_mem_slab;
@@ -93,6 +92,14 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->max_used = 0U;
 #endif
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	atomic_clear(&slab->waiters);
+	slab->alloc_misses = 0U;
+	slab->free_misses = 0U;
+	slab->max_out = 0U;
+	(void)memset(slab->cache, 0, sizeof(slab->cache));
+#endif
+
 	rc = create_free_list(slab);
 	if (rc < 0) {
 		goto out;
@@ -106,21 +113,244 @@ out:
 	return rc;
 }
 
+/* Takes a block off the shared free list, which must not be empty.
+ * slab->lock must be held.
+ */
+static void *shared_take(struct k_mem_slab *slab)
+{
+	void *block = slab->free_list;
+
+	slab->free_list = *(char **)(slab->free_list);
+	slab->num_used++;
+
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	slab->max_used = MAX(slab->num_used, slab->max_used);
+#endif
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	slab->max_out = MAX(slab->num_used, slab->max_out);
+#endif
+
+	return block;
+}
+
+/* Returns a block to the shared free list, or hands it directly to a
+ * thread pending on the slab, in which case true is returned and the
+ * caller should reschedule.  slab->lock must be held.
+ */
+static bool shared_give(struct k_mem_slab *slab, void *block)
+{
+	if (slab->free_list == NULL) {
+		struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
+
+		if (pending_thread != NULL) {
+			z_thread_return_value_set_with_data(pending_thread, 0, block);
+			z_ready_thread(pending_thread);
+			return true;
+		}
+	}
+
+	*(char **)block = slab->free_list;
+	slab->free_list = block;
+	slab->num_used--;
+
+	return false;
+}
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+/*
+ * Each CPU has a "loaded" and a "previous" magazine of free blocks
+ * per slab.  Allocations pop from the loaded magazine and frees push
+ * onto it; when it runs empty (or full) it is swapped with the
+ * previous one if that can serve the request.  Only when both are
+ * empty (or full) is a whole magazine worth of blocks exchanged with
+ * the shared free list under slab->lock.  Lock order is cache lock,
+ * then slab->lock.
+ */
+
+static void magazine_swap(struct z_mem_slab_cache *c)
+{
+	struct z_mem_slab_magazine tmp = c->loaded;
+
+	c->loaded = c->previous;
+	c->previous = tmp;
+}
+
+/* slab->lock must be held */
+static bool magazine_flush(struct k_mem_slab *slab,
+			   struct z_mem_slab_magazine *m)
+{
+	bool woke = false;
+
+	while (m->count != 0U) {
+		woke |= shared_give(slab, m->rounds[--m->count]);
+	}
+
+	return woke;
+}
+
+static bool cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	unsigned int irq = arch_irq_lock();
+	struct z_mem_slab_cache *c = &slab->cache[_current_cpu->id];
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+	bool ret = true;
+
+	if (c->loaded.count == 0U && c->previous.count != 0U) {
+		magazine_swap(c);
+	}
+
+	if (c->loaded.count != 0U) {
+		c->alloc_hits++;
+	} else {
+		/* Both empty: load a full magazine from the shared list */
+		k_spinlock_key_t skey = k_spin_lock(&slab->lock);
+
+		slab->alloc_misses++;
+		while (c->loaded.count < CONFIG_MEM_SLAB_MAGAZINE_SIZE &&
+		       slab->free_list != NULL) {
+			c->loaded.rounds[c->loaded.count++] = shared_take(slab);
+		}
+
+		k_spin_unlock(&slab->lock, skey);
+
+		if (c->loaded.count != 0U) {
+			c->exchanges++;
+		} else {
+			ret = false;
+		}
+	}
+
+	if (ret) {
+		*mem = c->loaded.rounds[--c->loaded.count];
+	}
+
+	k_spin_unlock(&c->lock, key);
+	arch_irq_unlock(irq);
+
+	return ret;
+}
+
+/* Returns true if a pending thread was readied */
+static bool cache_free(struct k_mem_slab *slab, void *block)
+{
+	unsigned int irq = arch_irq_lock();
+	struct z_mem_slab_cache *c = &slab->cache[_current_cpu->id];
+	k_spinlock_key_t key = k_spin_lock(&c->lock);
+	bool woke = false;
+
+	if (c->loaded.count == CONFIG_MEM_SLAB_MAGAZINE_SIZE &&
+	    c->previous.count == 0U) {
+		magazine_swap(c);
+	}
+
+	if (c->loaded.count < CONFIG_MEM_SLAB_MAGAZINE_SIZE) {
+		c->free_hits++;
+	} else {
+		/* Both full: return one to the shared list */
+		k_spinlock_key_t skey = k_spin_lock(&slab->lock);
+
+		slab->free_misses++;
+		woke = magazine_flush(slab, &c->previous);
+		k_spin_unlock(&slab->lock, skey);
+
+		c->exchanges++;
+		magazine_swap(c);
+	}
+
+	c->loaded.rounds[c->loaded.count++] = block;
+
+	k_spin_unlock(&c->lock, key);
+	arch_irq_unlock(irq);
+
+	return woke;
+}
+
+/* Moves the blocks cached by all CPUs back to the shared free list
+ * (handing them to pending threads first).  Returns true if a
+ * pending thread was readied.
+ */
+static bool cache_reclaim(struct k_mem_slab *slab)
+{
+	bool woke = false;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_mem_slab_cache *c = &slab->cache[i];
+		k_spinlock_key_t key = k_spin_lock(&c->lock);
+		k_spinlock_key_t skey = k_spin_lock(&slab->lock);
+
+		woke |= magazine_flush(slab, &c->loaded);
+		woke |= magazine_flush(slab, &c->previous);
+
+		k_spin_unlock(&slab->lock, skey);
+		k_spin_unlock(&c->lock, key);
+	}
+
+	return woke;
+}
+
+uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
+{
+	uint32_t cached = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->cache[i].loaded.count +
+			  slab->cache[i].previous.count;
+	}
+
+	return slab->num_used - cached;
+}
+
+void k_mem_slab_cache_stats_get(struct k_mem_slab *slab,
+				struct k_mem_slab_cache_stats *stats)
+{
+	(void)memset(stats, 0, sizeof(*stats));
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_mem_slab_cache *c = &slab->cache[i];
+		k_spinlock_key_t key = k_spin_lock(&c->lock);
+
+		stats->alloc_hits += c->alloc_hits;
+		stats->free_hits += c->free_hits;
+		stats->exchanges += c->exchanges;
+		stats->cached += c->loaded.count + c->previous.count;
+
+		k_spin_unlock(&c->lock, key);
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+
+	stats->alloc_misses = slab->alloc_misses;
+	stats->free_misses = slab->free_misses;
+	stats->max_out = slab->max_out;
+
+	k_spin_unlock(&slab->lock, key);
+}
+#endif /* CONFIG_MEM_SLAB_MAGAZINES */
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
 	int result;
 
-	if (slab->free_list != NULL) {
-		/* take a free block */
-		*mem = slab->free_list;
-		slab->free_list = *(char **)(slab->free_list);
-		slab->num_used++;
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	if (cache_alloc(slab, mem)) {
+		return 0;
+	}
 
-#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
-		slab->max_used = MAX(slab->num_used, slab->max_used);
+	/* This CPU's cache and the shared list are empty, but other
+	 * CPUs may still cache free blocks.  Announce ourselves before
+	 * reclaiming them: a concurrent free is then either seen by the
+	 * reclaim or flushed by its caller (see k_mem_slab_free()).
+	 */
+	atomic_inc(&slab->waiters);
+	(void)cache_reclaim(slab);
 #endif
 
+	key = k_spin_lock(&slab->lock);
+
+	if (slab->free_list != NULL) {
+		/* take a free block */
+		*mem = shared_take(slab);
 		result = 0;
 	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
 		/* don't wait for a free block to become available */
@@ -128,34 +358,48 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 		result = -ENOMEM;
 	} else {
 		/* wait for a free block or timeout */
-		result = z_pend_curr(&lock, key, &slab->wait_q, timeout);
+		result = z_pend_curr(&slab->lock, key, &slab->wait_q, timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+		atomic_dec(&slab->waiters);
+#endif
 		return result;
 	}
 
-	k_spin_unlock(&lock, key);
+	k_spin_unlock(&slab->lock, key);
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	atomic_dec(&slab->waiters);
+#endif
 
 	return result;
 }
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	bool woke = cache_free(slab, *mem);
 
-	if (slab->free_list == NULL) {
-		struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
+	/* Someone is about to wait for a block: don't strand this one
+	 * in a cache
+	 */
+	if (atomic_get(&slab->waiters) != 0) {
+		woke |= cache_reclaim(slab);
+	}
 
-		if (pending_thread != NULL) {
-			z_thread_return_value_set_with_data(pending_thread, 0, *mem);
-			z_ready_thread(pending_thread);
-			z_reschedule(&lock, key);
-			return;
-		}
+	if (woke) {
+		z_reschedule_unlocked();
 	}
-	**(char ***) mem = slab->free_list;
-	slab->free_list = *(char **) mem;
-	slab->num_used--;
-	k_spin_unlock(&lock, key);
+#else
+	k_spinlock_key_t key = k_spin_lock(&slab->lock);
+
+	if (shared_give(slab, *mem)) {
+		z_reschedule(&slab->lock, key);
+		return;
+	}
+
+	k_spin_unlock(&slab->lock, key);
+#endif
 }
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <sys/math_extras.h>
 #include <sys/util.h>
+#include <debug/heap_profiler.h>
 
 static void *z_heap_aligned_alloc(struct k_heap *heap, size_t align, size_t size)
 {
@@ -56,8 +57,105 @@ void k_free(void *ptr)
 K_HEAP_DEFINE(_system_heap, CONFIG_HEAP_MEM_POOL_SIZE);
 #define _SYSTEM_HEAP (&_system_heap)
 
-void *k_aligned_alloc(size_t align, size_t size)
+#if (CONFIG_HEAP_MEM_POOL_REGIONS > 0)
+/* Additional memory regions for k_malloc(), region 0 being the heap
+ * memory pool.  Each region is a k_heap of its own, so k_free() finds
+ * its way back through the heap reference stored in front of every
+ * block just like for the pool.  Regions are only ever appended, and
+ * num_regions is only bumped once a region is fully set up, so the
+ * allocation path can scan them without taking regions_lock.
+ */
+static struct k_heap region_heaps[CONFIG_HEAP_MEM_POOL_REGIONS];
+
+static struct z_malloc_region {
+	struct k_heap *heap;
+	uint32_t attr;
+	atomic_t allocs;
+	atomic_t fallback_allocs;
+} regions[CONFIG_HEAP_MEM_POOL_REGIONS + 1] = {
+	[0] = {
+		.heap = _SYSTEM_HEAP,
+		.attr = SYS_MHEAP_ATTR_CACHEABLE |
+			(IS_ENABLED(CONFIG_HEAP_MEM_POOL_DMA) ?
+			 SYS_MHEAP_ATTR_DMA : 0),
+	},
+};
+
+static atomic_t num_regions = ATOMIC_INIT(1);
+static struct k_spinlock regions_lock;
+
+int k_malloc_region_add(void *mem, size_t bytes, uint32_t attr)
+{
+	k_spinlock_key_t key = k_spin_lock(&regions_lock);
+	int n = atomic_get(&num_regions);
+
+	if (n > CONFIG_HEAP_MEM_POOL_REGIONS) {
+		k_spin_unlock(&regions_lock, key);
+		return -ENOMEM;
+	}
+
+	k_heap_init(&region_heaps[n - 1], mem, bytes);
+	regions[n].heap = &region_heaps[n - 1];
+	regions[n].attr = attr;
+	(void)atomic_inc(&num_regions);
+
+	k_spin_unlock(&regions_lock, key);
+	return n;
+}
+
+int k_malloc_region_stats_get(int region,
+			      struct sys_multi_heap_region_stats *stats)
 {
+	struct z_malloc_region *r;
+
+	if (region < 0 || region >= atomic_get(&num_regions)) {
+		return -EINVAL;
+	}
+
+	r = &regions[region];
+	stats->attr = r->attr;
+	stats->allocs = atomic_get(&r->allocs);
+	stats->fallback_allocs = atomic_get(&r->fallback_allocs);
+	k_heap_runtime_stats_get(r->heap, &stats->heap);
+
+	return 0;
+}
+
+/* Same policy as sys_multi_heap_aligned_alloc() */
+static void *regions_aligned_alloc(uint32_t attr, size_t align, size_t size)
+{
+	int n = atomic_get(&num_regions);
+
+	for (int pass = 0; pass < Z_MHEAP_PASSES; pass++) {
+		for (int i = 0; i < n; i++) {
+			struct z_malloc_region *r = &regions[i];
+			void *mem;
+
+			if (!z_multi_heap_attr_match(r->attr, attr, pass) ||
+			    (pass != 0 &&
+			     z_multi_heap_attr_match(r->attr, attr, 0))) {
+				continue;
+			}
+
+			mem = z_heap_aligned_alloc(r->heap, align, size);
+			if (mem != NULL) {
+				(void)atomic_inc(&r->allocs);
+				if (pass != 0) {
+					(void)atomic_inc(&r->fallback_allocs);
+				}
+				return mem;
+			}
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_HEAP_MEM_POOL_REGIONS > 0 */
+
+void *k_aligned_alloc_attr(uint32_t attr, size_t align, size_t size)
+{
+	void *ret;
+
 	__ASSERT(align / sizeof(void *) >= 1
 		&& (align % sizeof(void *)) == 0,
 		"align must be a multiple of sizeof(void *)");
@@ -65,7 +163,27 @@ void *k_aligned_alloc(size_t align, size_t size)
 	__ASSERT((align & (align - 1)) == 0,
 		"align must be a power of 2");
 
-	return z_heap_aligned_alloc(_SYSTEM_HEAP, align, size);
+	Z_HEAP_PROF_SITE_ENTER();
+#if (CONFIG_HEAP_MEM_POOL_REGIONS > 0)
+	ret = regions_aligned_alloc(attr, align, size);
+#else
+	ARG_UNUSED(attr);
+	ret = z_heap_aligned_alloc(_SYSTEM_HEAP, align, size);
+#endif
+	Z_HEAP_PROF_SITE_EXIT();
+
+	return ret;
+}
+
+void *k_aligned_alloc(size_t align, size_t size)
+{
+	void *ret;
+
+	Z_HEAP_PROF_SITE_ENTER();
+	ret = k_aligned_alloc_attr(SYS_MHEAP_ATTR_DEFAULT, align, size);
+	Z_HEAP_PROF_SITE_EXIT();
+
+	return ret;
 }
 
 void *k_calloc(size_t nmemb, size_t size)
@@ -77,7 +195,10 @@ void *k_calloc(size_t nmemb, size_t size)
 		return NULL;
 	}
 
+	Z_HEAP_PROF_SITE_ENTER();
 	ret = k_malloc(bounds);
+	Z_HEAP_PROF_SITE_EXIT();
+
 	if (ret != NULL) {
 		(void)memset(ret, 0, bounds);
 	}
@@ -88,6 +209,11 @@ void k_thread_system_pool_assign(struct k_thread *thread)
 {
 	thread->resource_pool = _SYSTEM_HEAP;
 }
+
+void k_malloc_runtime_stats_get(struct sys_heap_runtime_stats *stats)
+{
+	k_heap_runtime_stats_get(_SYSTEM_HEAP, stats);
+}
 #else
 #define _SYSTEM_HEAP	NULL
 #endif
@@ -104,7 +230,9 @@ void *z_thread_aligned_alloc(size_t align, size_t size)
 	}
 
 	if (heap != NULL) {
+		Z_HEAP_PROF_SITE_ENTER();
 		ret = z_heap_aligned_alloc(heap, align, size);
+		Z_HEAP_PROF_SITE_EXIT();
 	} else {
 		ret = NULL;
 	}
@@ -56,8 +56,10 @@ void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 	msgq->read_ptr = buffer;
 	msgq->write_ptr = buffer;
 	msgq->used_msgs = 0;
+	msgq->claimed_msgs = 0;
 	msgq->flags = 0;
 	z_waitq_init(&msgq->wait_q);
+	z_waitq_init(&msgq->claim_wait_q);
 	msgq->lock = (struct k_spinlock) {};
 
 	SYS_TRACING_OBJ_INIT(k_msgq, msgq);
@@ -101,7 +103,8 @@ int z_vrfy_k_msgq_alloc_init(struct k_msgq *msgq, size_t msg_size,
 
 int k_msgq_cleanup(struct k_msgq *msgq)
 {
-	CHECKIF(z_waitq_head(&msgq->wait_q) != NULL) {
+	CHECKIF((z_waitq_head(&msgq->wait_q) != NULL) ||
+		(z_waitq_head(&msgq->claim_wait_q) != NULL)) {
 		return -EBUSY;
 	}
 
@@ -113,6 +116,84 @@ int k_msgq_cleanup(struct k_msgq *msgq)
 }
 
 
+/*
+ * Put and get claims.  Threads waiting in k_msgq_put()/k_msgq_get()
+ * pend on wait_q, threads waiting for a claim on claim_wait_q.  As
+ * with wait_q, the queue state tells which kind of waiter is there:
+ * put claimers only wait while the queue is full, get claimers only
+ * while it is empty, and there is at most one of each.  Copying
+ * waiters are served first.
+ */
+
+static inline void msgq_write_advance(struct k_msgq *msgq)
+{
+	msgq->write_ptr += msgq->msg_size;
+	if (msgq->write_ptr == msgq->buffer_end) {
+		msgq->write_ptr = msgq->buffer_start;
+	}
+	msgq->used_msgs++;
+}
+
+static inline void msgq_read_advance(struct k_msgq *msgq)
+{
+	msgq->read_ptr += msgq->msg_size;
+	if (msgq->read_ptr == msgq->buffer_end) {
+		msgq->read_ptr = msgq->buffer_start;
+	}
+	msgq->used_msgs--;
+}
+
+static inline void msgq_wake(struct k_thread *thread)
+{
+	arch_thread_return_value_set(thread, 0);
+	z_ready_thread(thread);
+}
+
+/* Hands a slot that just became free to the first thread waiting to
+ * put a message or to claim a slot.  Returns true if a thread was woken.
+ */
+static bool msgq_free_slot_handoff(struct k_msgq *msgq)
+{
+	struct k_thread *pending_thread;
+
+	pending_thread = z_unpend_first_thread(&msgq->wait_q);
+	if (pending_thread != NULL) {
+		/* add thread's message to queue */
+		(void)memcpy(msgq->write_ptr, pending_thread->base.swap_data,
+		       msgq->msg_size);
+		msgq_write_advance(msgq);
+		msgq_wake(pending_thread);
+		return true;
+	}
+
+	pending_thread = z_unpend_first_thread(&msgq->claim_wait_q);
+	if (pending_thread != NULL) {
+		msgq->flags |= K_MSGQ_FLAG_PUT_CLAIM;
+		msgq_wake(pending_thread);
+		return true;
+	}
+
+	return false;
+}
+
+/* Hands the message just added to an empty queue to a thread waiting
+ * to claim it.  Returns true if a thread was woken.
+ */
+static bool msgq_new_msg_handoff(struct k_msgq *msgq)
+{
+	struct k_thread *pending_thread;
+
+	pending_thread = z_unpend_first_thread(&msgq->claim_wait_q);
+	if (pending_thread != NULL) {
+		/* reserved until the claimer runs */
+		msgq->claimed_msgs = 1U;
+		msgq_wake(pending_thread);
+		return true;
+	}
+
+	return false;
+}
+
 int z_impl_k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout)
 {
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
@@ -123,7 +204,10 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs < msgq->max_msgs) {
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U) {
+		/* the next slot is being written in place */
+		result = -EBUSY;
+	} else if (msgq->used_msgs < msgq->max_msgs) {
 		/* message queue isn't full */
 		pending_thread = z_unpend_first_thread(&msgq->wait_q);
 		if (pending_thread != NULL) {
@@ -131,18 +215,17 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout
 			(void)memcpy(pending_thread->base.swap_data, data,
 			       msgq->msg_size);
 			/* wake up waiting thread */
-			arch_thread_return_value_set(pending_thread, 0);
-			z_ready_thread(pending_thread);
+			msgq_wake(pending_thread);
 			z_reschedule(&msgq->lock, key);
 			return 0;
 		} else {
 			/* put message in queue */
 			(void)memcpy(msgq->write_ptr, data, msgq->msg_size);
-			msgq->write_ptr += msgq->msg_size;
-			if (msgq->write_ptr == msgq->buffer_end) {
-				msgq->write_ptr = msgq->buffer_start;
+			msgq_write_advance(msgq);
+			if (msgq_new_msg_handoff(msgq)) {
+				z_reschedule(&msgq->lock, key);
+				return 0;
 			}
-			msgq->used_msgs++;
 		}
 		result = 0;
 	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
@@ -194,35 +277,20 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout)
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
 	k_spinlock_key_t key;
-	struct k_thread *pending_thread;
 	int result;
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs > 0U) {
+	if (msgq->claimed_msgs != 0U) {
+		/* the head message is being read in place */
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0U) {
 		/* take first available message from queue */
 		(void)memcpy(data, msgq->read_ptr, msgq->msg_size);
-		msgq->read_ptr += msgq->msg_size;
-		if (msgq->read_ptr == msgq->buffer_end) {
-			msgq->read_ptr = msgq->buffer_start;
-		}
-		msgq->used_msgs--;
+		msgq_read_advance(msgq);
 
 		/* handle first thread waiting to write (if any) */
-		pending_thread = z_unpend_first_thread(&msgq->wait_q);
-		if (pending_thread != NULL) {
-			/* add thread's message to queue */
-			(void)memcpy(msgq->write_ptr, pending_thread->base.swap_data,
-			       msgq->msg_size);
-			msgq->write_ptr += msgq->msg_size;
-			if (msgq->write_ptr == msgq->buffer_end) {
-				msgq->write_ptr = msgq->buffer_start;
-			}
-			msgq->used_msgs++;
-
-			/* wake up waiting thread */
-			arch_thread_return_value_set(pending_thread, 0);
-			z_ready_thread(pending_thread);
+		if (msgq_free_slot_handoff(msgq)) {
 			z_reschedule(&msgq->lock, key);
 			return 0;
 		}
@@ -253,6 +321,243 @@ static inline int z_vrfy_k_msgq_get(struct k_msgq *msgq, void *data,
 #include <syscalls/k_msgq_get_mrsh.c>
 #endif
 
+int z_impl_k_msgq_get_batch(struct k_msgq *msgq, void *data,
+			    uint32_t max_msgs, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	char *dest = data;
+	k_spinlock_key_t key;
+	bool woken = false;
+	int result;
+	uint32_t n = 0U;
+
+	CHECKIF(max_msgs == 0U) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->claimed_msgs != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	if (msgq->used_msgs == 0U) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&msgq->lock, key);
+			return -ENOMSG;
+		}
+
+		/* wait for the first message like k_msgq_get() */
+		_current->base.swap_data = dest;
+		result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+		if (result != 0) {
+			return result;
+		}
+
+		/* and take whatever arrived meanwhile */
+		n = 1U;
+		key = k_spin_lock(&msgq->lock);
+	}
+
+	while ((n < max_msgs) && (msgq->used_msgs > 0U) &&
+	       (msgq->claimed_msgs == 0U)) {
+		(void)memcpy(dest + n * msgq->msg_size, msgq->read_ptr,
+			     msgq->msg_size);
+		msgq_read_advance(msgq);
+		n++;
+
+		woken |= msgq_free_slot_handoff(msgq);
+	}
+
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return n;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_get_batch(struct k_msgq *msgq, void *data,
+					  uint32_t max_msgs,
+					  k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(msgq, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(data, max_msgs, msgq->msg_size));
+
+	return z_impl_k_msgq_get_batch(msgq, data, max_msgs, timeout);
+}
+#include <syscalls/k_msgq_get_batch_mrsh.c>
+#endif
+
+int k_msgq_put_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	k_spinlock_key_t key;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) != 0U) {
+		result = -EBUSY;
+	} else if (msgq->used_msgs < msgq->max_msgs) {
+		msgq->flags |= K_MSGQ_FLAG_PUT_CLAIM;
+		result = 0;
+	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		result = -ENOMSG;
+	} else if (z_waitq_head(&msgq->claim_wait_q) != NULL) {
+		/* queue is full, so that's another put claimer */
+		result = -EBUSY;
+	} else {
+		/* the slot is claimed for us before we are woken up */
+		result = z_pend_curr(&msgq->lock, key, &msgq->claim_wait_q,
+				     timeout);
+		if (result != 0) {
+			return result;
+		}
+		key = k_spin_lock(&msgq->lock);
+	}
+
+	if (result == 0) {
+		*slot = msgq->write_ptr;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+int k_msgq_put_finish(struct k_msgq *msgq, bool commit)
+{
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIM) == 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EINVAL;
+	}
+
+	msgq->flags &= ~K_MSGQ_FLAG_PUT_CLAIM;
+
+	if (!commit) {
+		k_spin_unlock(&msgq->lock, key);
+		return 0;
+	}
+
+	/* only readers can be waiting while a put claim is held */
+	pending_thread = z_unpend_first_thread(&msgq->wait_q);
+	if (pending_thread != NULL) {
+		/* give message to waiting thread */
+		(void)memcpy(pending_thread->base.swap_data, msgq->write_ptr,
+			     msgq->msg_size);
+		msgq_wake(pending_thread);
+		z_reschedule(&msgq->lock, key);
+		return 0;
+	}
+
+	msgq_write_advance(msgq);
+	if (msgq_new_msg_handoff(msgq)) {
+		z_reschedule(&msgq->lock, key);
+		return 0;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return 0;
+}
+
+/* Number of messages from the read pointer up to the end of the buffer */
+static uint32_t msgq_contiguous_msgs(struct k_msgq *msgq, uint32_t max_msgs)
+{
+	uint32_t n = (msgq->buffer_end - msgq->read_ptr) / msgq->msg_size;
+
+	return MIN(MIN(n, msgq->used_msgs), max_msgs);
+}
+
+int k_msgq_get_claim(struct k_msgq *msgq, void **msgs, uint32_t max_msgs,
+		     k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	k_spinlock_key_t key;
+	int result;
+
+	CHECKIF(max_msgs == 0U) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (msgq->claimed_msgs != 0U) {
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0U) {
+		result = 0;
+	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		result = -ENOMSG;
+	} else if (z_waitq_head(&msgq->claim_wait_q) != NULL) {
+		/* queue is empty, so that's another get claimer */
+		result = -EBUSY;
+	} else {
+		/* the message is reserved for us before we are woken up */
+		result = z_pend_curr(&msgq->lock, key, &msgq->claim_wait_q,
+				     timeout);
+		if (result != 0) {
+			return result;
+		}
+		key = k_spin_lock(&msgq->lock);
+
+		if (msgq->used_msgs == 0U) {
+			/* purged in between */
+			msgq->claimed_msgs = 0U;
+			result = -ENOMSG;
+		}
+	}
+
+	if (result == 0) {
+		result = msgq_contiguous_msgs(msgq, max_msgs);
+		msgq->claimed_msgs = result;
+		*msgs = msgq->read_ptr;
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+int k_msgq_get_finish(struct k_msgq *msgq, uint32_t num_msgs)
+{
+	k_spinlock_key_t key;
+	bool woken = false;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if (num_msgs > msgq->claimed_msgs) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EINVAL;
+	}
+
+	msgq->claimed_msgs = 0U;
+
+	for (uint32_t i = 0U; i < num_msgs; i++) {
+		msgq_read_advance(msgq);
+		woken |= msgq_free_slot_handoff(msgq);
+	}
+
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return 0;
+}
+
 int z_impl_k_msgq_peek(struct k_msgq *msgq, void *data)
 {
 	k_spinlock_key_t key;
@@ -298,6 +603,17 @@ void z_impl_k_msgq_purge(struct k_msgq *msgq)
 		z_ready_thread(pending_thread);
 	}
 
+	/* and a put claimer, which can only be waiting on a full queue */
+	if (msgq->used_msgs != 0U) {
+		pending_thread = z_unpend_first_thread(&msgq->claim_wait_q);
+		if (pending_thread != NULL) {
+			arch_thread_return_value_set(pending_thread, -ENOMSG);
+			z_ready_thread(pending_thread);
+		}
+	}
+
+	/* messages held by a get claim are discarded too */
+	msgq->claimed_msgs = 0;
 	msgq->used_msgs = 0;
 	msgq->read_ptr = msgq->write_ptr;
 
@@ -103,6 +103,8 @@ void k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 	pipe->bytes_used = 0;
 	pipe->read_index = 0;
 	pipe->write_index = 0;
+	pipe->put_claimed = 0;
+	pipe->get_claimed = 0;
 	pipe->lock = (struct k_spinlock){};
 	z_waitq_init(&pipe->wait_q.writers);
 	z_waitq_init(&pipe->wait_q.readers);
@@ -415,6 +417,12 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	if (pipe->put_claimed != 0U) {
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_written = 0;
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -541,6 +549,12 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	if (pipe->get_claimed != 0U) {
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_read = 0;
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -792,3 +806,257 @@ size_t z_vrfy_k_pipe_write_avail(struct k_pipe *pipe)
 }
 #include <syscalls/k_pipe_write_avail_mrsh.c>
 #endif
+
+/*
+ * Put and get claims.  A claimer waiting for space or data pends on the
+ * writers or readers wait_q with an empty request.  The transfer code
+ * above considers such a request satisfied right away and readies the
+ * claimer, which then looks at the buffer again.
+ */
+
+/**
+ * @brief Pend the current thread until the pipe changes
+ *
+ * Returns with the pipe locked again, or -EAGAIN without pending if
+ * @a end has been reached.
+ */
+static int pipe_claim_pend(struct k_pipe *pipe, k_spinlock_key_t *key,
+			   _wait_q_t *wait_q, k_timeout_t timeout, int64_t end)
+{
+	struct k_pipe_desc pipe_desc;
+	int64_t now;
+
+	pipe_desc.buffer        = NULL;
+	pipe_desc.bytes_to_xfer = 0;
+	_current->base.swap_data = &pipe_desc;
+
+	if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		(void)z_pend_curr(&pipe->lock, *key, wait_q, K_FOREVER);
+	} else {
+		now = sys_clock_tick_get();
+		if ((end - now) <= 0) {
+			return -EAGAIN;
+		}
+		(void)z_pend_curr(&pipe->lock, *key, wait_q,
+				  K_TICKS(end - now));
+	}
+
+	*key = k_spin_lock(&pipe->lock);
+	return 0;
+}
+
+/**
+ * @brief Hand data in the pipe's circular buffer to waiting readers
+ *
+ * @return true if a thread was readied
+ */
+static bool pipe_feed_readers(struct k_pipe *pipe)
+{
+	struct k_thread    *thread;
+	struct k_pipe_desc *desc;
+	size_t              bytes_copied;
+	bool                readied = false;
+
+	while ((pipe->bytes_used != 0U) &&
+	       ((thread = z_waitq_head(&pipe->wait_q.readers)) != NULL)) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0U) {
+			/* out of data */
+			break;
+		}
+
+		z_unpend_thread(thread);
+		z_ready_thread(thread);
+		readied = true;
+	}
+
+	return readied;
+}
+
+/**
+ * @brief Move data of waiting writers into the pipe's circular buffer
+ *
+ * @return true if a thread was readied
+ */
+static bool pipe_drain_writers(struct k_pipe *pipe)
+{
+	struct k_thread    *thread;
+	struct k_pipe_desc *desc;
+	size_t              bytes_copied;
+	bool                readied = false;
+
+	while ((pipe->bytes_used != pipe->size) &&
+	       ((thread = z_waitq_head(&pipe->wait_q.writers)) != NULL)) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0U) {
+			/* out of space */
+			break;
+		}
+
+		z_unpend_thread(thread);
+		pipe_thread_ready(thread);
+		readied = true;
+	}
+
+	return readied;
+}
+
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t size,
+		     k_timeout_t timeout)
+{
+	int64_t end = sys_clock_timeout_end_calc(timeout);
+	k_spinlock_key_t key;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	CHECKIF((pipe->buffer == NULL) || (pipe->size == 0U) || (size == 0U) ||
+		(data == NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	while (true) {
+		if (pipe->put_claimed != 0U) {
+			ret = -EBUSY;
+			break;
+		}
+
+		if (pipe->bytes_used != pipe->size) {
+			pipe->put_claimed = MIN(size,
+					MIN(pipe->size - pipe->bytes_used,
+					    pipe->size - pipe->write_index));
+			*data = pipe->buffer + pipe->write_index;
+			ret = (int)pipe->put_claimed;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			ret = -EIO;
+			break;
+		}
+
+		ret = pipe_claim_pend(pipe, &key, &pipe->wait_q.writers,
+				      timeout, end);
+		if (ret != 0) {
+			break;
+		}
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return ret;
+}
+
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (size > pipe->put_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->bytes_used += size;
+	pipe->write_index += size;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+	pipe->put_claimed = 0;
+
+	/* readers only wait on an empty pipe, so none wait on a get claim */
+	if (pipe_feed_readers(pipe)) {
+		z_reschedule(&pipe->lock, key);
+	} else {
+		k_spin_unlock(&pipe->lock, key);
+	}
+
+	return 0;
+}
+
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t size,
+		     k_timeout_t timeout)
+{
+	int64_t end = sys_clock_timeout_end_calc(timeout);
+	k_spinlock_key_t key;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	CHECKIF((pipe->buffer == NULL) || (pipe->size == 0U) || (size == 0U) ||
+		(data == NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	while (true) {
+		if (pipe->get_claimed != 0U) {
+			ret = -EBUSY;
+			break;
+		}
+
+		if (pipe->bytes_used != 0U) {
+			pipe->get_claimed = MIN(size,
+					MIN(pipe->bytes_used,
+					    pipe->size - pipe->read_index));
+			*data = pipe->buffer + pipe->read_index;
+			ret = (int)pipe->get_claimed;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			ret = -EIO;
+			break;
+		}
+
+		ret = pipe_claim_pend(pipe, &key, &pipe->wait_q.readers,
+				      timeout, end);
+		if (ret != 0) {
+			break;
+		}
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return ret;
+}
+
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (size > pipe->get_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->bytes_used -= size;
+	pipe->read_index += size;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+	pipe->get_claimed = 0;
+
+	/* writers only wait on a full pipe, so none wait on a put claim */
+	if (pipe_drain_writers(pipe)) {
+		z_reschedule(&pipe->lock, key);
+	} else {
+		k_spin_unlock(&pipe->lock, key);
+	}
+
+	return 0;
+}
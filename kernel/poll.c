@@ -34,10 +34,11 @@
  */
 static struct k_spinlock lock;
 
-enum POLL_MODE { MODE_NONE, MODE_POLL, MODE_TRIGGERED };
+enum POLL_MODE { MODE_NONE, MODE_POLL, MODE_TRIGGERED, MODE_SET };
 
 static int signal_poller(struct k_poll_event *event, uint32_t state);
 static int signal_triggered_work(struct k_poll_event *event, uint32_t status);
+static void signal_set_event(struct k_poll_event *event, uint32_t state);
 
 void k_poll_event_init(struct k_poll_event *event, uint32_t type,
 		       int mode, void *obj)
@@ -93,22 +94,39 @@ static struct k_thread *poller_thread(struct z_poller *p)
 	return p ? CONTAINER_OF(p, struct k_thread, poller) : NULL;
 }
 
+/* Poll sets have no thread of their own */
+static inline bool is_set_poller(struct z_poller *p)
+{
+	return p != NULL && p->mode == MODE_SET;
+}
+
+/* Threads are sorted by priority, poll sets queue behind all threads so
+ * they never take an object away from a thread that waits for it.
+ */
+static inline bool poller_before(struct z_poller *a, struct z_poller *b)
+{
+	if (is_set_poller(a)) {
+		return false;
+	}
+	if (is_set_poller(b)) {
+		return true;
+	}
+	return z_sched_prio_cmp(poller_thread(a), poller_thread(b)) > 0;
+}
+
 static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 			     struct z_poller *poller)
 {
 	struct k_poll_event *pending;
 
 	pending = (struct k_poll_event *)sys_dlist_peek_tail(events);
-	if ((pending == NULL) ||
-		(z_sched_prio_cmp(poller_thread(pending->poller),
-							   poller_thread(poller)) > 0)) {
+	if ((pending == NULL) || !poller_before(poller, pending->poller)) {
 		sys_dlist_append(events, &event->_node);
 		return;
 	}
 
 	SYS_DLIST_FOR_EACH_CONTAINER(events, pending, _node) {
-		if (z_sched_prio_cmp(poller_thread(poller),
-					poller_thread(pending->poller)) > 0) {
+		if (poller_before(poller, pending->poller)) {
 			sys_dlist_insert(&pending->_node, &event->_node);
 			return;
 		}
@@ -387,6 +405,11 @@ static int signal_poll_event(struct k_poll_event *event, uint32_t state)
 	struct z_poller *poller = event->poller;
 	int retcode = 0;
 
+	if (is_set_poller(poller)) {
+		signal_set_event(event, state);
+		return 0;
+	}
+
 	if (poller != NULL) {
 		if (poller->mode == MODE_POLL) {
 			retcode = signal_poller(event, state);
@@ -408,9 +431,27 @@ static int signal_poll_event(struct k_poll_event *event, uint32_t state)
 void z_handle_obj_poll_events(sys_dlist_t *events, uint32_t state)
 {
 	struct k_poll_event *poll_event;
+	struct z_poller *poller;
 
 	poll_event = (struct k_poll_event *)sys_dlist_get(events);
-	if (poll_event != NULL) {
+	if (poll_event == NULL) {
+		return;
+	}
+
+	/* Objects signal with their own lock held, poll sets need ours */
+	poller = poll_event->poller;
+	if (is_set_poller(poller)) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		/* The entry may have been removed from the set, and even
+		 * added again, before we got the lock.
+		 */
+		if (poll_event->poller == poller &&
+		    !sys_dnode_is_linked(&poll_event->_node)) {
+			signal_set_event(poll_event, state);
+		}
+		k_spin_unlock(&lock, key);
+	} else {
 		(void) signal_poll_event(poll_event, state);
 	}
 }
@@ -489,6 +530,274 @@ static inline void z_vrfy_k_poll_signal_reset(struct k_poll_signal *sig)
 
 #endif
 
+/*
+ * Poll sets.  Entries stay registered on their objects between waits.
+ * Signaling an entry moves it from the object's list to the set's ready
+ * list, so a wait only ever looks at the entries that were signaled.
+ * An entry is always on exactly one of the two lists.  All set state is
+ * protected by the subsystem lock.
+ */
+
+void k_poll_set_init(struct k_poll_set *set, struct k_poll_event *events,
+		     int num_events)
+{
+	__ASSERT(events != NULL, "NULL events\n");
+	__ASSERT(num_events > 0, "zero events\n");
+
+	for (int i = 0; i < num_events; i++) {
+		events[i].obj = NULL;
+	}
+
+	set->events = events;
+	set->num_events = num_events;
+	sys_dlist_init(&set->ready);
+	z_waitq_init(&set->wait_q);
+	set->poller.is_polling = false;
+	set->poller.mode = MODE_SET;
+	z_object_init(set);
+}
+
+/* must be called with the subsystem lock held */
+static void signal_set_event(struct k_poll_event *event, uint32_t state)
+{
+	struct k_poll_set *set = CONTAINER_OF(event->poller,
+					      struct k_poll_set, poller);
+	struct k_thread *thread;
+
+	event->state |= state;
+	sys_dlist_append(&set->ready, &event->_node);
+
+	thread = z_unpend_first_thread(&set->wait_q);
+	if (thread != NULL) {
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+	}
+}
+
+int z_impl_k_poll_set_add(struct k_poll_set *set, uint32_t type, void *obj)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct k_poll_event *event = NULL;
+	int id;
+
+	for (id = 0; id < set->num_events; id++) {
+		if (set->events[id].obj == NULL) {
+			event = &set->events[id];
+			break;
+		}
+	}
+
+	if (event == NULL) {
+		k_spin_unlock(&lock, key);
+		return -ENOMEM;
+	}
+
+	/* Static sets are not initialized at runtime */
+	set->poller.mode = MODE_SET;
+
+	event->type = type;
+	event->state = K_POLL_STATE_NOT_READY;
+	event->mode = K_POLL_MODE_NOTIFY_ONLY;
+	event->unused = 0U;
+	event->tag = 0U;
+	event->obj = obj;
+	sys_dnode_init(&event->_node);
+
+	/* Start out on the ready list, the first wait checks the
+	 * condition and registers the entry on its object if not met.
+	 */
+	event->poller = &set->poller;
+	sys_dlist_append(&set->ready, &event->_node);
+
+	k_spin_unlock(&lock, key);
+	return id;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_poll_set_add(struct k_poll_set *set,
+					uint32_t type, void *obj)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(set, K_OBJ_POLL_SET));
+
+	switch (type) {
+	case K_POLL_TYPE_SIGNAL:
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_POLL_SIGNAL));
+		break;
+	case K_POLL_TYPE_SEM_AVAILABLE:
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_SEM));
+		break;
+	case K_POLL_TYPE_DATA_AVAILABLE:
+		Z_OOPS(Z_SYSCALL_OBJ(obj, K_OBJ_QUEUE));
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return z_impl_k_poll_set_add(set, type, obj);
+}
+#include <syscalls/k_poll_set_add_mrsh.c>
+#endif
+
+int z_impl_k_poll_set_remove(struct k_poll_set *set, int id)
+{
+	k_spinlock_key_t key;
+	struct k_poll_event *event;
+
+	if (id < 0 || id >= set->num_events) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	event = &set->events[id];
+
+	if (event->obj == NULL) {
+		k_spin_unlock(&lock, key);
+		return -EINVAL;
+	}
+
+	/* Whether on the ready list or the object's list */
+	if (sys_dnode_is_linked(&event->_node)) {
+		sys_dlist_remove(&event->_node);
+	}
+	event->poller = NULL;
+	event->obj = NULL;
+
+	k_spin_unlock(&lock, key);
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_poll_set_remove(struct k_poll_set *set, int id)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(set, K_OBJ_POLL_SET));
+	return z_impl_k_poll_set_remove(set, id);
+}
+#include <syscalls/k_poll_set_remove_mrsh.c>
+#endif
+
+/* Reports up to num_results ready entries.  Entries whose condition no
+ * longer holds go back to their object, reported ones stay at the tail
+ * of the ready list: like the objects themselves, readiness is level
+ * triggered, so an entry keeps being reported until it is consumed.
+ *
+ * must be called with the subsystem lock held
+ */
+static int collect_ready(struct k_poll_set *set,
+			 struct k_poll_set_result *results, int num_results)
+{
+	sys_dlist_t reported;
+	sys_dnode_t *node;
+	int n = 0;
+
+	sys_dlist_init(&reported);
+
+	while (n < num_results) {
+		struct k_poll_event *event;
+		uint32_t state = 0U;
+		bool met;
+
+		node = sys_dlist_get(&set->ready);
+		if (node == NULL) {
+			break;
+		}
+
+		event = CONTAINER_OF(node, struct k_poll_event, _node);
+		met = is_condition_met(event, &state);
+		state |= event->state & K_POLL_STATE_CANCELLED;
+		event->state = K_POLL_STATE_NOT_READY;
+
+		if (state == 0U) {
+			register_event(event, &set->poller);
+			continue;
+		}
+
+		results[n].id = event - set->events;
+		results[n].state = state;
+		n++;
+		sys_dlist_append(&reported, node);
+	}
+
+	while ((node = sys_dlist_get(&reported)) != NULL) {
+		sys_dlist_append(&set->ready, node);
+	}
+
+	return n;
+}
+
+int z_impl_k_poll_set_wait(struct k_poll_set *set,
+			   struct k_poll_set_result *results, int num_results,
+			   k_timeout_t timeout)
+{
+	int64_t now, end = sys_clock_timeout_end_calc(timeout);
+	k_spinlock_key_t key;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	if (num_results <= 0) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+
+	while (true) {
+		ret = collect_ready(set, results, num_results);
+		if (ret > 0) {
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			(void) z_pend_curr(&lock, key, &set->wait_q, K_FOREVER);
+		} else {
+			now = sys_clock_tick_get();
+			if ((end - now) <= 0) {
+				ret = -EAGAIN;
+				break;
+			}
+			(void) z_pend_curr(&lock, key, &set->wait_q,
+					   K_TICKS(end - now));
+		}
+		key = k_spin_lock(&lock);
+	}
+
+	k_spin_unlock(&lock, key);
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_poll_set_wait(struct k_poll_set *set,
+					 struct k_poll_set_result *results,
+					 int num_results, k_timeout_t timeout)
+{
+	struct k_poll_set_result *results_copy;
+	int ret;
+
+	Z_OOPS(Z_SYSCALL_OBJ(set, K_OBJ_POLL_SET));
+	if (num_results <= 0) {
+		return -EINVAL;
+	}
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(results, num_results,
+					    sizeof(*results)));
+
+	/* The results are collected with the subsystem lock held, so
+	 * into a kernel-side buffer, and copied out after it is released.
+	 */
+	results_copy = z_thread_malloc(num_results * sizeof(*results));
+	if (results_copy == NULL) {
+		return -ENOMEM;
+	}
+
+	ret = z_impl_k_poll_set_wait(set, results_copy, num_results, timeout);
+	if (ret > 0) {
+		(void)memcpy(results, results_copy, ret * sizeof(*results));
+	}
+
+	k_free(results_copy);
+	return ret;
+}
+#include <syscalls/k_poll_set_wait_mrsh.c>
+#endif
+
 static void triggered_work_handler(struct k_work *work)
 {
 	struct k_work_poll *twork =
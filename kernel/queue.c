@@ -81,6 +81,9 @@ void z_impl_k_queue_init(struct k_queue *queue)
 	sys_sflist_init(&queue->data_q);
 	queue->lock = (struct k_spinlock) {};
 	z_waitq_init(&queue->wait_q);
+#if defined(CONFIG_QUEUE_MPSC)
+	queue->mpsc = false;
+#endif
 #if defined(CONFIG_POLL)
 	sys_dlist_init(&queue->poll_events);
 #endif
@@ -111,6 +114,175 @@ static inline void handle_poll_events(struct k_queue *queue, uint32_t state)
 #endif
 }
 
+#ifdef CONFIG_QUEUE_MPSC
+
+/*
+ * In MPSC mode data_q is an intrusive lock-free list in the style of
+ * Vyukov's MPSC queue.  A producer swaps its node in as the new tail
+ * and then links the old tail to it, the single consumer takes nodes
+ * off the head without the lock.  An empty list has a NULL tail, so the
+ * producer that swaps out NULL knows it made the queue non-empty; it
+ * sets the head instead of linking and is the only one to take the lock,
+ * to hand the head to the pending consumer or signal poll events.
+ *
+ * Producers swap and link with local interrupts masked, so the consumer
+ * finding a node which is not linked yet only ever waits for another
+ * CPU to finish those two stores.
+ */
+
+static inline bool queue_is_mpsc(struct k_queue *queue)
+{
+	return queue->mpsc;
+}
+
+static inline sys_sfnode_t *mpsc_next(sys_sfnode_t *node)
+{
+	unative_t next = (unative_t)atomic_ptr_get(
+		(atomic_ptr_t *)&node->next_and_flags);
+
+	return (sys_sfnode_t *)(next & ~SYS_SFLIST_FLAGS_MASK);
+}
+
+/* Only called by the consumer, or on its behalf while it is pending */
+static sys_sfnode_t *mpsc_pop(struct k_queue *queue)
+{
+	atomic_ptr_t *head = (atomic_ptr_t *)&queue->data_q.head;
+	atomic_ptr_t *tail = (atomic_ptr_t *)&queue->data_q.tail;
+	sys_sfnode_t *node = atomic_ptr_get(head);
+	sys_sfnode_t *next;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	next = mpsc_next(node);
+	if (next == NULL) {
+		/* Looks like the last node.  Clear the head first, a
+		 * producer seeing the NULL tail sets it right away.
+		 */
+		(void)atomic_ptr_set(head, NULL);
+		if (atomic_ptr_cas(tail, node, NULL)) {
+			return node;
+		}
+
+		/* Lost against a producer, which links its node next */
+		do {
+			next = mpsc_next(node);
+		} while (next == NULL);
+	}
+
+	(void)atomic_ptr_set(head, next);
+	return node;
+}
+
+/* Called by the producer which made the queue non-empty */
+static void mpsc_wake(struct k_queue *queue)
+{
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	struct k_thread *thread = NULL;
+
+	/* While we hold the lock the consumer can't start pending.  If it
+	 * already is, it isn't taking nodes either, so once unpended we
+	 * can take the head for it.  If it got the node meanwhile there's
+	 * nothing to do, a pending consumer will be woken by the next
+	 * producer finding the queue empty.
+	 */
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		thread = z_unpend_first_thread(&queue->wait_q);
+	}
+
+	if (thread != NULL) {
+		prepare_thread_to_run(thread,
+				      z_queue_node_peek(mpsc_pop(queue), true));
+	} else {
+		handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
+	}
+
+	z_reschedule(&queue->lock, key);
+}
+
+/* Appends the NULL terminated list from @a head to @a tail */
+static void mpsc_push(struct k_queue *queue, sys_sfnode_t *head,
+		      sys_sfnode_t *tail)
+{
+	sys_sfnode_t *prev;
+	unsigned int key;
+
+	key = arch_irq_lock();
+
+	prev = atomic_ptr_set((atomic_ptr_t *)&queue->data_q.tail, tail);
+	if (prev != NULL) {
+		(void)atomic_ptr_set((atomic_ptr_t *)&prev->next_and_flags,
+				     (void *)((unative_t)head |
+					      sys_sfnode_flags_get(prev)));
+	} else {
+		(void)atomic_ptr_set((atomic_ptr_t *)&queue->data_q.head,
+				     head);
+	}
+
+	arch_irq_unlock(key);
+
+	if (prev == NULL) {
+		mpsc_wake(queue);
+	}
+}
+
+static void *mpsc_get(struct k_queue *queue, k_timeout_t timeout)
+{
+	sys_sfnode_t *node = mpsc_pop(queue);
+	k_spinlock_key_t key;
+	int ret;
+
+	if ((node != NULL) || K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return z_queue_node_peek(node, true);
+	}
+
+	key = k_spin_lock(&queue->lock);
+
+	/* The producer making the queue non-empty takes the lock after
+	 * setting the head, so it either sees us pending or we see the head
+	 */
+	node = mpsc_pop(queue);
+	if (node != NULL) {
+		k_spin_unlock(&queue->lock, key);
+		return z_queue_node_peek(node, true);
+	}
+
+	ret = z_pend_curr(&queue->lock, key, &queue->wait_q, timeout);
+
+	return (ret != 0) ? NULL : _current->base.swap_data;
+}
+
+void k_queue_init_mpsc(struct k_queue *queue)
+{
+	z_impl_k_queue_init(queue);
+	queue->mpsc = true;
+}
+
+static int32_t mpsc_insert(struct k_queue *queue, void *data, bool alloc,
+			   bool is_append)
+{
+	__ASSERT(is_append, "MPSC queues can only be appended to");
+
+	if (alloc) {
+		struct alloc_node *anode;
+
+		anode = z_thread_malloc(sizeof(*anode));
+		if (anode == NULL) {
+			return -ENOMEM;
+		}
+		anode->data = data;
+		sys_sfnode_init(&anode->node, 0x1);
+		data = anode;
+	} else {
+		sys_sfnode_init(data, 0x0);
+	}
+
+	mpsc_push(queue, data, data);
+	return 0;
+}
+#endif /* CONFIG_QUEUE_MPSC */
+
 void z_impl_k_queue_cancel_wait(struct k_queue *queue)
 {
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
@@ -138,6 +310,12 @@ static inline void z_vrfy_k_queue_cancel_wait(struct k_queue *queue)
 static int32_t queue_insert(struct k_queue *queue, void *prev, void *data,
 			    bool alloc, bool is_append)
 {
+#ifdef CONFIG_QUEUE_MPSC
+	if (queue_is_mpsc(queue)) {
+		return mpsc_insert(queue, data, alloc, is_append);
+	}
+#endif
+
 	struct k_thread *first_pending_thread;
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 
@@ -227,6 +405,13 @@ int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_QUEUE_MPSC
+	if (queue_is_mpsc(queue)) {
+		mpsc_push(queue, head, tail);
+		return 0;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	struct k_thread *thread = NULL;
 
@@ -278,6 +463,12 @@ int k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list)
 
 void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 {
+#ifdef CONFIG_QUEUE_MPSC
+	if (queue_is_mpsc(queue)) {
+		return mpsc_get(queue, timeout);
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	void *data;
 
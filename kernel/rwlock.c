@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief reader-writer lock kernel services
+ *
+ * A reader-writer lock is held either by any number of readers or by a
+ * single writer.  Waiting writers and readers are arbitrated by priority:
+ * a waiting writer keeps out new readers of lower priority, or every new
+ * reader when the lock prefers writers.
+ *
+ * The writer owning the lock inherits the priority of the highest priority
+ * thread waiting on it, following the same rules as k_mutex.  Readers are
+ * not tracked individually and so do not take part in priority
+ * inheritance.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <toolchain.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <errno.h>
+#include <syscall_handler.h>
+
+/* Global lock for the same reason as in mutex.c: it also protects the
+ * priority of the owning writer, which isn't "part of" the rwlock.
+ */
+static struct k_spinlock lock;
+
+int z_impl_k_rwlock_init(struct k_rwlock *rwlock, uint32_t flags)
+{
+	if ((flags & ~K_RWLOCK_PREFER_WRITER) != 0U) {
+		return -EINVAL;
+	}
+
+	z_waitq_init(&rwlock->rd_wait_q);
+	z_waitq_init(&rwlock->wr_wait_q);
+	rwlock->writer = NULL;
+	rwlock->readers = 0U;
+	rwlock->flags = flags;
+	rwlock->owner_orig_prio = K_LOWEST_THREAD_PRIO;
+	z_object_init(rwlock);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_init(struct k_rwlock *rwlock,
+				       uint32_t flags)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_init(rwlock, flags);
+}
+#include <syscalls/k_rwlock_init_mrsh.c>
+#endif
+
+/* Does the first waiting writer keep out a reader of priority prio? */
+static bool writer_blocks(struct k_rwlock *rwlock, int prio)
+{
+	struct k_thread *writer = z_waitq_head(&rwlock->wr_wait_q);
+
+	if (writer == NULL) {
+		return false;
+	}
+
+	return ((rwlock->flags & K_RWLOCK_PREFER_WRITER) != 0U) ||
+		z_is_prio_higher(writer->base.prio, prio);
+}
+
+/* Raise the owning writer to the priority of the highest priority waiter,
+ * or drop it back to its own
+ */
+static bool adjust_owner_prio(struct k_rwlock *rwlock)
+{
+	struct k_thread *waiter;
+	int new_prio = rwlock->owner_orig_prio;
+
+	waiter = z_waitq_head(&rwlock->rd_wait_q);
+	if ((waiter != NULL) && z_is_prio_higher(waiter->base.prio, new_prio)) {
+		new_prio = waiter->base.prio;
+	}
+	waiter = z_waitq_head(&rwlock->wr_wait_q);
+	if ((waiter != NULL) && z_is_prio_higher(waiter->base.prio, new_prio)) {
+		new_prio = waiter->base.prio;
+	}
+	new_prio = z_get_new_prio_with_ceiling(new_prio);
+
+	if (rwlock->writer->base.prio != new_prio) {
+		return z_set_prio(rwlock->writer, new_prio);
+	}
+	return false;
+}
+
+/* Hand the unlocked rwlock to the first waiting writer, if any */
+static bool wake_writer(struct k_rwlock *rwlock)
+{
+	struct k_thread *writer = z_unpend_first_thread(&rwlock->wr_wait_q);
+
+	if (writer == NULL) {
+		return false;
+	}
+
+	rwlock->writer = writer;
+	rwlock->owner_orig_prio = writer->base.prio;
+	(void)adjust_owner_prio(rwlock);
+	arch_thread_return_value_set(writer, 0);
+	z_ready_thread(writer);
+
+	return true;
+}
+
+/* Admit the waiting readers not kept out by a waiting writer.  The wait
+ * queue is sorted by priority so they are all at its head.
+ */
+static bool wake_readers(struct k_rwlock *rwlock)
+{
+	struct k_thread *reader;
+	bool woken = false;
+
+	while (true) {
+		reader = z_waitq_head(&rwlock->rd_wait_q);
+		if ((reader == NULL) ||
+		    writer_blocks(rwlock, reader->base.prio)) {
+			break;
+		}
+
+		z_unpend_thread(reader);
+		rwlock->readers++;
+		arch_thread_return_value_set(reader, 0);
+		z_ready_thread(reader);
+		woken = true;
+	}
+
+	return woken;
+}
+
+int z_impl_k_rwlock_read_lock(struct k_rwlock *rwlock, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	bool resched = false;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	key = k_spin_lock(&lock);
+
+	if ((rwlock->writer == NULL) &&
+	    !writer_blocks(rwlock, _current->base.prio)) {
+		rwlock->readers++;
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&lock, key);
+		return -EBUSY;
+	}
+
+	if ((rwlock->writer != NULL) &&
+	    z_is_prio_higher(_current->base.prio, rwlock->writer->base.prio)) {
+		resched = z_set_prio(rwlock->writer,
+			z_get_new_prio_with_ceiling(_current->base.prio));
+	}
+
+	ret = z_pend_curr(&lock, key, &rwlock->rd_wait_q, timeout);
+	if (ret == 0) {
+		return 0;
+	}
+
+	/* timed out */
+
+	key = k_spin_lock(&lock);
+
+	if (rwlock->writer != NULL) {
+		resched = adjust_owner_prio(rwlock) || resched;
+	}
+
+	if (resched) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+
+	return -EAGAIN;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_read_lock(struct k_rwlock *rwlock,
+					    k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_read_lock(rwlock, timeout);
+}
+#include <syscalls/k_rwlock_read_lock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_write_lock(struct k_rwlock *rwlock, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	bool resched = false;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	key = k_spin_lock(&lock);
+
+	if ((rwlock->writer == NULL) && (rwlock->readers == 0U)) {
+		rwlock->writer = _current;
+		rwlock->owner_orig_prio = _current->base.prio;
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&lock, key);
+		return -EBUSY;
+	}
+
+	if ((rwlock->writer != NULL) &&
+	    z_is_prio_higher(_current->base.prio, rwlock->writer->base.prio)) {
+		resched = z_set_prio(rwlock->writer,
+			z_get_new_prio_with_ceiling(_current->base.prio));
+	}
+
+	ret = z_pend_curr(&lock, key, &rwlock->wr_wait_q, timeout);
+	if (ret == 0) {
+		return 0;
+	}
+
+	/* timed out */
+
+	key = k_spin_lock(&lock);
+
+	if (rwlock->writer != NULL) {
+		resched = adjust_owner_prio(rwlock) || resched;
+	} else {
+		/* readers we kept out may be free to go now */
+		resched = wake_readers(rwlock) || resched;
+	}
+
+	if (resched) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+
+	return -EAGAIN;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_write_lock(struct k_rwlock *rwlock,
+					     k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_lock(rwlock, timeout);
+}
+#include <syscalls/k_rwlock_write_lock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_unlock(struct k_rwlock *rwlock)
+{
+	k_spinlock_key_t key;
+	bool resched = false;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	key = k_spin_lock(&lock);
+
+	if (rwlock->writer != NULL) {
+		if (rwlock->writer != _current) {
+			k_spin_unlock(&lock, key);
+			return -EPERM;
+		}
+
+		/* drop any inherited priority */
+		if (_current->base.prio != rwlock->owner_orig_prio) {
+			resched = z_set_prio(_current, rwlock->owner_orig_prio);
+		}
+		rwlock->writer = NULL;
+
+		/* waiting readers that aren't kept out go first, as they
+		 * would have, had they arrived now
+		 */
+		resched = wake_readers(rwlock) || wake_writer(rwlock) ||
+			  resched;
+	} else if (rwlock->readers != 0U) {
+		rwlock->readers--;
+		resched = (rwlock->readers == 0U) && wake_writer(rwlock);
+	} else {
+		k_spin_unlock(&lock, key);
+		return -EINVAL;
+	}
+
+	if (resched) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_unlock(struct k_rwlock *rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_unlock(rwlock);
+}
+#include <syscalls/k_rwlock_unlock_mrsh.c>
+#endif
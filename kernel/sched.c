@@ -49,6 +49,7 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 /* the only struct z_kernel instance */
 struct z_kernel _kernel;
 
+/* Also protects the per-CPU ready queues of CONFIG_SCHED_CPU_RUNQ */
 struct k_spinlock sched_spinlock;
 
 static void update_cache(int);
@@ -194,12 +195,148 @@ static inline bool should_queue_thread(struct k_thread *th)
 	return !IS_ENABLED(CONFIG_SMP) || th != _current;
 }
 
-static ALWAYS_INLINE void queue_thread(void *pq,
-				       struct k_thread *thread)
+#ifdef CONFIG_SMP
+static ALWAYS_INLINE bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return true;
+#endif
+}
+#endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+
+/* True if the thread would preempt whatever the CPU runs right now */
+static inline bool cpu_preemptible_by(struct k_thread *thread, int cpu)
+{
+	struct k_thread *curr = _kernel.cpus[cpu].current;
+
+	return curr == NULL || z_is_idle_thread_object(curr) ||
+		z_sched_prio_cmp(thread, curr) > 0;
+}
+
+/* Picks the CPU whose ready queue a newly runnable thread is placed
+ * on.  _current always goes back to its own CPU.  Otherwise prefer
+ * the CPU the thread last ran on (its cache is likely still warm)
+ * if the thread would preempt what runs there, then an idle CPU,
+ * then any CPU it would preempt, and finally the first allowed CPU
+ * starting from the last one.  This is only a placement hint:
+ * next_up() pulls from the other CPUs' queues whenever their best
+ * thread outranks the local one, so a poor guess never costs
+ * priority correctness.
+ */
+static int runq_select_cpu(struct k_thread *thread)
+{
+	int last = thread->base.cpu;
+	int preempted = -1, fallback = -1;
+
+	if (thread == _current) {
+		return _current_cpu->id;
+	}
+
+	if (cpu_allowed(thread, last) && cpu_preemptible_by(thread, last)) {
+		return last;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		int cpu = (last + i) % CONFIG_MP_NUM_CPUS;
+		struct k_thread *curr = _kernel.cpus[cpu].current;
+
+		if (!cpu_allowed(thread, cpu)) {
+			continue;
+		}
+
+		if (curr == NULL || z_is_idle_thread_object(curr)) {
+			return cpu;
+		}
+
+		if (preempted < 0 && cpu_preemptible_by(thread, cpu)) {
+			preempted = cpu;
+		}
+
+		if (fallback < 0) {
+			fallback = cpu;
+		}
+	}
+
+	__ASSERT(fallback >= 0, "thread %p can run on no CPU", thread);
+
+	if (preempted >= 0) {
+		return preempted;
+	}
+	return fallback < 0 ? _current_cpu->id : fallback;
+}
+#endif
+
+static ALWAYS_INLINE void *curr_cpu_runq(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &_current_cpu->ready_q.runq;
+#else
+	return &_kernel.ready_q.runq;
+#endif
+}
+
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &_kernel.cpus[thread->base.runq_cpu].ready_q.runq;
+#else
+	ARG_UNUSED(thread);
+	return &_kernel.ready_q.runq;
+#endif
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread->base.runq_cpu = runq_select_cpu(thread);
+#endif
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	struct k_thread *thread = _priq_run_best(curr_cpu_runq());
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Work stealing: take the best thread queued on another CPU
+	 * if it outranks everything queued here (which is always the
+	 * case when this CPU is about to go idle).  Ties stay local.
+	 * With SCHED_CPU_MASK, _priq_run_best() only returns threads
+	 * allowed to run on this CPU.
+	 */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *t;
+
+		if (i == _current_cpu->id) {
+			continue;
+		}
+
+		t = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		if (t != NULL &&
+		    (thread == NULL || z_sched_prio_cmp(t, thread) > 0)) {
+			thread = t;
+		}
+	}
+#endif
+	return thread;
+}
+
+static ALWAYS_INLINE void queue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state |= _THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_add(pq, thread);
+		runq_add(thread);
 	}
 #ifdef CONFIG_SMP
 	if (thread == _current) {
@@ -209,12 +346,11 @@ static ALWAYS_INLINE void queue_thread(void *pq,
 #endif
 }
 
-static ALWAYS_INLINE void dequeue_thread(void *pq,
-					 struct k_thread *thread)
+static ALWAYS_INLINE void dequeue_thread(struct k_thread *thread)
 {
 	thread->base.thread_state &= ~_THREAD_QUEUED;
 	if (should_queue_thread(thread)) {
-		_priq_run_remove(pq, thread);
+		runq_remove(thread);
 	}
 }
 
@@ -228,7 +364,7 @@ static ALWAYS_INLINE void dequeue_thread(void *pq,
 void z_requeue_current(struct k_thread *curr)
 {
 	if (z_is_thread_queued(curr)) {
-		_priq_run_add(&_kernel.ready_q.runq, curr);
+		runq_add(curr);
 	}
 }
 #endif
@@ -242,7 +378,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -308,12 +444,12 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		queue_thread(&_kernel.ready_q.runq, _current);
+		queue_thread(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 
 	_current_cpu->swap_ok = false;
@@ -324,9 +460,9 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
-	queue_thread(&_kernel.ready_q.runq, thread);
+	queue_thread(thread);
 	update_cache(thread == _current);
 }
 
@@ -480,6 +616,122 @@ static bool thread_active_elsewhere(struct k_thread *thread)
 	return false;
 }
 
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+/* Returns the mask of other CPUs which would switch to the thread if
+ * they rescheduled now: idle ones, and ones running a lower priority
+ * thread they may be preempted from.  Must be called with
+ * sched_spinlock held.
+ */
+static uint32_t ipi_mask_create(struct k_thread *thread)
+{
+	uint32_t mask = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *curr = _kernel.cpus[i].current;
+
+		if (i == _current_cpu->id || curr == NULL ||
+		    !cpu_allowed(thread, i)) {
+			continue;
+		}
+
+		if (z_is_idle_thread_object(curr) ||
+		    (z_sched_prio_cmp(thread, curr) > 0 &&
+		     (is_preempt(curr) || is_metairq(thread)))) {
+			mask |= BIT(i);
+		}
+	}
+
+	return mask;
+}
+
+/* Interrupts the CPUs in the mask so they reschedule.  Architectures
+ * without directed IPIs have to interrupt all of them, but even then
+ * nothing is sent when no CPU would switch.  Must be called with
+ * sched_spinlock held.
+ */
+static void send_ipi(uint32_t mask)
+{
+	if (mask == 0U) {
+		return;
+	}
+
+#ifdef CONFIG_ARCH_HAS_DIRECTED_IPIS
+#ifdef CONFIG_SCHED_IPI_STATS
+	_current_cpu->ipi_sent += popcount(mask);
+#endif
+	arch_sched_directed_ipi(mask);
+#else
+#ifdef CONFIG_SCHED_IPI_STATS
+	_current_cpu->ipi_sent += CONFIG_MP_NUM_CPUS - 1;
+#endif
+	arch_sched_ipi();
+#endif
+}
+#endif
+
+#ifdef CONFIG_SCHED_BUDGET
+static void budget_expired(struct _timeout *t);
+
+/* Cycles the thread has run for, including the current run if it is
+ * running now
+ */
+static uint64_t budget_cycles(struct k_thread *thread)
+{
+	uint64_t cycles = thread->rt_stats.stats.execution_cycles;
+	uint32_t switched_in = thread->rt_stats.last_switched_in;
+
+	if (switched_in != 0U) {
+		cycles += (uint32_t)(k_cycle_get_32() - switched_in);
+	}
+
+	return cycles;
+}
+
+/* Cycles the thread has run for since its period started */
+static uint32_t budget_used(struct k_thread *thread)
+{
+	return (uint32_t)MIN(budget_cycles(thread) - thread->base.budget_base,
+			     UINT32_MAX);
+}
+
+static void budget_timeout_set(struct k_thread *thread, uint32_t cycles)
+{
+	(void)z_abort_timeout(&thread->base.budget_timeout);
+	z_add_timeout(&thread->base.budget_timeout, budget_expired,
+		      K_CYC(cycles));
+}
+
+static void budget_period_start(struct k_thread *thread, uint32_t deadline)
+{
+	thread->base.budget_base = budget_cycles(thread);
+	thread->base.prio_deadline = deadline;
+}
+
+/* The thread is about to be queued after waiting, sleeping or being
+ * throttled.  Applies the CBS wakeup rule: the current deadline is
+ * kept only if the budget left can be used up before it without
+ * exceeding the reserved bandwidth, i.e. if
+ * left / (deadline - now) <= budget / period.  The budget timeout is
+ * then set for the earliest time the budget may be used up.
+ */
+static void budget_wakeup(struct k_thread *thread)
+{
+	uint32_t now = k_cycle_get_32();
+	uint32_t used = budget_used(thread);
+	uint32_t left = thread->base.budget - MIN(used, thread->base.budget);
+	int32_t to_deadline = (int32_t)(thread->base.prio_deadline - now);
+
+	if (to_deadline <= 0 ||
+	    (uint64_t)left * thread->base.budget_period >
+	    (uint64_t)to_deadline * thread->base.budget) {
+		budget_period_start(thread, now + thread->base.budget_period);
+		left = thread->base.budget;
+	}
+
+	budget_timeout_set(thread, left);
+}
+#endif
+
 static void ready_thread(struct k_thread *thread)
 {
 #ifdef CONFIG_KERNEL_COHERENCE
@@ -491,10 +743,15 @@ static void ready_thread(struct k_thread *thread)
 	 */
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
-		queue_thread(&_kernel.ready_q.runq, thread);
+#ifdef CONFIG_SCHED_BUDGET
+		if (thread->base.budget != 0U) {
+			budget_wakeup(thread);
+		}
+#endif
+		queue_thread(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
-		arch_sched_ipi();
+		send_ipi(ipi_mask_create(thread));
 #endif
 	}
 }
@@ -535,7 +792,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		z_mark_thread_as_suspended(thread);
 		update_cache(thread == _current);
@@ -590,7 +847,7 @@ static _wait_q_t *pended_on(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		dequeue_thread(&_kernel.ready_q.runq, thread);
+		dequeue_thread(thread);
 	}
 	update_cache(thread == _current);
 }
@@ -752,9 +1009,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				dequeue_thread(&_kernel.ready_q.runq, thread);
+				dequeue_thread(thread);
 				thread->base.prio = prio;
-				queue_thread(&_kernel.ready_q.runq, thread);
+				queue_thread(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -773,7 +1030,18 @@ void z_thread_priority_set(struct k_thread *thread, int prio)
 	bool need_sched = z_set_prio(thread, prio);
 
 #if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
-	arch_sched_ipi();
+	LOCKED(&sched_spinlock) {
+		/* A queued thread may now preempt another CPU, and a
+		 * thread running elsewhere may now have to yield it
+		 */
+		uint32_t mask = z_is_thread_queued(thread)
+			? ipi_mask_create(thread) : 0U;
+
+		if (thread_active_elsewhere(thread)) {
+			mask |= BIT(thread->base.cpu);
+		}
+		send_ipi(mask);
+	}
 #endif
 
 	if (need_sched && _current->base.sched_locked == 0U) {
@@ -883,6 +1151,15 @@ void *z_get_next_switch_handle(void *interrupted)
 		}
 		new_thread = next_up();
 
+#ifdef CONFIG_SCHED_IPI_STATS
+		if (_current_cpu->ipi_pending != 0U) {
+			_current_cpu->ipi_pending = 0U;
+			if (old_thread != new_thread) {
+				_current_cpu->ipi_switched++;
+			}
+		}
+#endif
+
 		if (old_thread != new_thread) {
 			update_metairq_preempt(new_thread);
 			wait_for_switch(new_thread);
@@ -892,6 +1169,7 @@ void *z_get_next_switch_handle(void *interrupted)
 			z_reset_time_slice();
 #endif
 			_current_cpu->swap_ok = 0;
+			new_thread->base.cpu = _current_cpu->id;
 			set_current(new_thread);
 
 #ifdef CONFIG_SPIN_VALIDATE
@@ -910,8 +1188,7 @@ void *z_get_next_switch_handle(void *interrupted)
 			 * will not return into it.
 			 */
 			if (z_is_thread_queued(old_thread)) {
-				_priq_run_add(&_kernel.ready_q.runq,
-					      old_thread);
+				runq_add(old_thread);
 			}
 		}
 		old_thread->switch_handle = interrupted;
@@ -1084,24 +1361,31 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
-#ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
-#endif
-
-#ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+#if defined(CONFIG_SCHED_SCALABLE)
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
 	};
+#elif defined(CONFIG_SCHED_MULTIQ)
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#else
+	sys_dlist_init(&rq->runq);
 #endif
+}
 
-#ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1161,8 +1445,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
-			queue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
+			queue_thread(thread);
 		}
 	}
 }
@@ -1183,6 +1467,123 @@ static inline void z_vrfy_k_thread_deadline_set(k_tid_t tid, int deadline)
 #endif
 #endif
 
+#ifdef CONFIG_SCHED_BUDGET
+/* Throttles the thread until the end of its period */
+static void budget_throttle(struct k_thread *thread)
+{
+	int32_t to_deadline = (int32_t)(thread->base.prio_deadline -
+					k_cycle_get_32());
+
+	thread->base.thread_state |= _THREAD_THROTTLED;
+	if (z_is_thread_queued(thread)) {
+		dequeue_thread(thread);
+	}
+	update_cache(thread == _current);
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+	if (thread_active_elsewhere(thread)) {
+		send_ipi(BIT(thread->base.cpu));
+	}
+#endif
+
+	budget_timeout_set(thread, MAX(to_deadline, 0));
+}
+
+static void budget_expired(struct _timeout *t)
+{
+	struct k_thread *thread = CONTAINER_OF(t, struct k_thread,
+					       base.budget_timeout);
+	k_spinlock_key_t key = k_spin_lock(&sched_spinlock);
+	uint32_t used;
+
+	if (thread->base.budget == 0U) {
+		/* The budget was removed as this was about to run */
+		k_spin_unlock(&sched_spinlock, key);
+		return;
+	}
+
+	if (z_is_thread_state_set(thread, _THREAD_THROTTLED)) {
+		/* The period is over, the budget is replenished as the
+		 * thread wakes up
+		 */
+		thread->base.thread_state &= ~_THREAD_THROTTLED;
+		ready_thread(thread);
+	} else {
+		used = budget_used(thread);
+		if (used >= thread->base.budget) {
+			budget_throttle(thread);
+		} else if (z_is_thread_ready(thread)) {
+			/* The thread didn't run all the time, check
+			 * again when the budget may be used up.  Waiting
+			 * threads are checked again when they wake up.
+			 */
+			budget_timeout_set(thread,
+					   thread->base.budget - used);
+		}
+	}
+
+	k_spin_unlock(&sched_spinlock, key);
+}
+
+int z_impl_k_thread_budget_set(k_tid_t thread, uint32_t budget_us,
+			       uint32_t period_us)
+{
+	uint64_t budget = k_us_to_cyc_ceil64(budget_us);
+	uint64_t period = k_us_to_cyc_ceil64(period_us);
+	k_spinlock_key_t key;
+
+	if (budget_us != 0U && (budget > period || period > INT32_MAX)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&sched_spinlock);
+
+	(void)z_abort_timeout(&thread->base.budget_timeout);
+	thread->base.budget = (uint32_t)budget;
+	thread->base.budget_period = (uint32_t)period;
+
+	if (budget != 0U) {
+		budget_period_start(thread, k_cycle_get_32() + (uint32_t)period);
+		if (z_is_thread_queued(thread)) {
+			dequeue_thread(thread);
+			queue_thread(thread);
+		}
+		if (z_is_thread_ready(thread)) {
+			budget_timeout_set(thread, (uint32_t)budget);
+		}
+	}
+
+	/* A new budget or none at all ends throttling immediately */
+	if (z_is_thread_state_set(thread, _THREAD_THROTTLED)) {
+		thread->base.thread_state &= ~_THREAD_THROTTLED;
+		ready_thread(thread);
+	}
+
+	z_reschedule(&sched_spinlock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_thread_budget_set(k_tid_t thread,
+					     uint32_t budget_us,
+					     uint32_t period_us)
+{
+	uint64_t budget = k_us_to_cyc_ceil64(budget_us);
+	uint64_t period = k_us_to_cyc_ceil64(period_us);
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(thread->base.budget == 0U ||
+				    (budget_us != 0U &&
+				     budget * thread->base.budget_period <=
+				     thread->base.budget * period),
+				    "thread budget may only be lowered"));
+
+	return z_impl_k_thread_budget_set(thread, budget_us, period_us);
+}
+#include <syscalls/k_thread_budget_set_mrsh.c>
+#endif
+#endif
+
 void z_impl_k_yield(void)
 {
 	__ASSERT(!arch_is_in_isr(), "");
@@ -1192,10 +1593,9 @@ void z_impl_k_yield(void)
 
 		if (!IS_ENABLED(CONFIG_SMP) ||
 			z_is_thread_queued(_current)) {
-			dequeue_thread(&_kernel.ready_q.runq,
-					_current);
+			dequeue_thread(_current);
 		}
-		queue_thread(&_kernel.ready_q.runq, _current);
+		queue_thread(_current);
 		update_cache(1);
 		z_swap(&sched_spinlock, key);
 	} else {
@@ -1318,10 +1718,6 @@ void z_impl_k_wakeup(k_tid_t thread)
 	z_mark_thread_as_not_suspended(thread);
 	z_ready_thread(thread);
 
-#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
-	arch_sched_ipi();
-#endif
-
 	if (!arch_is_in_isr()) {
 		z_reschedule_unlocked();
 	}
@@ -1337,12 +1733,33 @@ void z_sched_ipi(void)
 	/* NOTE: When adding code to this, make sure this is called
 	 * at appropriate location when !CONFIG_SCHED_IPI_SUPPORTED.
 	 */
+#ifdef CONFIG_SCHED_IPI_STATS
+	_current_cpu->ipi_received++;
+	_current_cpu->ipi_pending = 1U;
+#endif
 #ifdef CONFIG_TRACE_SCHED_IPI
 	z_trace_sched_ipi();
 #endif
 }
 #endif
 
+#ifdef CONFIG_SCHED_IPI_STATS
+int k_sched_ipi_stats_get(int cpu, struct k_ipi_stats *stats)
+{
+	if (cpu < 0 || cpu >= CONFIG_MP_NUM_CPUS || stats == NULL) {
+		return -EINVAL;
+	}
+
+	LOCKED(&sched_spinlock) {
+		stats->sent = _kernel.cpus[cpu].ipi_sent;
+		stats->received = _kernel.cpus[cpu].ipi_received;
+		stats->switched = _kernel.cpus[cpu].ipi_switched;
+	}
+
+	return 0;
+}
+#endif
+
 #ifdef CONFIG_USERSPACE
 static inline void z_vrfy_k_wakeup(k_tid_t thread)
 {
@@ -1352,7 +1769,7 @@ static inline void z_vrfy_k_wakeup(k_tid_t thread)
 #include <syscalls/k_wakeup_mrsh.c>
 #endif
 
-k_tid_t z_impl_k_current_get(void)
+k_tid_t z_impl_z_current_get(void)
 {
 #ifdef CONFIG_SMP
 	/* In SMP, _current is a field read from _current_cpu, which
@@ -1371,11 +1788,11 @@ k_tid_t z_impl_k_current_get(void)
 }
 
 #ifdef CONFIG_USERSPACE
-static inline k_tid_t z_vrfy_k_current_get(void)
+static inline k_tid_t z_vrfy_z_current_get(void)
 {
-	return z_impl_k_current_get();
+	return z_impl_z_current_get();
 }
-#include <syscalls/k_current_get_mrsh.c>
+#include <syscalls/z_current_get_mrsh.c>
 #endif
 
 int z_impl_k_is_preempt_thread(void)
@@ -1456,12 +1873,15 @@ static void end_thread(struct k_thread *thread)
 		thread->base.thread_state |= _THREAD_DEAD;
 		thread->base.thread_state &= ~_THREAD_ABORTING;
 		if (z_is_thread_queued(thread)) {
-			dequeue_thread(&_kernel.ready_q.runq, thread);
+			dequeue_thread(thread);
 		}
 		if (thread->base.pended_on != NULL) {
 			unpend_thread_no_timeout(thread);
 		}
 		(void)z_abort_thread_timeout(thread);
+#ifdef CONFIG_SCHED_BUDGET
+		(void)z_abort_timeout(&thread->base.budget_timeout);
+#endif
 		unpend_all(&thread->join_queue);
 		update_cache(1);
 
@@ -1499,7 +1919,7 @@ void z_thread_abort(struct k_thread *thread)
 		thread->base.thread_state |= _THREAD_ABORTING;
 
 #ifdef CONFIG_SCHED_IPI_SUPPORTED
-		arch_sched_ipi();
+		send_ipi(BIT(thread->base.cpu));
 #endif
 	}
 
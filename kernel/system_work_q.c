@@ -19,6 +19,16 @@ static K_KERNEL_STACK_DEFINE(sys_work_q_stack,
 
 struct k_work_q k_sys_work_q;
 
+#if defined(CONFIG_SYSTEM_WORKQUEUE_WORKERS) && \
+	(CONFIG_SYSTEM_WORKQUEUE_WORKERS > 1)
+#define SYS_WORK_Q_EXTRA_WORKERS (CONFIG_SYSTEM_WORKQUEUE_WORKERS - 1)
+
+static K_KERNEL_STACK_ARRAY_DEFINE(sys_work_q_worker_stacks,
+				   SYS_WORK_Q_EXTRA_WORKERS,
+				   CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE);
+static struct k_work_q_worker sys_work_q_workers[SYS_WORK_Q_EXTRA_WORKERS];
+#endif
+
 static int k_sys_work_q_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
@@ -31,6 +41,15 @@ static int k_sys_work_q_init(const struct device *dev)
 			    sys_work_q_stack,
 			    K_KERNEL_STACK_SIZEOF(sys_work_q_stack),
 			    CONFIG_SYSTEM_WORKQUEUE_PRIORITY, &cfg);
+
+#ifdef SYS_WORK_Q_EXTRA_WORKERS
+	for (int i = 0; i < SYS_WORK_Q_EXTRA_WORKERS; i++) {
+		(void)k_work_queue_add_worker(&k_sys_work_q,
+			&sys_work_q_workers[i], sys_work_q_worker_stacks[i],
+			K_KERNEL_STACK_SIZEOF(sys_work_q_worker_stacks[i]),
+			CONFIG_SYSTEM_WORKQUEUE_PRIORITY, -1);
+	}
+#endif
 	return 0;
 }
 
@@ -28,6 +28,7 @@
 #include <sys/check.h>
 #include <random/rand32.h>
 #include <sys/atomic.h>
+#include <debug/boot_profiler.h>
 #include <logging/log.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
@@ -607,6 +608,9 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_SCHED_CPU_MASK
 	new_thread->base.cpu_mask = -1;
 #endif
+#ifdef CONFIG_HEAP_PROFILER
+	new_thread->heap_prof_site = NULL;
+#endif
 #ifdef CONFIG_ARCH_HAS_CUSTOM_SWAP_TO_MAIN
 	/* _current may be null if the dummy thread is not used */
 	if (!_current) {
@@ -623,6 +627,10 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 #endif
 #ifdef CONFIG_SCHED_DEADLINE
 	new_thread->base.prio_deadline = 0;
+#endif
+#ifdef CONFIG_SCHED_BUDGET
+	new_thread->base.budget = 0U;
+	z_init_timeout(&new_thread->base.budget_timeout);
 #endif
 	new_thread->resource_pool = _current->resource_pool;
 	sys_trace_thread_create(new_thread);
@@ -777,6 +785,9 @@ void z_init_static_threads(void)
 	k_sched_lock();
 	_FOREACH_STATIC_THREAD(thread_data) {
 		if (thread_data->init_delay != K_TICKS_FOREVER) {
+#ifdef CONFIG_BOOT_PROFILER
+			z_boot_prof_thread_start(thread_data);
+#endif
 			schedule_new_thread(thread_data->init_thread,
 					    K_MSEC(thread_data->init_delay));
 		}
@@ -1028,10 +1039,14 @@ void z_thread_mark_switched_in(void)
 	sys_trace_thread_switched_in();
 #endif
 
+#ifdef CONFIG_BOOT_PROFILER
+	z_boot_prof_switched_in(_current);
+#endif
+
 #ifdef CONFIG_THREAD_RUNTIME_STATS
 	struct k_thread *thread;
 
-	thread = k_current_get();
+	thread = _current;
 #ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
 	thread->rt_stats.last_switched_in = timing_counter_get();
 #else
@@ -1053,7 +1068,7 @@ void z_thread_mark_switched_out(void)
 	uint64_t diff;
 	struct k_thread *thread;
 
-	thread = k_current_get();
+	thread = _current;
 
 	if (unlikely(thread->rt_stats.last_switched_in == 0)) {
 		/* Has not run before */
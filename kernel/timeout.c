@@ -14,7 +14,20 @@
 
 static uint64_t curr_tick;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+static bool timeout_lessthan(struct rbnode *a, struct rbnode *b);
+
+static struct rbtree timeout_tree = {
+	.lessthan_fn = timeout_lessthan,
+};
+
+/* Monotonic insertion counter, used to keep timeouts which expire on
+ * the same tick in FIFO order.  Zero is reserved for "not queued".
+ */
+static uint32_t timeout_seq;
+#else
 static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+#endif
 
 static struct k_spinlock timeout_lock;
 
@@ -24,6 +37,10 @@ static struct k_spinlock timeout_lock;
 /* Cycles left to process in the currently-executing sys_clock_announce() */
 static int announce_remaining;
 
+#ifdef CONFIG_TIMEOUT_SLACK
+static struct k_timer_slack_stats slack_stats;
+#endif
+
 #if defined(CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME)
 int z_clock_hw_cycles_per_sec = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
 
@@ -36,6 +53,79 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_USER_TIME_PAGE
+union z_time_page_storage z_time_page __aligned(Z_TIME_PAGE_SIZE) = {
+	.page = {
+		.hw_cycles_per_sec = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC,
+	},
+};
+
+K_MEM_PARTITION_DEFINE(z_time_page_partition, &z_time_page,
+		       sizeof(z_time_page), K_MEM_PARTITION_P_RW_U_RO);
+
+/* Publish curr_tick, with timeout_lock held */
+static void time_page_update(void)
+{
+	struct z_time_page *page = &z_time_page.page;
+
+	(void)atomic_inc(&page->seq);
+	(void)atomic_set(&page->ticks_lo, (atomic_val_t)(uint32_t)curr_tick);
+	(void)atomic_set(&page->ticks_hi,
+			 (atomic_val_t)(uint32_t)(curr_tick >> 32));
+	(void)atomic_inc(&page->seq);
+}
+#else
+static inline void time_page_update(void)
+{
+}
+#endif /* CONFIG_USER_TIME_PAGE */
+
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+static bool timeout_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	struct _timeout *ta = CONTAINER_OF(a, struct _timeout, node);
+	struct _timeout *tb = CONTAINER_OF(b, struct _timeout, node);
+
+	if (ta->dticks != tb->dticks) {
+		return ta->dticks < tb->dticks;
+	}
+
+	return (int32_t)(ta->seq - tb->seq) < 0;
+}
+
+static struct _timeout *first(void)
+{
+	struct rbnode *n = rb_get_min(&timeout_tree);
+
+	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
+}
+
+/* Ticks from curr_tick until the (queued) timeout expires */
+static k_ticks_t timeout_ticks(struct _timeout *t)
+{
+	return t->dticks - (int64_t)curr_tick;
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	rb_remove(&timeout_tree, &t->node);
+	t->seq = 0U;
+}
+
+/* must be locked */
+static void insert_timeout(struct _timeout *to, k_ticks_t ticks)
+{
+	to->dticks = curr_tick + ticks;
+
+	timeout_seq++;
+	if (timeout_seq == 0U) {
+		timeout_seq++;
+	}
+	to->seq = timeout_seq;
+
+	rb_insert(&timeout_tree, &to->node);
+}
+#else
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -50,6 +140,11 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+static k_ticks_t timeout_ticks(struct _timeout *t)
+{
+	return t->dticks;
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -59,6 +154,99 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+/* must be locked */
+static void insert_timeout(struct _timeout *to, k_ticks_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+#endif /* CONFIG_TIMEOUT_QUEUE_SCALABLE */
+
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Finds the expiry (in ticks from curr_tick) of a queued timeout
+ * falling within [lo, hi], stored in @expiry.  Returns false if there
+ * is none; k_ticks_t may be unsigned.  The dumb backend
+ * finds the earliest such expiry.  The scalable one only checks the
+ * next expiry to stay O(log n): slack timeouts still meet on the
+ * tick boundaries chosen by slack_adjust().
+ *
+ * must be locked
+ */
+static bool queued_expiry_within(k_ticks_t lo, k_ticks_t hi,
+				 k_ticks_t *expiry)
+{
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	struct _timeout *t = first();
+
+	if (t != NULL && timeout_ticks(t) >= lo && timeout_ticks(t) <= hi) {
+		*expiry = timeout_ticks(t);
+		return true;
+	}
+#else
+	k_ticks_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (ticks >= lo) {
+			*expiry = ticks;
+			return ticks <= hi;
+		}
+	}
+#endif
+	return false;
+}
+
+/* Defers a timeout expiring in @ticks by at most its slack, onto an
+ * expiry that is already queued if possible.  Otherwise it is rounded
+ * down from the end of its window to a multiple of the largest power
+ * of two not exceeding the slack, in absolute ticks, so unrelated
+ * slack timeouts tend to land on the same tick.
+ *
+ * must be locked
+ */
+static k_ticks_t slack_adjust(struct _timeout *to, k_ticks_t ticks)
+{
+	k_ticks_t latest = ticks + to->slack;
+	k_ticks_t target;
+	uint64_t gran, end;
+
+	if (queued_expiry_within(ticks, latest, &target)) {
+		slack_stats.coalesced++;
+		return target;
+	}
+
+	/* In 64 bits, so that a slack of UINT32_MAX does not wrap to 0 */
+	gran = BIT64(63 - __builtin_clzll((uint64_t)to->slack + 1U));
+	end = curr_tick + latest;
+	target = (k_ticks_t)(end - (end % gran) - curr_tick);
+
+	if (target != ticks) {
+		slack_stats.aligned++;
+	}
+	return target;
+}
+
+void k_timer_slack_stats_get(struct k_timer_slack_stats *stats)
+{
+	LOCKED(&timeout_lock) {
+		*stats = slack_stats;
+	}
+}
+#endif /* CONFIG_TIMEOUT_SLACK */
+
 static int32_t elapsed(void)
 {
 	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
@@ -69,7 +257,7 @@ static int32_t next_timeout(void)
 	struct _timeout *to = first();
 	int32_t ticks_elapsed = elapsed();
 	int32_t ret = to == NULL ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT);
+		: CLAMP(timeout_ticks(to) - ticks_elapsed, 0, MAX_WAIT);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -96,26 +284,18 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 		ticks = Z_TICK_ABS(timeout.ticks) - (curr_tick + elapsed());
 	}
 
-	__ASSERT(!sys_dnode_is_linked(&to->node), "");
+	__ASSERT(z_is_inactive_timeout(to), "");
 	to->fn = fn;
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
+		ticks += elapsed();
+#ifdef CONFIG_TIMEOUT_SLACK
+		if (to->slack != 0U) {
+			ticks = slack_adjust(to, ticks);
 		}
+#endif
+		insert_timeout(to, ticks);
 
 		if (to == first()) {
 #if CONFIG_TIMESLICING
@@ -145,7 +325,7 @@ int z_abort_timeout(struct _timeout *to)
 	int ret = -EINVAL;
 
 	LOCKED(&timeout_lock) {
-		if (sys_dnode_is_linked(&to->node)) {
+		if (!z_is_inactive_timeout(to)) {
 			remove_timeout(to);
 			ret = 0;
 		}
@@ -163,12 +343,16 @@ static k_ticks_t timeout_rem(const struct _timeout *timeout)
 		return 0;
 	}
 
+#ifdef CONFIG_TIMEOUT_QUEUE_SCALABLE
+	ticks = timeout->dticks - (int64_t)curr_tick;
+#else
 	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
 		ticks += t->dticks;
 		if (timeout == t) {
 			break;
 		}
 	}
+#endif
 
 	return ticks - elapsed();
 }
@@ -236,16 +420,31 @@ void sys_clock_announce(int32_t ticks)
 #endif
 
 	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
+#ifdef CONFIG_TIMEOUT_SLACK
+	bool expired_any = false;
+#endif
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
+	while (first() != NULL && timeout_ticks(first()) <= announce_remaining) {
 		struct _timeout *t = first();
-		int dt = t->dticks;
+		int dt = MAX(0, timeout_ticks(t));
+
+#ifdef CONFIG_TIMEOUT_SLACK
+		/* Each distinct expiry tick is one wakeup */
+		if (dt != 0 || !expired_any) {
+			slack_stats.wakeups++;
+			expired_any = true;
+		}
+		slack_stats.expired++;
+#endif
 
 		curr_tick += dt;
 		announce_remaining -= dt;
+		time_page_update();
+#ifndef CONFIG_TIMEOUT_QUEUE_SCALABLE
 		t->dticks = 0;
+#endif
 		remove_timeout(t);
 
 		k_spin_unlock(&timeout_lock, key);
@@ -253,12 +452,15 @@ void sys_clock_announce(int32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
+#ifndef CONFIG_TIMEOUT_QUEUE_SCALABLE
 	if (first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
+	time_page_update();
 
 	sys_clock_set_timeout(next_timeout(), false);
 
@@ -284,17 +486,17 @@ uint32_t sys_clock_tick_get_32(void)
 #endif
 }
 
-int64_t z_impl_k_uptime_ticks(void)
+int64_t z_impl_z_uptime_ticks(void)
 {
 	return sys_clock_tick_get();
 }
 
 #ifdef CONFIG_USERSPACE
-static inline int64_t z_vrfy_k_uptime_ticks(void)
+static inline int64_t z_vrfy_z_uptime_ticks(void)
 {
-	return z_impl_k_uptime_ticks();
+	return z_impl_z_uptime_ticks();
 }
-#include <syscalls/k_uptime_ticks_mrsh.c>
+#include <syscalls/z_uptime_ticks_mrsh.c>
 #endif
 
 /* Returns the uptime expiration (relative to an unlocked "now"!) of a
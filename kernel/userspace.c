@@ -349,6 +349,9 @@ void *z_impl_k_object_alloc(enum k_objects otype)
 	case K_OBJ_SYS_MUTEX:			/* Lives in user memory */
 	case K_OBJ_THREAD_STACK_ELEMENT:	/* No aligned allocator */
 	case K_OBJ_NET_SOCKET:			/* Indeterminate size */
+#ifdef CONFIG_POLL
+	case K_OBJ_POLL_SET:			/* Needs entry storage */
+#endif
 		LOG_ERR("forbidden object type '%s' requested",
 			otype_to_str(otype));
 		return NULL;
@@ -712,7 +715,7 @@ void z_object_recycle(const void *obj)
 
 	if (ko != NULL) {
 		(void)memset(ko->perms, 0, sizeof(ko->perms));
-		z_thread_perms_set(ko, k_current_get());
+		z_thread_perms_set(ko, _current);
 		ko->flags |= K_OBJ_FLAG_INITIALIZED;
 	}
 }
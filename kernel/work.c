@@ -80,6 +80,124 @@ static inline void init_flusher(struct z_work_flusher *flusher)
 /* List of pending cancellations. */
 static sys_slist_t pending_cancels;
 
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+/* List of pending flushes of items on queues with several workers. */
+static sys_slist_t pending_flushes;
+
+/* Whether a queue has workers beyond its own thread. */
+static inline bool queue_is_pooled(const struct k_work_q *queue)
+{
+	return queue->workers != NULL;
+}
+
+/* The workers of a queue are its own thread, represented by NULL, followed
+ * by the additional workers.  Iterate with:
+ *
+ *	w = NULL;
+ *	do {
+ *		...
+ *		w = worker_next(queue, w);
+ *	} while (w != NULL);
+ */
+static inline struct k_work_q_worker *worker_next(struct k_work_q *queue,
+						  struct k_work_q_worker *w)
+{
+	return (w == NULL) ? queue->workers : w->next;
+}
+
+static inline sys_slist_t *worker_pending(struct k_work_q *queue,
+					  struct k_work_q_worker *w)
+{
+	return (w == NULL) ? &queue->pending : &w->pending;
+}
+
+static inline struct k_work **worker_running(struct k_work_q *queue,
+					     struct k_work_q_worker *w)
+{
+	return (w == NULL) ? &queue->running : &w->running;
+}
+
+/* Find the worker of a queue animated by the current thread.
+ *
+ * Invoked with work lock held.
+ *
+ * @param queue the queue
+ * @param workerp set to the worker if found
+ *
+ * @retval true if the current thread is a worker of @p queue
+ */
+static bool current_worker_locked(struct k_work_q *queue,
+				  struct k_work_q_worker **workerp)
+{
+	struct k_work_q_worker *w = NULL;
+
+	if (k_is_in_isr()) {
+		return false;
+	}
+
+	do {
+		if (_current == ((w == NULL) ? &queue->thread : &w->thread)) {
+			*workerp = w;
+			return true;
+		}
+		w = worker_next(queue, w);
+	} while (w != NULL);
+
+	return false;
+}
+
+/* Add a flusher for work on a queue with several workers.
+ *
+ * The flusher completes after the runs of the work item that have been
+ * requested so far: the current one if running, and the queued one if
+ * queued.
+ *
+ * Invoked with work lock held.
+ */
+static void queue_pooled_flusher_locked(struct k_work *work,
+					struct z_work_flusher *flusher)
+{
+	init_flusher(flusher);
+	flusher->target = work;
+	flusher->runs = (flag_test(&work->flags, K_WORK_QUEUED_BIT) ? 1 : 0)
+		+ (flag_test(&work->flags, K_WORK_RUNNING_BIT) ? 1 : 0);
+	sys_slist_append(&pending_flushes, &flusher->work.node);
+}
+
+/* Account a finished run of a work item to pending flushes, and
+ * release the ones that are complete.  Flushes are also complete when
+ * the item went idle without running, e.g. because it was canceled.
+ *
+ * Invoked with work lock held.
+ *
+ * @param work the work item
+ * @param ran true if the item just finished running
+ */
+static void finalize_flush_locked(struct k_work *work, bool ran)
+{
+	struct z_work_flusher *wf, *tmp;
+	sys_snode_t *prev = NULL;
+	bool idle = (flags_get(&work->flags)
+		     & (K_WORK_QUEUED | K_WORK_RUNNING)) == 0U;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&pending_flushes, wf, tmp,
+					  work.node) {
+		if (wf->target == work) {
+			if (ran && (wf->runs > 0U)) {
+				wf->runs--;
+			}
+			if ((wf->runs == 0U) || idle) {
+				sys_slist_remove(&pending_flushes, prev,
+						 &wf->work.node);
+				k_sem_give(&wf->sem);
+				continue;
+			}
+		}
+		prev = &wf->work.node;
+	}
+}
+#endif /* CONFIG_WORK_QUEUE_WORKERS */
+
 /* Initialize a canceler record and add it to the list of pending
  * cancels.
  *
@@ -201,9 +319,84 @@ static inline void queue_remove_locked(struct k_work_q *queue,
 				       struct k_work *work)
 {
 	if (flag_test_and_clear(&work->flags, K_WORK_QUEUED_BIT)) {
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+		struct k_work_q_worker *w = NULL;
+
+		do {
+			if (sys_slist_find_and_remove(worker_pending(queue, w),
+						      &work->node)) {
+				break;
+			}
+			w = worker_next(queue, w);
+		} while (w != NULL);
+#else
 		(void)sys_slist_find_and_remove(&queue->pending, &work->node);
+#endif
+	}
+}
+
+/* Determine whether any work is pending on a queue.
+ *
+ * Invoked with work lock held.
+ */
+static inline bool queue_has_pending_locked(struct k_work_q *queue)
+{
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	struct k_work_q_worker *w = NULL;
+
+	do {
+		if (!sys_slist_is_empty(worker_pending(queue, w))) {
+			return true;
+		}
+		w = worker_next(queue, w);
+	} while (w != NULL);
+
+	return false;
+#else
+	return !sys_slist_is_empty(&queue->pending);
+#endif
+}
+
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+/* Select the pending list of a queue a work item is submitted to.
+ *
+ * An item that is still running goes to the thread running it, and
+ * only that thread takes it (see queue_take_locked()), so an item never
+ * runs concurrently with itself.  An item submitted by a worker stays
+ * with that worker.  Anything else is spread round robin.
+ *
+ * Invoked with work lock held.
+ */
+static sys_slist_t *queue_submit_pending_locked(struct k_work_q *queue,
+						struct k_work *work,
+						bool chained,
+						struct k_work_q_worker *worker)
+{
+	struct k_work_q_worker *w = NULL;
+
+	if (!queue_is_pooled(queue)) {
+		return &queue->pending;
+	}
+
+	if (flag_test(&work->flags, K_WORK_RUNNING_BIT)) {
+		do {
+			if (*worker_running(queue, w) == work) {
+				return worker_pending(queue, w);
+			}
+			w = worker_next(queue, w);
+		} while (w != NULL);
+	}
+
+	if (chained) {
+		return worker_pending(queue, worker);
 	}
+
+	w = queue->next_worker;
+	queue->next_worker = worker_next(queue, w);
+
+	return worker_pending(queue, w);
 }
+#endif /* CONFIG_WORK_QUEUE_WORKERS */
 
 /* Potentially notify a queue that it needs to look for pending work.
  *
@@ -254,7 +447,12 @@ static inline int queue_submit_locked(struct k_work_q *queue,
 	}
 
 	int ret = -EBUSY;
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	struct k_work_q_worker *worker = NULL;
+	bool chained = current_worker_locked(queue, &worker);
+#else
 	bool chained = (_current == &queue->thread) && !k_is_in_isr();
+#endif
 	bool draining = flag_test(&queue->flags, K_WORK_QUEUE_DRAIN_BIT);
 	bool plugged = flag_test(&queue->flags, K_WORK_QUEUE_PLUGGED_BIT);
 
@@ -272,7 +470,13 @@ static inline int queue_submit_locked(struct k_work_q *queue,
 	} else if (plugged && !draining) {
 		ret = -EBUSY;
 	} else {
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+		sys_slist_append(queue_submit_pending_locked(queue, work,
+							     chained, worker),
+				 &work->node);
+#else
 		sys_slist_append(&queue->pending, &work->node);
+#endif
 		ret = 1;
 		(void)notify_queue_locked(queue);
 	}
@@ -402,6 +606,13 @@ static bool work_flush_locked(struct k_work *work,
 
 		__ASSERT_NO_MSG(queue != NULL);
 
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+		if (queue_is_pooled(queue)) {
+			queue_pooled_flusher_locked(work, flusher);
+			return need_flush;
+		}
+#endif
+
 		queue_flusher_locked(queue, work, flusher);
 		notify_queue_locked(queue);
 	}
@@ -452,6 +663,9 @@ static int cancel_async_locked(struct k_work *work)
 	if (!flag_test(&work->flags, K_WORK_CANCELING_BIT)) {
 		/* Remove it from the queue, if it's queued. */
 		queue_remove_locked(work->queue, work);
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+		finalize_flush_locked(work, false);
+#endif
 	}
 
 	/* If it's still busy after it's been dequeued, then flag it
@@ -579,6 +793,9 @@ static inline bool work_set_running(struct k_work *work,
 		 * cancellation now.
 		 */
 		finalize_cancel_locked(work);
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+		finalize_flush_locked(work, false);
+#endif
 	}
 
 	k_spin_unlock(&lock, key);
@@ -608,33 +825,130 @@ static inline void work_clear_running(struct k_work *work)
 		finalize_cancel_locked(work);
 	}
 
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	if (!sys_slist_is_empty(&pending_flushes)) {
+		finalize_flush_locked(work, true);
+	}
+#endif
+
 	k_spin_unlock(&lock, key);
 }
 
+/* Take the next work item for a work queue thread.
+ *
+ * A thread first takes from its own pending list.  If that is empty it
+ * steals the oldest item from the list of another worker, skipping items
+ * that are still running: those wait for the thread running them.
+ *
+ * Invoked with work lock held.
+ *
+ * @param queue the queue
+ * @param worker the worker taking, NULL for the queue thread
+ *
+ * @return the work item, or NULL if there is nothing to do
+ */
+static struct k_work *queue_take_locked(struct k_work_q *queue,
+					struct k_work_q_worker *worker)
+{
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	sys_snode_t *node = sys_slist_get(worker_pending(queue, worker));
+	struct k_work_q_worker *w = NULL;
+
+	if (node != NULL) {
+		return CONTAINER_OF(node, struct k_work, node);
+	}
+
+	do {
+		sys_slist_t *pending = worker_pending(queue, w);
+		sys_snode_t *prev = NULL;
+		struct k_work *wn;
+
+		if (w == worker) {
+			w = worker_next(queue, w);
+			continue;
+		}
+
+		SYS_SLIST_FOR_EACH_CONTAINER(pending, wn, node) {
+			if (!flag_test(&wn->flags, K_WORK_RUNNING_BIT)) {
+				sys_slist_remove(pending, prev, &wn->node);
+				return wn;
+			}
+			prev = &wn->node;
+		}
+		w = worker_next(queue, w);
+	} while (w != NULL);
+
+	return NULL;
+#else
+	sys_snode_t *node = sys_slist_get(&queue->pending);
+
+	ARG_UNUSED(worker);
+
+	return (node != NULL) ? CONTAINER_OF(node, struct k_work, node) : NULL;
+#endif
+}
+
+/* Record that a work queue thread started or finished processing an item.
+ *
+ * Invoked with work lock held.
+ *
+ * @param queue the queue
+ * @param worker the worker, NULL for the queue thread
+ * @param work the item started, NULL when finished
+ */
+static inline void queue_set_running_locked(struct k_work_q *queue,
+					    struct k_work_q_worker *worker,
+					    struct k_work *work)
+{
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	*worker_running(queue, worker) = work;
+	if (work != NULL) {
+		queue->busy++;
+	} else {
+		queue->busy--;
+	}
+	if (queue->busy != 0U) {
+		flag_set(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+	} else {
+		flag_clear(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+	}
+#else
+	ARG_UNUSED(worker);
+
+	if (work != NULL) {
+		flag_set(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+	} else {
+		flag_clear(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+	}
+#endif
+}
+
 /* Loop executed by a work queue thread.
  *
  * @param workq_ptr pointer to the work queue structure
+ * @param worker_ptr pointer to the worker structure, NULL for the queue
+ * thread
  */
-static void work_queue_main(void *workq_ptr, void *p2, void *p3)
+static void work_queue_main(void *workq_ptr, void *worker_ptr, void *p3)
 {
 	struct k_work_q *queue = (struct k_work_q *)workq_ptr;
+	struct k_work_q_worker *worker = worker_ptr;
 
 	while (true) {
-		sys_snode_t *node;
 		struct k_work *work = NULL;
 		k_spinlock_key_t key = k_spin_lock(&lock);
 
 		/* Clear the record of processing any previous work, and check
 		 * for new work.
 		 */
-		node = sys_slist_get(&queue->pending);
-		if (node != NULL) {
+		work = queue_take_locked(queue, worker);
+		if (work != NULL) {
 			/* Mark that there's some work active that's
 			 * not on the pending list.
 			 */
-			flag_set(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
-			work = CONTAINER_OF(node, struct k_work, node);
-		} else if (flag_test_and_clear(&queue->flags,
+			queue_set_running_locked(queue, worker, work);
+		} else if (!flag_test(&queue->flags, K_WORK_QUEUE_BUSY_BIT) &&
+			   flag_test_and_clear(&queue->flags,
 					       K_WORK_QUEUE_DRAIN_BIT)) {
 			/* Not busy and draining: move threads waiting for
 			 * drain to ready state.  The held spinlock inhibits
@@ -678,7 +992,7 @@ static void work_queue_main(void *workq_ptr, void *p2, void *p3)
 			 * threads.
 			 */
 			key = k_spin_lock(&lock);
-			flag_clear(&queue->flags, K_WORK_QUEUE_BUSY_BIT);
+			queue_set_running_locked(queue, worker, NULL);
 			yield = !flag_test(&queue->flags, K_WORK_QUEUE_NO_YIELD_BIT);
 			k_spin_unlock(&lock, key);
 
@@ -706,6 +1020,12 @@ void k_work_queue_start(struct k_work_q *queue,
 	sys_slist_init(&queue->pending);
 	z_waitq_init(&queue->notifyq);
 	z_waitq_init(&queue->drainq);
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+	queue->running = NULL;
+	queue->workers = NULL;
+	queue->next_worker = NULL;
+	queue->busy = 0U;
+#endif
 
 	if ((cfg != NULL) && cfg->no_yield) {
 		flags |= K_WORK_QUEUE_NO_YIELD;
@@ -728,6 +1048,54 @@ void k_work_queue_start(struct k_work_q *queue,
 	k_thread_start(&queue->thread);
 }
 
+#ifdef CONFIG_WORK_QUEUE_WORKERS
+int k_work_queue_add_worker(struct k_work_q *queue,
+			    struct k_work_q_worker *worker,
+			    k_thread_stack_t *stack, size_t stack_size,
+			    int prio, int cpu)
+{
+	__ASSERT_NO_MSG(queue);
+	__ASSERT_NO_MSG(worker);
+	__ASSERT_NO_MSG(stack);
+	__ASSERT_NO_MSG(flag_test(&queue->flags, K_WORK_QUEUE_STARTED_BIT));
+
+	if ((cpu >= CONFIG_MP_NUM_CPUS) ||
+	    ((cpu >= 0) && !IS_ENABLED(CONFIG_SCHED_CPU_MASK))) {
+		return -EINVAL;
+	}
+
+	worker->queue = queue;
+	worker->running = NULL;
+	sys_slist_init(&worker->pending);
+
+	(void)k_thread_create(&worker->thread, stack, stack_size,
+			      work_queue_main, queue, worker, NULL,
+			      prio, 0, K_FOREVER);
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if (cpu >= 0) {
+		(void)k_thread_cpu_mask_clear(&worker->thread);
+		(void)k_thread_cpu_mask_enable(&worker->thread, cpu);
+	}
+#endif
+
+#ifdef CONFIG_THREAD_NAME
+	k_thread_name_set(&worker->thread, k_thread_name_get(&queue->thread));
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	worker->next = queue->workers;
+	queue->workers = worker;
+
+	k_spin_unlock(&lock, key);
+
+	k_thread_start(&worker->thread);
+
+	return 0;
+}
+#endif /* CONFIG_WORK_QUEUE_WORKERS */
+
 int k_work_queue_drain(struct k_work_q *queue,
 		       bool plug)
 {
@@ -740,7 +1108,7 @@ int k_work_queue_drain(struct k_work_q *queue,
 	if (((flags_get(&queue->flags)
 	      & (K_WORK_QUEUE_BUSY | K_WORK_QUEUE_DRAIN)) != 0U)
 	    || plug
-	    || !sys_slist_is_empty(&queue->pending)) {
+	    || queue_has_pending_locked(queue)) {
 		flag_set(&queue->flags, K_WORK_QUEUE_DRAIN_BIT);
 		if (plug) {
 			flag_set(&queue->flags, K_WORK_QUEUE_PLUGGED_BIT);
@@ -819,6 +1187,20 @@ void k_work_init_delayable(struct k_work_delayable *dwork,
 	(void)work_timeout;
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+void k_work_delayable_slack_set(struct k_work_delayable *dwork,
+				k_timeout_t slack)
+{
+	__ASSERT_NO_MSG(dwork != NULL);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	z_set_timeout_slack(&dwork->timeout, slack);
+
+	k_spin_unlock(&lock, key);
+}
+#endif
+
 static inline int work_delayable_busy_get_locked(const struct k_work_delayable *dwork)
 {
 	return atomic_get(&dwork->work.flags) & K_WORK_MASK;
@@ -13,6 +13,8 @@
 #include <app_memory/app_memdomain.h>
 #include <sys/mutex.h>
 #include <sys/sys_heap.h>
+#include <sys/libc-hooks.h>
+#include <debug/heap_profiler.h>
 #include <zephyr/types.h>
 
 #define LOG_LEVEL CONFIG_KERNEL_LOG_LEVEL
@@ -31,25 +33,133 @@ K_APPMEM_PARTITION_DEFINE(z_malloc_partition);
 
 #define HEAP_BYTES CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE
 
-Z_GENERIC_SECTION(POOL_SECTION) static struct sys_heap z_malloc_heap;
-Z_GENERIC_SECTION(POOL_SECTION) struct sys_mutex z_malloc_heap_mutex;
+/* The arena memory is split into NUM_ARENAS independently locked
+ * sys_heaps, so that threads allocating concurrently don't all
+ * serialize on one mutex.  Together they never use more than
+ * HEAP_BYTES.  The last arena absorbs the division remainder.
+ */
+#define NUM_ARENAS CONFIG_MINIMAL_LIBC_MALLOC_ARENAS
+#define ARENA_BYTES (HEAP_BYTES / NUM_ARENAS)
+
+Z_GENERIC_SECTION(POOL_SECTION) static struct sys_heap z_malloc_heap[NUM_ARENAS];
+Z_GENERIC_SECTION(POOL_SECTION) struct sys_mutex z_malloc_heap_mutex[NUM_ARENAS];
 Z_GENERIC_SECTION(POOL_SECTION) static char z_malloc_heap_mem[HEAP_BYTES];
 
-void *malloc(size_t size)
+#if (NUM_ARENAS > 1) && defined(CONFIG_THREAD_LOCAL_STORAGE)
+/* Arena (plus one) this thread last allocated from */
+static __thread uint8_t arena_hint;
+#endif
+
+static int arena_preferred(void)
+{
+#if (NUM_ARENAS > 1)
+	uintptr_t id;
+
+#ifdef CONFIG_THREAD_LOCAL_STORAGE
+	if (arena_hint != 0U) {
+		return arena_hint - 1;
+	}
+
+	/* The address of a thread local variable identifies the thread
+	 * without the system call k_current_get() may be in user mode.
+	 */
+	id = (uintptr_t)&arena_hint / sizeof(void *);
+#else
+	id = (uintptr_t)k_current_get() / sizeof(void *);
+#endif
+
+	/* Spread threads over the arenas by thread identity */
+	return (int)(((id * 2654435761U) >> 16) % NUM_ARENAS);
+#else
+	return 0;
+#endif
+}
+
+static void arena_remember(int arena)
+{
+#if (NUM_ARENAS > 1) && defined(CONFIG_THREAD_LOCAL_STORAGE)
+	arena_hint = arena + 1;
+#else
+	ARG_UNUSED(arena);
+#endif
+}
+
+static void arena_lock(int arena)
 {
 	int lock_ret;
 
-	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex[arena], K_FOREVER);
 	__ASSERT_NO_MSG(lock_ret == 0);
+}
+
+static void arena_unlock(int arena)
+{
+	(void) sys_mutex_unlock(&z_malloc_heap_mutex[arena]);
+}
+
+/* Locks and returns an arena for allocation: the preferred one if it
+ * is free, else the first uncontended one, else waits for the
+ * preferred one.
+ */
+static int arena_lock_any(void)
+{
+	int first = arena_preferred();
+
+#if (NUM_ARENAS > 1)
+	for (int i = 0; i < NUM_ARENAS; i++) {
+		int arena = (first + i) % NUM_ARENAS;
+
+		if (sys_mutex_lock(&z_malloc_heap_mutex[arena],
+				   K_NO_WAIT) == 0) {
+			return arena;
+		}
+	}
+#endif
 
-	void *ret = sys_heap_aligned_alloc(&z_malloc_heap,
+	arena_lock(first);
+	return first;
+}
+
+static int arena_of(void *ptr)
+{
+	int arena = ((char *)ptr - z_malloc_heap_mem) / ARENA_BYTES;
+
+	return MIN(arena, NUM_ARENAS - 1);
+}
+
+void *malloc(size_t size)
+{
+	Z_HEAP_PROF_SITE_ENTER();
+
+	int arena = arena_lock_any();
+	void *ret = sys_heap_aligned_alloc(&z_malloc_heap[arena],
 					   __alignof__(z_max_align_t),
 					   size);
-	if (ret == NULL && size != 0) {
+
+	arena_unlock(arena);
+
+	/* That arena is full: try all the others before giving up */
+	for (int i = 1; ret == NULL && size != 0 && i < NUM_ARENAS; i++) {
+		int next = (arena + i) % NUM_ARENAS;
+
+		arena_lock(next);
+		ret = sys_heap_aligned_alloc(&z_malloc_heap[next],
+					     __alignof__(z_max_align_t),
+					     size);
+		arena_unlock(next);
+
+		if (ret != NULL) {
+			arena = next;
+		}
+	}
+
+	if (ret != NULL) {
+		arena_remember(arena);
+	} else if (size != 0) {
 		errno = ENOMEM;
 	}
 
-	(void) sys_mutex_unlock(&z_malloc_heap_mutex);
+	Z_HEAP_PROF_SITE_EXIT();
 
 	return ret;
 }
@@ -58,40 +168,112 @@ static int malloc_prepare(const struct device *unused)
 {
 	ARG_UNUSED(unused);
 
-	sys_heap_init(&z_malloc_heap, z_malloc_heap_mem, HEAP_BYTES);
-	sys_mutex_init(&z_malloc_heap_mutex);
+	for (int i = 0; i < NUM_ARENAS; i++) {
+		size_t bytes = (i == NUM_ARENAS - 1) ?
+			HEAP_BYTES - i * ARENA_BYTES : ARENA_BYTES;
+
+		sys_heap_init(&z_malloc_heap[i],
+			      &z_malloc_heap_mem[i * ARENA_BYTES], bytes);
+		sys_mutex_init(&z_malloc_heap_mutex[i]);
+	}
 
 	return 0;
 }
 
-void *realloc(void *ptr, size_t requested_size)
+static void *arena_realloc(void *ptr, size_t requested_size)
 {
-	int lock_ret;
+	int arena;
+	void *ret;
 
-	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
-	__ASSERT_NO_MSG(lock_ret == 0);
+	if (ptr == NULL) {
+		return malloc(requested_size);
+	}
 
-	void *ret = sys_heap_aligned_realloc(&z_malloc_heap, ptr,
-					     __alignof__(z_max_align_t),
-					     requested_size);
+	arena = arena_of(ptr);
+	arena_lock(arena);
+
+	ret = sys_heap_aligned_realloc(&z_malloc_heap[arena], ptr,
+				       __alignof__(z_max_align_t),
+				       requested_size);
+
+#if (NUM_ARENAS > 1)
+	/* Doesn't fit in its own arena any more: move it */
+	if (ret == NULL && requested_size != 0) {
+		size_t old_size = sys_heap_usable_size(&z_malloc_heap[arena],
+						       ptr);
+
+		arena_unlock(arena);
+		ret = malloc(requested_size);
+		if (ret != NULL) {
+			memcpy(ret, ptr, MIN(old_size, requested_size));
+			free(ptr);
+		}
+		return ret;
+	}
+#endif
 
 	if (ret == NULL && requested_size != 0) {
 		errno = ENOMEM;
 	}
 
-	(void) sys_mutex_unlock(&z_malloc_heap_mutex);
+	arena_unlock(arena);
+
+	return ret;
+}
+
+void *realloc(void *ptr, size_t requested_size)
+{
+	void *ret;
+
+	Z_HEAP_PROF_SITE_ENTER();
+	ret = arena_realloc(ptr, requested_size);
+	Z_HEAP_PROF_SITE_EXIT();
 
 	return ret;
 }
 
 void free(void *ptr)
 {
-	int lock_ret;
+	int arena;
 
-	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
-	__ASSERT_NO_MSG(lock_ret == 0);
-	sys_heap_free(&z_malloc_heap, ptr);
-	(void) sys_mutex_unlock(&z_malloc_heap_mutex);
+	if (ptr == NULL) {
+		return;
+	}
+
+	arena = arena_of(ptr);
+	arena_lock(arena);
+	sys_heap_free(&z_malloc_heap[arena], ptr);
+	arena_unlock(arena);
+}
+
+/* Sums over the arenas.  max_allocated_bytes is the sum of the
+ * per-arena peaks, so an upper bound of the overall one.
+ */
+int malloc_runtime_stats_get(struct sys_heap_runtime_stats *stats)
+{
+	struct sys_heap_runtime_stats arena_stats;
+
+	(void)memset(stats, 0, sizeof(*stats));
+
+	for (int i = 0; i < NUM_ARENAS; i++) {
+		arena_lock(i);
+		sys_heap_runtime_stats_get(&z_malloc_heap[i], &arena_stats);
+		arena_unlock(i);
+
+		stats->allocated_bytes += arena_stats.allocated_bytes;
+		stats->free_bytes += arena_stats.free_bytes;
+		stats->max_allocated_bytes += arena_stats.max_allocated_bytes;
+		stats->largest_free_bytes = MAX(stats->largest_free_bytes,
+						arena_stats.largest_free_bytes);
+		stats->num_buckets = MAX(stats->num_buckets,
+					 arena_stats.num_buckets);
+		for (int b = 0; b < arena_stats.num_buckets; b++) {
+			stats->bucket_free_chunks[b] +=
+				arena_stats.bucket_free_chunks[b];
+		}
+	}
+
+	return 0;
 }
 
 SYS_INIT(malloc_prepare, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -116,6 +298,12 @@ void *realloc(void *ptr, size_t size)
 	ARG_UNUSED(ptr);
 	return malloc(size);
 }
+
+int malloc_runtime_stats_get(struct sys_heap_runtime_stats *stats)
+{
+	ARG_UNUSED(stats);
+	return -ENOMEM;
+}
 #endif
 
 #endif /* CONFIG_MINIMAL_LIBC_MALLOC */
@@ -130,7 +318,9 @@ void *calloc(size_t nmemb, size_t size)
 		return NULL;
 	}
 
+	Z_HEAP_PROF_SITE_ENTER();
 	ret = malloc(size);
+	Z_HEAP_PROF_SITE_EXIT();
 
 	if (ret != NULL) {
 		(void)memset(ret, 0, size);
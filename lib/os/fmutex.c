@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/fmutex.h>
+
+#ifdef CONFIG_USERSPACE
+#define SYS_FMUTEX_UNLOCKED  0
+#define SYS_FMUTEX_LOCKED    1
+#define SYS_FMUTEX_CONTENDED 2
+
+int sys_fmutex_init(struct sys_fmutex *mutex)
+{
+	atomic_set(&mutex->futex.val, SYS_FMUTEX_UNLOCKED);
+	mutex->owner = NULL;
+	mutex->lock_count = 0U;
+
+	return 0;
+}
+
+int sys_fmutex_lock(struct sys_fmutex *mutex, k_timeout_t timeout)
+{
+	k_tid_t self = k_current_get();
+	int ret;
+
+	if (atomic_cas(&mutex->futex.val, SYS_FMUTEX_UNLOCKED,
+		       SYS_FMUTEX_LOCKED)) {
+		goto locked;
+	}
+
+	/* Only we can have stored ourselves as the owner */
+	if (mutex->owner == self) {
+		mutex->lock_count++;
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return -EBUSY;
+	}
+
+	/* Once we have waited, others may be waiting too, so keep the mutex
+	 * marked contended even if we get it
+	 */
+	while (atomic_set(&mutex->futex.val, SYS_FMUTEX_CONTENDED) !=
+	       SYS_FMUTEX_UNLOCKED) {
+		ret = k_futex_wait(&mutex->futex, SYS_FMUTEX_CONTENDED,
+				   timeout);
+		if (ret == -ETIMEDOUT) {
+			return -EAGAIN;
+		} else if ((ret != 0) && (ret != -EAGAIN)) {
+			return ret;
+		}
+	}
+
+locked:
+	mutex->owner = self;
+	mutex->lock_count = 1U;
+
+	return 0;
+}
+
+int sys_fmutex_unlock(struct sys_fmutex *mutex)
+{
+	if (mutex->owner != k_current_get()) {
+		return (atomic_get(&mutex->futex.val) == SYS_FMUTEX_UNLOCKED) ?
+			-EINVAL : -EPERM;
+	}
+
+	if (mutex->lock_count > 1U) {
+		mutex->lock_count--;
+		return 0;
+	}
+
+	mutex->lock_count = 0U;
+	mutex->owner = NULL;
+
+	if (atomic_dec(&mutex->futex.val) != SYS_FMUTEX_LOCKED) {
+		atomic_set(&mutex->futex.val, SYS_FMUTEX_UNLOCKED);
+		return MIN(k_futex_wake(&mutex->futex, false), 0);
+	}
+
+	return 0;
+}
+
+int sys_fcondvar_init(struct sys_fcondvar *condvar)
+{
+	atomic_set(&condvar->futex.val, 0);
+	atomic_set(&condvar->waiters, 0);
+
+	return 0;
+}
+
+static int wake(struct sys_fcondvar *condvar, bool wake_all)
+{
+	(void)atomic_inc(&condvar->futex.val);
+
+	if (atomic_get(&condvar->waiters) == 0) {
+		return 0;
+	}
+
+	return MIN(k_futex_wake(&condvar->futex, wake_all), 0);
+}
+
+int sys_fcondvar_signal(struct sys_fcondvar *condvar)
+{
+	return wake(condvar, false);
+}
+
+int sys_fcondvar_broadcast(struct sys_fcondvar *condvar)
+{
+	return wake(condvar, true);
+}
+
+int sys_fcondvar_wait(struct sys_fcondvar *condvar, struct sys_fmutex *mutex,
+		      k_timeout_t timeout)
+{
+	atomic_val_t seq = atomic_get(&condvar->futex.val);
+	uint32_t lock_count;
+	int ret;
+
+	if (mutex->owner != k_current_get()) {
+		return -EPERM;
+	}
+
+	/* A signal after this is seen either by us, in the sequence number,
+	 * or by the signaling thread, in the waiter count
+	 */
+	(void)atomic_inc(&condvar->waiters);
+
+	lock_count = mutex->lock_count;
+	mutex->lock_count = 1U;
+	(void)sys_fmutex_unlock(mutex);
+
+	ret = k_futex_wait(&condvar->futex, (int)seq, timeout);
+
+	(void)atomic_dec(&condvar->waiters);
+	(void)sys_fmutex_lock(mutex, K_FOREVER);
+	mutex->lock_count = lock_count;
+
+	if (ret == -ETIMEDOUT) {
+		return -EAGAIN;
+	}
+
+	/* -EAGAIN here means we were signaled before we could wait */
+	return ((ret == 0) || (ret == -EAGAIN)) ? 0 : ret;
+}
+#else
+int sys_fmutex_init(struct sys_fmutex *mutex)
+{
+	return k_mutex_init(&mutex->kernel_mutex);
+}
+
+int sys_fmutex_lock(struct sys_fmutex *mutex, k_timeout_t timeout)
+{
+	return k_mutex_lock(&mutex->kernel_mutex, timeout);
+}
+
+int sys_fmutex_unlock(struct sys_fmutex *mutex)
+{
+	return k_mutex_unlock(&mutex->kernel_mutex);
+}
+
+int sys_fcondvar_init(struct sys_fcondvar *condvar)
+{
+	return k_condvar_init(&condvar->kernel_condvar);
+}
+
+int sys_fcondvar_signal(struct sys_fcondvar *condvar)
+{
+	return k_condvar_signal(&condvar->kernel_condvar);
+}
+
+int sys_fcondvar_broadcast(struct sys_fcondvar *condvar)
+{
+	(void)k_condvar_broadcast(&condvar->kernel_condvar);
+
+	return 0;
+}
+
+int sys_fcondvar_wait(struct sys_fcondvar *condvar, struct sys_fmutex *mutex,
+		      k_timeout_t timeout)
+{
+	struct k_mutex *kernel_mutex = &mutex->kernel_mutex;
+	uint32_t lock_count;
+	int ret;
+
+	if (kernel_mutex->owner != k_current_get()) {
+		return -EPERM;
+	}
+
+	/* k_condvar_wait() releases the mutex once, whatever its count */
+	lock_count = kernel_mutex->lock_count;
+	kernel_mutex->lock_count = 1U;
+	ret = k_condvar_wait(&condvar->kernel_condvar, kernel_mutex, timeout);
+	kernel_mutex->lock_count = lock_count;
+
+	return ret;
+}
+#endif
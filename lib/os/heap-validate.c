@@ -72,9 +72,38 @@ static inline void check_nexts(struct z_heap *h, int bidx)
 	}
 }
 
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+/* Chunks parked in a fast bin look allocated to the rest of the
+ * validation code, so check the bins themselves: every entry must be
+ * a valid, used chunk of the bin's exact size, and the list must be
+ * exactly as long as its count (which also catches cycles).
+ */
+static bool valid_fast_bins(struct z_heap *h)
+{
+	for (int i = 0; i < CONFIG_SYS_HEAP_FAST_BIN_SIZES; i++) {
+		struct z_heap_fast_bin *fb = &h->fast_bins[i];
+		chunksz_t sz = min_chunk_size(h) + i;
+		chunkid_t c = fb->next;
+		uint32_t n = 0;
+
+		VALIDATE(fb->count <= CONFIG_SYS_HEAP_FAST_BIN_DEPTH);
+
+		for (; c != 0 && n <= fb->count; n++, c = next_free_chunk(h, c)) {
+			VALIDATE(valid_chunk(h, c));
+			VALIDATE(chunk_used(h, c));
+			VALIDATE(chunk_size(h, c) == sz);
+		}
+
+		VALIDATE(c == 0 && n == fb->count);
+	}
+	return true;
+}
+#endif
+
 bool sys_heap_validate(struct sys_heap *heap)
 {
 	struct z_heap *h = heap->heap;
+	chunksz_t used = 0;
 	chunkid_t c;
 
 	/*
@@ -84,11 +113,31 @@ bool sys_heap_validate(struct sys_heap *heap)
 		if (!valid_chunk(h, c)) {
 			return false;
 		}
+		if (chunk_used(h, c)) {
+			used += chunk_size(h, c);
+		}
 	}
 	if (c != h->end_chunk) {
 		return false;  /* Should have exactly consumed the buffer */
 	}
 
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	if (!valid_fast_bins(h)) {
+		return false;
+	}
+
+	/* fast bin chunks are marked used, but not accounted as such */
+	for (int i = 0; i < CONFIG_SYS_HEAP_FAST_BIN_SIZES; i++) {
+		used -= h->fast_bins[i].count * (min_chunk_size(h) + i);
+	}
+#endif
+
+	/* The incrementally maintained runtime stats must agree */
+	if (used != h->allocated_units ||
+	    used > h->max_allocated_units) {
+		return false;
+	}
+
 	/* Check the free lists: entry count should match, empty bit
 	 * should be correct, and all chunk entries should point into
 	 * valid unused chunks.  Mark those chunks USED, temporarily.
@@ -114,6 +163,10 @@ bool sys_heap_validate(struct sys_heap *heap)
 			return false;
 		}
 
+		if (n != h->buckets[b].count) {
+			return false;
+		}
+
 		if (empty && h->buckets[b].next != 0) {
 			return false;
 		}
@@ -347,6 +400,22 @@ void heap_print_info(struct z_heap *h, bool dump_chunks)
 		}
 	}
 
+	size_t fast_bytes = 0;
+
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	printk("\n fast bin#        units       chunks\n"
+	       "  ----------------------------------\n");
+	for (i = 0; i < CONFIG_SYS_HEAP_FAST_BIN_SIZES; i++) {
+		struct z_heap_fast_bin *fb = &h->fast_bins[i];
+		chunksz_t sz = min_chunk_size(h) + i;
+
+		if (fb->count) {
+			printk("%9d %12d %12d\n", i, sz, fb->count);
+		}
+		fast_bytes += fb->count * chunksz_to_bytes(h, sz);
+	}
+#endif
+
 	if (dump_chunks) {
 		printk("\nChunk dump:\n");
 	}
@@ -377,8 +446,12 @@ void heap_print_info(struct z_heap *h, bool dump_chunks)
 	/* The end marker chunk has a header. It is part of the overhead. */
 	total = h->end_chunk * CHUNK_UNIT + chunk_header_bytes(h);
 	overhead = total - free_bytes - allocated_bytes;
-	printk("\n%zd free bytes, %zd allocated bytes, overhead = %zd bytes (%zd.%zd%%)\n",
-	       free_bytes, allocated_bytes, overhead,
+
+	/* chunks parked in fast bins are marked used but really free */
+	allocated_bytes -= fast_bytes;
+	free_bytes += fast_bytes;
+	printk("\n%zd free bytes (%zd in fast bins), %zd allocated bytes, overhead = %zd bytes (%zd.%zd%%)\n",
+	       free_bytes, fast_bytes, allocated_bytes, overhead,
 	       (1000 * overhead + total/2) / total / 10,
 	       (1000 * overhead + total/2) / total % 10);
 }
@@ -6,8 +6,23 @@
 #include <sys/sys_heap.h>
 #include <kernel.h>
 #include <string.h>
+#include <debug/heap_profiler.h>
 #include "heap.h"
 
+#ifdef CONFIG_HEAP_PROFILER
+/* Macros so that __builtin_return_address() is the API caller's */
+#define PROF_ALLOC(mem, bytes) do { \
+		if ((mem) != NULL) { \
+			z_heap_prof_alloc(mem, bytes, \
+					  __builtin_return_address(0)); \
+		} \
+	} while (false)
+#define PROF_FREE(mem) z_heap_prof_free(mem)
+#else
+#define PROF_ALLOC(mem, bytes) do { } while (false)
+#define PROF_FREE(mem) do { } while (false)
+#endif
+
 static void *chunk_mem(struct z_heap *h, chunkid_t c)
 {
 	chunk_unit_t *buf = chunk_buf(h);
@@ -18,6 +33,22 @@ static void *chunk_mem(struct z_heap *h, chunkid_t c)
 	return ret;
 }
 
+/* Runtime stats: units handed out to users.  Everything else past
+ * chunk0 is free, including the chunks held back in fast bins.
+ */
+static inline void stats_alloc(struct z_heap *h, chunksz_t sz)
+{
+	h->allocated_units += sz;
+	h->max_allocated_units = MAX(h->max_allocated_units,
+				     h->allocated_units);
+}
+
+static inline void stats_free(struct z_heap *h, chunksz_t sz)
+{
+	CHECK(h->allocated_units >= sz);
+	h->allocated_units -= sz;
+}
+
 static void free_list_remove_bidx(struct z_heap *h, chunkid_t c, int bidx)
 {
 	struct z_heap_bucket *b = &h->buckets[bidx];
@@ -26,6 +57,8 @@ static void free_list_remove_bidx(struct z_heap *h, chunkid_t c, int bidx)
 	CHECK(b->next != 0);
 	CHECK(h->avail_buckets & (1 << bidx));
 
+	b->count--;
+
 	if (next_free_chunk(h, c) == c) {
 		/* this is the last chunk */
 		h->avail_buckets &= ~(1 << bidx);
@@ -52,6 +85,8 @@ static void free_list_add_bidx(struct z_heap *h, chunkid_t c, int bidx)
 {
 	struct z_heap_bucket *b = &h->buckets[bidx];
 
+	b->count++;
+
 	if (b->next == 0U) {
 		CHECK((h->avail_buckets & (1 << bidx)) == 0);
 
@@ -127,6 +162,67 @@ static void free_chunk(struct z_heap *h, chunkid_t c)
 	free_list_add(h, c);
 }
 
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+/* Parks a freed (but still marked used) chunk in its fast bin.
+ * Returns false if the chunk has no fast bin or the bin is full, in
+ * which case it must be freed normally.
+ */
+static bool fast_bin_push(struct z_heap *h, chunkid_t c)
+{
+	struct z_heap_fast_bin *fb = fast_bin(h, chunk_size(h, c));
+
+	if (fb == NULL || fb->count >= CONFIG_SYS_HEAP_FAST_BIN_DEPTH) {
+		return false;
+	}
+
+	set_next_free_chunk(h, c, fb->next);
+	fb->next = c;
+	fb->count++;
+	return true;
+}
+
+static chunkid_t fast_bin_pop(struct z_heap *h, chunksz_t sz)
+{
+	struct z_heap_fast_bin *fb = fast_bin(h, sz);
+	chunkid_t c;
+
+	if (fb == NULL || fb->next == 0U) {
+		return 0;
+	}
+
+	c = fb->next;
+	CHECK(chunk_used(h, c) && chunk_size(h, c) == sz);
+	fb->next = next_free_chunk(h, c);
+	fb->count--;
+	return c;
+}
+
+/* The deferred coalescing step: returns every chunk parked in the
+ * fast bins to the heap proper, merging it with its free neighbors.
+ * Returns true if there was anything to flush.
+ */
+static bool fast_bins_flush(struct z_heap *h)
+{
+	bool flushed = false;
+
+	for (int i = 0; i < CONFIG_SYS_HEAP_FAST_BIN_SIZES; i++) {
+		struct z_heap_fast_bin *fb = &h->fast_bins[i];
+
+		while (fb->next != 0U) {
+			chunkid_t c = fb->next;
+
+			fb->next = next_free_chunk(h, c);
+			set_chunk_used(h, c, false);
+			free_chunk(h, c);
+			flushed = true;
+		}
+		fb->count = 0U;
+	}
+
+	return flushed;
+}
+#endif
+
 /*
  * Return the closest chunk ID corresponding to given memory pointer.
  * Here "closest" is only meaningful in the context of sys_heap_aligned_alloc()
@@ -139,7 +235,7 @@ static chunkid_t mem_to_chunkid(struct z_heap *h, void *p)
 	return (mem - chunk_header_bytes(h) - base) / CHUNK_UNIT;
 }
 
-void sys_heap_free(struct sys_heap *heap, void *mem)
+static void heap_free(struct sys_heap *heap, void *mem)
 {
 	if (mem == NULL) {
 		return; /* ISO C free() semantics */
@@ -163,6 +259,14 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 		 "corrupted heap bounds (buffer overflow?) for memory at %p",
 		 mem);
 
+	stats_free(h, chunk_size(h, c));
+
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	if (fast_bin_push(h, c)) {
+		return;
+	}
+#endif
+
 	set_chunk_used(h, c, false);
 	free_chunk(h, c);
 }
@@ -216,10 +320,19 @@ static chunkid_t alloc_chunk(struct z_heap *h, chunksz_t sz)
 		return c;
 	}
 
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	/* Last resort: coalesce whatever the fast bins hold back and
+	 * try again.  Only recurses once, the bins are empty after.
+	 */
+	if (fast_bins_flush(h)) {
+		return alloc_chunk(h, sz);
+	}
+#endif
+
 	return 0;
 }
 
-void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+static void *heap_alloc(struct sys_heap *heap, size_t bytes)
 {
 	struct z_heap *h = heap->heap;
 
@@ -228,7 +341,17 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	}
 
 	chunksz_t chunk_sz = bytes_to_chunksz(h, bytes);
-	chunkid_t c = alloc_chunk(h, chunk_sz);
+	chunkid_t c;
+
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	c = fast_bin_pop(h, chunk_sz);
+	if (c != 0U) {
+		stats_alloc(h, chunk_sz);
+		return chunk_mem(h, c);
+	}
+#endif
+
+	c = alloc_chunk(h, chunk_sz);
 	if (c == 0U) {
 		return NULL;
 	}
@@ -240,10 +363,12 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	}
 
 	set_chunk_used(h, c, true);
+	stats_alloc(h, chunk_size(h, c));
 	return chunk_mem(h, c);
 }
 
-void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+static void *heap_aligned_alloc(struct sys_heap *heap, size_t align,
+				size_t bytes)
 {
 	struct z_heap *h = heap->heap;
 	size_t gap, rew;
@@ -261,7 +386,7 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 		gap = MIN(rew, chunk_header_bytes(h));
 	} else {
 		if (align <= chunk_header_bytes(h)) {
-			return sys_heap_alloc(heap, bytes);
+			return heap_alloc(heap, bytes);
 		}
 		rew = 0;
 		gap = chunk_header_bytes(h);
@@ -307,20 +432,30 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	}
 
 	set_chunk_used(h, c, true);
+	stats_alloc(h, chunk_size(h, c));
 	return mem;
 }
 
-void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
-			       size_t align, size_t bytes)
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c = mem_to_chunkid(h, mem);
+	uint8_t *end = (uint8_t *)&chunk_buf(h)[right_chunk(h, c)];
+
+	return end - (uint8_t *)mem;
+}
+
+static void *heap_aligned_realloc(struct sys_heap *heap, void *ptr,
+				  size_t align, size_t bytes)
 {
 	struct z_heap *h = heap->heap;
 
 	/* special realloc semantics */
 	if (ptr == NULL) {
-		return sys_heap_aligned_alloc(heap, align, bytes);
+		return heap_aligned_alloc(heap, align, bytes);
 	}
 	if (bytes == 0) {
-		sys_heap_free(heap, ptr);
+		heap_free(heap, ptr);
 		return NULL;
 	}
 
@@ -342,6 +477,7 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 		return ptr;
 	} else if (chunk_size(h, c) > chunks_need) {
 		/* Shrink in place, split off and free unused suffix */
+		stats_free(h, chunk_size(h, c) - chunks_need);
 		split_chunks(h, c, c + chunks_need);
 		set_chunk_used(h, c, true);
 		free_chunk(h, c + chunks_need);
@@ -358,23 +494,66 @@ void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
 			free_list_add(h, rc + split_size);
 		}
 
+		stats_alloc(h, chunks_need - chunk_size(h, c));
 		merge_chunks(h, c, rc);
 		set_chunk_used(h, c, true);
 		return ptr;
 	}
 
 	/* Fallback: allocate and copy */
-	void *ptr2 = sys_heap_aligned_alloc(heap, align, bytes);
+	void *ptr2 = heap_aligned_alloc(heap, align, bytes);
 
 	if (ptr2 != NULL) {
 		size_t prev_size = chunksz_to_bytes(h, chunk_size(h, c)) - align_gap;
 
 		memcpy(ptr2, ptr, MIN(prev_size, bytes));
-		sys_heap_free(heap, ptr);
+		heap_free(heap, ptr);
 	}
 	return ptr2;
 }
 
+/* The public entry points wrap the implementations above, which call
+ * each other, so that the profiler sees each request exactly once.
+ */
+void sys_heap_free(struct sys_heap *heap, void *mem)
+{
+	if (mem != NULL) {
+		PROF_FREE(mem);
+	}
+	heap_free(heap, mem);
+}
+
+void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+{
+	void *ret = heap_alloc(heap, bytes);
+
+	PROF_ALLOC(ret, bytes);
+	return ret;
+}
+
+void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
+{
+	void *ret = heap_aligned_alloc(heap, align, bytes);
+
+	PROF_ALLOC(ret, bytes);
+	return ret;
+}
+
+void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
+			       size_t align, size_t bytes)
+{
+	void *ret = heap_aligned_realloc(heap, ptr, align, bytes);
+
+	/* A failed realloc leaves the old block alone, unless it was
+	 * a free in disguise
+	 */
+	if (ptr != NULL && (ret != NULL || bytes == 0)) {
+		PROF_FREE(ptr);
+	}
+	PROF_ALLOC(ret, bytes);
+	return ret;
+}
+
 void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 {
 	/* Must fit in a 31 bit count of HUNK_UNIT */
@@ -396,6 +575,8 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 	heap->heap = h;
 	h->end_chunk = heap_sz;
 	h->avail_buckets = 0;
+	h->allocated_units = 0;
+	h->max_allocated_units = 0;
 
 	int nb_buckets = bucket_idx(h, heap_sz) + 1;
 	chunksz_t chunk0_size = chunksz(sizeof(struct z_heap) +
@@ -405,7 +586,15 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 
 	for (int i = 0; i < nb_buckets; i++) {
 		h->buckets[i].next = 0;
+		h->buckets[i].count = 0;
+	}
+
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	for (int i = 0; i < CONFIG_SYS_HEAP_FAST_BIN_SIZES; i++) {
+		h->fast_bins[i].next = 0;
+		h->fast_bins[i].count = 0U;
 	}
+#endif
 
 	/* chunk containing our struct z_heap */
 	set_chunk_size(h, 0, chunk0_size);
@@ -423,3 +612,57 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 
 	free_list_add(h, chunk0_size);
 }
+
+static chunksz_t largest_free_chunk(struct z_heap *h)
+{
+	chunksz_t largest = 0;
+
+	/* Only the highest non-empty bucket can hold the largest chunk */
+	if (h->avail_buckets != 0U) {
+		int bi = 31 - __builtin_clz(h->avail_buckets);
+		chunkid_t first = h->buckets[bi].next, c = first;
+
+		do {
+			largest = MAX(largest, chunk_size(h, c));
+			c = next_free_chunk(h, c);
+		} while (c != first);
+	}
+
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	for (int i = CONFIG_SYS_HEAP_FAST_BIN_SIZES - 1; i >= 0; i--) {
+		if (h->fast_bins[i].count != 0U) {
+			largest = MAX(largest, min_chunk_size(h) + i);
+			break;
+		}
+	}
+#endif
+
+	return largest;
+}
+
+void sys_heap_runtime_stats_get(struct sys_heap *heap,
+				struct sys_heap_runtime_stats *stats)
+{
+	struct z_heap *h = heap->heap;
+	chunksz_t total = h->end_chunk - right_chunk(h, 0);
+	chunksz_t largest = largest_free_chunk(h);
+	int nb_buckets = bucket_idx(h, h->end_chunk) + 1;
+
+	stats->allocated_bytes = (size_t)h->allocated_units * CHUNK_UNIT;
+	stats->free_bytes = (size_t)(total - h->allocated_units) * CHUNK_UNIT;
+	stats->max_allocated_bytes = (size_t)h->max_allocated_units * CHUNK_UNIT;
+	stats->largest_free_bytes = largest ? chunksz_to_bytes(h, largest) : 0;
+	stats->num_buckets = nb_buckets;
+
+	for (int i = 0; i < SYS_HEAP_MAX_BUCKETS; i++) {
+		stats->bucket_free_chunks[i] =
+			i < nb_buckets ? h->buckets[i].count : 0;
+	}
+}
+
+void sys_heap_runtime_stats_reset_max(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+
+	h->max_allocated_units = h->allocated_units;
+}
@@ -63,12 +63,27 @@ typedef uint32_t chunksz_t;
 
 struct z_heap_bucket {
 	chunkid_t next;
+	uint32_t count;
+};
+
+/* Fast bins are singly linked (through FREE_NEXT) stacks of freed
+ * chunks of one exact size.  Those chunks keep their "used" bit set,
+ * so they are invisible to the rest of the heap until flushed.
+ */
+struct z_heap_fast_bin {
+	chunkid_t next;
+	uint32_t count;
 };
 
 struct z_heap {
 	chunkid_t chunk0_hdr[2];
 	chunkid_t end_chunk;
 	uint32_t avail_buckets;
+	chunksz_t allocated_units;
+	chunksz_t max_allocated_units;
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	struct z_heap_fast_bin fast_bins[CONFIG_SYS_HEAP_FAST_BIN_SIZES];
+#endif
 	struct z_heap_bucket buckets[0];
 };
 
@@ -242,6 +257,16 @@ static inline int bucket_idx(struct z_heap *h, chunksz_t sz)
 	return 31 - __builtin_clz(usable_sz);
 }
 
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+/* Returns the fast bin for chunks of size sz, or NULL if none */
+static inline struct z_heap_fast_bin *fast_bin(struct z_heap *h, chunksz_t sz)
+{
+	chunksz_t idx = sz - min_chunk_size(h);
+
+	return idx < CONFIG_SYS_HEAP_FAST_BIN_SIZES ? &h->fast_bins[idx] : NULL;
+}
+#endif
+
 static inline bool size_too_big(struct z_heap *h, size_t bytes)
 {
 	/*
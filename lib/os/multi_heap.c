@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <sys/multi_heap.h>
+#include <sys/__assert.h>
+#include <errno.h>
+
+void sys_multi_heap_init(struct sys_multi_heap *mheap)
+{
+	mheap->num_regions = 0;
+	mheap->failures = 0U;
+}
+
+int sys_multi_heap_add_region(struct sys_multi_heap *mheap, void *mem,
+			      size_t bytes, uint32_t attr)
+{
+	struct sys_multi_heap_region *r;
+
+	if (mheap->num_regions >= CONFIG_SYS_MULTI_HEAP_MAX_REGIONS) {
+		return -ENOMEM;
+	}
+
+	r = &mheap->regions[mheap->num_regions];
+	sys_heap_init(&r->heap, mem, bytes);
+	r->start = (uintptr_t)mem;
+	r->end = (uintptr_t)mem + bytes;
+	r->attr = attr;
+	r->allocs = 0U;
+	r->fallback_allocs = 0U;
+
+	return mheap->num_regions++;
+}
+
+void *sys_multi_heap_aligned_alloc(struct sys_multi_heap *mheap,
+				   uint32_t attr, size_t align, size_t bytes)
+{
+	for (int pass = 0; pass < Z_MHEAP_PASSES; pass++) {
+		for (int i = 0; i < mheap->num_regions; i++) {
+			struct sys_multi_heap_region *r = &mheap->regions[i];
+			void *mem;
+
+			if (!z_multi_heap_attr_match(r->attr, attr, pass)) {
+				continue;
+			}
+
+			/* Fallback pass: skip regions already tried */
+			if (pass != 0 &&
+			    z_multi_heap_attr_match(r->attr, attr, 0)) {
+				continue;
+			}
+
+			mem = sys_heap_aligned_alloc(&r->heap, align, bytes);
+			if (mem != NULL) {
+				r->allocs++;
+				r->fallback_allocs += pass;
+				return mem;
+			}
+		}
+	}
+
+	mheap->failures++;
+	return NULL;
+}
+
+void sys_multi_heap_free(struct sys_multi_heap *mheap, void *mem)
+{
+	uintptr_t addr = (uintptr_t)mem;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < mheap->num_regions; i++) {
+		struct sys_multi_heap_region *r = &mheap->regions[i];
+
+		if (addr >= r->start && addr < r->end) {
+			sys_heap_free(&r->heap, mem);
+			return;
+		}
+	}
+
+	__ASSERT(false, "%p not allocated from multi-heap %p", mem, mheap);
+}
+
+int sys_multi_heap_region_stats_get(struct sys_multi_heap *mheap, int region,
+				    struct sys_multi_heap_region_stats *stats)
+{
+	struct sys_multi_heap_region *r;
+
+	if (region < 0 || region >= mheap->num_regions) {
+		return -EINVAL;
+	}
+
+	r = &mheap->regions[region];
+	stats->attr = r->attr;
+	stats->allocs = r->allocs;
+	stats->fallback_allocs = r->fallback_allocs;
+	sys_heap_runtime_stats_get(&r->heap, &stats->heap);
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Render the boot profile as a timeline.
+
+Reads a console log containing the BPROF lines of a "boot_prof dump"
+shell command or of CONFIG_BOOT_PROFILER_LOG, and prints one row per
+boot step with its start time, its duration and a bar placing it on
+the boot timeline.  Init functions without a device are resolved to
+their names with addr2line.  The profile can also be written in the
+Chrome trace event format, for chrome://tracing or Perfetto.  The last
+dump in the log is used.
+"""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+
+
+BPROF_RE = re.compile(r"BPROF (\w+)(.*)$")
+FIELD_RE = re.compile(r"(\w+) (-?0x[0-9a-fA-F]+|-?\d+|\(nil\))")
+NAME_RE = re.compile(r" name (\S+)")
+
+LEVELS = ["PRE_KERNEL_1", "PRE_KERNEL_2", "POST_KERNEL", "APPLICATION",
+          "SMP"]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+
+    parser.add_argument("logfile", help="Console log with a boot profile")
+    parser.add_argument("-e", "--elf", help="zephyr.elf to resolve init "
+            "functions")
+    parser.add_argument("--addr2line", default="addr2line",
+            help="addr2line of the target toolchain")
+    parser.add_argument("-w", "--width", type=int, default=60,
+            help="Width of the timeline in characters")
+    parser.add_argument("--chrome", metavar="JSON",
+            help="Also write the profile as a Chrome trace")
+
+    return parser.parse_args()
+
+
+def parse_fields(text):
+    fields = {}
+    for key, val in FIELD_RE.findall(text):
+        fields[key] = 0 if val == "(nil)" else int(val, 0)
+    m = NAME_RE.search(text)
+    fields["name"] = m.group(1) if m and m.group(1) != "-" else None
+    return fields
+
+
+def parse_log(path):
+    steps, current, dropped = None, [], 0
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            m = BPROF_RE.search(line)
+            if not m:
+                continue
+            kind, fields = m.group(1), parse_fields(m.group(2))
+            if kind == "end":
+                # Complete dump, replaces any earlier one
+                steps, current = current, []
+                dropped = fields["dropped"]
+            else:
+                fields["type"] = kind
+                current.append(fields)
+
+    return steps, dropped
+
+
+def resolve(elf, addr2line, addrs):
+    names = {}
+    addrs = sorted(set(a for a in addrs if a != 0))
+    if not elf or not addrs:
+        return names
+
+    cmd = [addr2line, "-f", "-s", "-e", elf] + [hex(a) for a in addrs]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE, check=True,
+                         universal_newlines=True).stdout.splitlines()
+    for i, addr in enumerate(addrs):
+        names[addr] = out[2 * i]
+
+    return names
+
+
+def label(step, names):
+    if step["type"] == "main":
+        return "main()"
+    if step["type"] != "init":
+        return "%s %s" % (step["type"], step["name"] or "")
+    what = step["name"] or names.get(step["id"], "0x%x" % step["id"])
+    level = LEVELS[step["level"]] if 0 <= step["level"] < len(LEVELS) \
+        else "?"
+    return "%s %s" % (level, what)
+
+
+def bar(step, t0, span, width):
+    first = (step["start"] - t0) * width // span
+    last = (step["end"] - t0) * width // span if step["done"] else width
+    return " " * first + "#" * max(1, last - first)
+
+
+def write_chrome(path, steps, names):
+    events = []
+    for step in steps:
+        event = {"name": label(step, names), "cat": step["type"],
+                 "pid": 0, "tid": step["type"], "ts": step["start"]}
+        if step["type"] == "main":
+            event.update(ph="i", s="g")
+        else:
+            event.update(ph="X", dur=step["end"] - step["start"]
+                         if step["done"] else 0)
+        events.append(event)
+
+    with open(path, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+
+
+def main():
+    args = parse_args()
+    steps, dropped = parse_log(args.logfile)
+
+    if not steps:
+        sys.exit("No boot profile found in %s" % args.logfile)
+
+    names = resolve(args.elf, args.addr2line,
+                    [s["id"] for s in steps if s["type"] == "init" and
+                     not s["name"]])
+
+    t0 = min(s["start"] for s in steps)
+    span = max(max(s["end"] for s in steps) - t0, 1)
+
+    print("%10s %10s  %-40s %s" % ("start us", "us", "step", "timeline"))
+    for s in steps:
+        dur = "%d" % (s["end"] - s["start"]) if s["done"] else "-"
+        print("%10d %10s  %-40s|%s" % (s["start"], dur, label(s, names),
+              bar(s, t0, span, args.width)))
+
+    if dropped:
+        print("%d steps were not recorded" % dropped)
+
+    if args.chrome:
+        write_chrome(args.chrome, steps, names)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Decode the output of the "heap_prof dump" shell command.
+
+Reads a console log containing HPROF lines, resolves the call sites
+to functions and source lines with addr2line and prints the sites
+sorted by live bytes, together with their allocation rate and the age
+of their oldest live allocation.  The last dump in the log is used.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+
+HPROF_RE = re.compile(r"HPROF ((\w+).*)$")
+FIELD_RE = re.compile(r"(\w+) (0x[0-9a-fA-F]+|\d+|\(nil\))")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+
+    parser.add_argument("logfile", help="Console log with a heap_prof dump")
+    parser.add_argument("-e", "--elf", help="zephyr.elf to resolve sites")
+    parser.add_argument("--addr2line", default="addr2line",
+            help="addr2line of the target toolchain")
+    parser.add_argument("-n", "--top", type=int, default=0,
+            help="Only print the N sites with most live bytes")
+
+    return parser.parse_args()
+
+
+def parse_fields(text):
+    fields = {}
+    for key, val in FIELD_RE.findall(text):
+        fields[key] = 0 if val == "(nil)" else int(val, 0)
+    return fields
+
+
+def parse_log(path):
+    stats, sites, live = {}, [], []
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            m = HPROF_RE.search(line)
+            if not m:
+                continue
+            kind, fields = m.group(2), parse_fields(m.group(1))
+            if kind == "stats":
+                # A new dump starts, forget any earlier one
+                stats, sites, live = fields, [], []
+            elif kind == "site":
+                sites.append(fields)
+            elif kind == "live":
+                live.append(fields)
+
+    return stats, sites, live
+
+
+def resolve(elf, addr2line, addrs):
+    names = {}
+    addrs = [a for a in addrs if a != 0]
+    if not elf or not addrs:
+        return names
+
+    # Return addresses point after the call, step back into it
+    cmd = [addr2line, "-f", "-s", "-e", elf] + [hex(a - 1) for a in addrs]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE, check=True,
+                         universal_newlines=True).stdout.splitlines()
+    for i, addr in enumerate(addrs):
+        func, loc = out[2 * i:2 * i + 2]
+        names[addr] = "%s (%s)" % (func, loc)
+
+    return names
+
+
+def main():
+    args = parse_args()
+    stats, sites, live = parse_log(args.logfile)
+
+    if not stats:
+        sys.exit("No heap_prof dump found in %s" % args.logfile)
+
+    uptime = stats["uptime"]
+    oldest = {}
+    for a in live:
+        age = uptime - a["t"]
+        oldest[a["site"]] = max(oldest.get(a["site"], 0), age)
+
+    sites.sort(key=lambda s: s["live"], reverse=True)
+    if args.top:
+        sites = sites[:args.top]
+
+    names = resolve(args.elf, args.addr2line, [s["site"] for s in sites])
+
+    print("%10s %6s %10s %8s %8s %8s %10s  %s" % ("live", "count", "peak",
+          "allocs", "frees", "allocs/s", "oldest ms", "site"))
+    for s in sites:
+        window = s["last"] - s["first"]
+        rate = s["allocs"] * 1000 / window if window else s["allocs"]
+        site = names.get(s["site"], "0x%x" % s["site"]) if s["site"] \
+            else "<other sites>"
+        print("%10d %6d %10d %8d %8d %8.1f %10s  %s" % (s["live"],
+              s["count"], s["peak"], s["allocs"], s["frees"], rate,
+              oldest.get(s["site"], "-"), site))
+
+    print("tracked %d dropped %d untracked frees %d at uptime %d ms" %
+          (stats["tracked"], stats["dropped"], stats["untracked"], uptime))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Boot profiler
+ *
+ * Each boot step claims the next slot of a fixed table with an atomic
+ * increment, so init entries run concurrently by the parallel device
+ * initialization need no lock, and is the only writer of its slot.
+ * Static threads get their slot when they are started; the records of
+ * those not scheduled yet are looked up on each context switch until
+ * they all have run.  Timestamps are raw timing counter values, only
+ * converted when the table is read after boot, since the counter
+ * frequency may not be known while the PRE_KERNEL levels run.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <device.h>
+#include <debug/boot_profiler.h>
+#include <timing/timing.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+#include <logging/log.h>
+LOG_MODULE_REGISTER(boot_prof, CONFIG_BOOT_PROFILER_LOG_LEVEL);
+
+#define NUM_RECORDS CONFIG_BOOT_PROFILER_RECORDS
+
+extern const struct init_entry __init_PRE_KERNEL_1_start[];
+extern const struct init_entry __init_PRE_KERNEL_2_start[];
+extern const struct init_entry __init_POST_KERNEL_start[];
+extern const struct init_entry __init_APPLICATION_start[];
+#ifdef CONFIG_SMP
+extern const struct init_entry __init_SMP_start[];
+#endif
+
+static const struct init_entry *const levels[] = {
+	__init_PRE_KERNEL_1_start,
+	__init_PRE_KERNEL_2_start,
+	__init_POST_KERNEL_start,
+	__init_APPLICATION_start,
+#ifdef CONFIG_SMP
+	__init_SMP_start,
+#endif
+};
+
+static const char *const level_names[] = {
+	"PRE_KERNEL_1",
+	"PRE_KERNEL_2",
+	"POST_KERNEL",
+	"APPLICATION",
+#ifdef CONFIG_SMP
+	"SMP",
+#endif
+};
+
+static struct boot_prof_record records[NUM_RECORDS];
+static atomic_t claimed;
+
+/* Slots of the static threads, and how many have not run yet */
+static int threads_first;
+static int threads_end;
+static atomic_t threads_pending;
+
+static int record_claim(uint8_t type, int8_t level, const void *id,
+			const char *name)
+{
+	int i = (int)atomic_inc(&claimed);
+
+	if (i >= NUM_RECORDS) {
+		return -1;
+	}
+
+	records[i] = (struct boot_prof_record){
+		.id = id,
+		.name = name,
+		.type = type,
+		.level = level,
+	};
+	records[i].start = timing_counter_get();
+	return i;
+}
+
+static int8_t init_level(const struct init_entry *entry)
+{
+	int level = ARRAY_SIZE(levels) - 1;
+
+	while (level > 0 && entry < levels[level]) {
+		level--;
+	}
+	return level;
+}
+
+int z_boot_prof_init_enter(const struct init_entry *entry)
+{
+	const struct device *dev = entry->dev;
+
+	return record_claim(BOOT_PROF_INIT, init_level(entry),
+			    (const void *)entry->init,
+			    dev != NULL ? dev->name : NULL);
+}
+
+void z_boot_prof_init_exit(int record)
+{
+	if (record >= 0) {
+		records[record].end = timing_counter_get();
+		records[record].done = true;
+	}
+}
+
+void z_boot_prof_thread_start(const struct _static_thread_data *data)
+{
+	int i = record_claim(BOOT_PROF_THREAD, -1, data->init_thread,
+			     data->init_name);
+
+	if (i < 0) {
+		return;
+	}
+
+	/* All static threads are started in a row, after the init levels */
+	if (atomic_get(&threads_pending) == 0) {
+		threads_first = i;
+	}
+	threads_end = i + 1;
+	atomic_inc(&threads_pending);
+}
+
+/* A static thread aborted before ever running stays pending, which only
+ * costs a short scan per context switch.
+ */
+void z_boot_prof_switched_in(struct k_thread *thread)
+{
+	if (atomic_get(&threads_pending) == 0) {
+		return;
+	}
+
+	for (int i = threads_first; i < threads_end; i++) {
+		struct boot_prof_record *r = &records[i];
+
+		if (r->id == thread && !r->done) {
+			r->end = timing_counter_get();
+			r->done = true;
+			atomic_dec(&threads_pending);
+			break;
+		}
+	}
+}
+
+#ifdef CONFIG_BOOT_PROFILER_LOG
+static void boot_prof_log(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(log_work, boot_prof_log);
+#endif
+
+void z_boot_prof_main(void)
+{
+	int i = record_claim(BOOT_PROF_MAIN, -1, NULL, "main");
+
+	if (i >= 0) {
+		records[i].end = records[i].start;
+		records[i].done = true;
+	}
+
+#ifdef CONFIG_BOOT_PROFILER_LOG
+	k_work_schedule(&log_work, K_MSEC(CONFIG_BOOT_PROFILER_LOG_DELAY));
+#endif
+}
+
+void boot_prof_foreach(boot_prof_cb_t cb, void *user_data)
+{
+	int count = MIN((int)atomic_get(&claimed), NUM_RECORDS);
+	struct boot_prof_record snap;
+
+	for (int i = 0; i < count; i++) {
+		snap = records[i];
+		cb(&snap, user_data);
+	}
+}
+
+uint32_t boot_prof_dropped(void)
+{
+	atomic_val_t count = atomic_get(&claimed);
+
+	return count > NUM_RECORDS ? count - NUM_RECORDS : 0U;
+}
+
+const char *boot_prof_level_name(int level)
+{
+	if (level < 0 || level >= ARRAY_SIZE(level_names)) {
+		return "-";
+	}
+	return level_names[level];
+}
+
+#if defined(CONFIG_BOOT_PROFILER_LOG) || defined(CONFIG_BOOT_PROFILER_SHELL)
+static const char *const type_names[] = {
+	[BOOT_PROF_INIT] = "init",
+	[BOOT_PROF_MAIN] = "main",
+	[BOOT_PROF_THREAD] = "thread",
+};
+
+static uint32_t stamp_us(timing_t stamp)
+{
+	return (uint32_t)(timing_cycles_to_ns(stamp) / NSEC_PER_USEC);
+}
+
+/* Line format parsed by scripts/boot_profiler/boot_prof_timeline.py */
+#define RECORD_FMT "BPROF %s level %d id %p start %u end %u done %u name %s"
+#define RECORD_ARGS(r) type_names[(r)->type], (r)->level, (r)->id, \
+	stamp_us((r)->start), stamp_us((r)->end), (r)->done, \
+	(r)->name != NULL ? (r)->name : "-"
+#endif
+
+#ifdef CONFIG_BOOT_PROFILER_LOG
+static void log_record_cb(const struct boot_prof_record *r, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	LOG_INF(RECORD_FMT, RECORD_ARGS(r));
+}
+
+static void boot_prof_log(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	boot_prof_foreach(log_record_cb, NULL);
+	LOG_INF("BPROF end dropped %u", boot_prof_dropped());
+}
+#endif /* CONFIG_BOOT_PROFILER_LOG */
+
+#ifdef CONFIG_BOOT_PROFILER_SHELL
+#include <shell/shell.h>
+
+static void shell_record_cb(const struct boot_prof_record *r,
+			    void *user_data)
+{
+	const struct shell *shell = user_data;
+	const char *what = r->type == BOOT_PROF_INIT ?
+		boot_prof_level_name(r->level) : type_names[r->type];
+	uint32_t start = stamp_us(r->start);
+	uint32_t end = stamp_us(r->end);
+
+	if (!r->done) {
+		shell_print(shell, "%-12s %-24s %10u %10s", what,
+			    r->name != NULL ? r->name : "-", start, "-");
+	} else if (r->name != NULL) {
+		shell_print(shell, "%-12s %-24s %10u %10u", what, r->name,
+			    start, end - start);
+	} else {
+		shell_print(shell, "%-12s %-24p %10u %10u", what, r->id,
+			    start, end - start);
+	}
+}
+
+static int cmd_show(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "%-12s %-24s %10s %10s", "step", "name",
+		    "start us", "us");
+	boot_prof_foreach(shell_record_cb, (void *)shell);
+	shell_print(shell, "dropped %u", boot_prof_dropped());
+	return 0;
+}
+
+static void dump_record_cb(const struct boot_prof_record *r,
+			   void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, RECORD_FMT, RECORD_ARGS(r));
+}
+
+static int cmd_dump(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	boot_prof_foreach(dump_record_cb, (void *)shell);
+	shell_print(shell, "BPROF end dropped %u", boot_prof_dropped());
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_boot_prof,
+	SHELL_CMD(show, NULL, "List boot steps", cmd_show),
+	SHELL_CMD(dump, NULL, "Dump for boot_prof_timeline.py", cmd_dump),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_REGISTER(boot_prof, &sub_boot_prof, "Boot profiler", NULL);
+
+#endif /* CONFIG_BOOT_PROFILER_SHELL */
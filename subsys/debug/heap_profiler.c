@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Heap allocation profiler
+ *
+ * Two open addressed hash tables with linear probing: one of call
+ * sites, which only ever grows until reset, and one of live
+ * allocations keyed by address, from which entries are removed with
+ * backward shift deletion so no tombstones are needed.  Both are kept
+ * at most three quarters full so probe sequences stay short.
+ */
+
+#include <kernel.h>
+#include <debug/heap_profiler.h>
+#include <sys/util.h>
+
+#define NUM_SITES CONFIG_HEAP_PROFILER_SITES
+#define NUM_LIVE CONFIG_HEAP_PROFILER_ALLOCS
+#define MAX_SITES (NUM_SITES - NUM_SITES / 4)
+#define MAX_LIVE (NUM_LIVE - NUM_LIVE / 4)
+
+/* Index of the site collecting everything the site table can't hold */
+#define OTHER_SITE NUM_SITES
+
+BUILD_ASSERT((NUM_SITES & (NUM_SITES - 1)) == 0,
+	     "CONFIG_HEAP_PROFILER_SITES must be a power of two");
+BUILD_ASSERT((NUM_LIVE & (NUM_LIVE - 1)) == 0,
+	     "CONFIG_HEAP_PROFILER_ALLOCS must be a power of two");
+BUILD_ASSERT(NUM_SITES < UINT16_MAX);
+
+struct live_alloc {
+	void *mem;
+	uint32_t bytes;
+	uint32_t timestamp;
+	uint16_t site;
+};
+
+static struct k_spinlock lock;
+static struct heap_prof_site sites[NUM_SITES + 1];
+static struct live_alloc live[NUM_LIVE];
+static struct heap_prof_stats stats;
+
+static inline uint32_t ptr_hash(void *p)
+{
+	uint32_t h = (uint32_t)((uintptr_t)p >> 2) * 2654435761U;
+
+	return h ^ (h >> 16);
+}
+
+static uint16_t site_get(void *pc, uint32_t now)
+{
+	uint32_t i = ptr_hash(pc) & (NUM_SITES - 1);
+
+	while (sites[i].site != NULL) {
+		if (sites[i].site == pc) {
+			return i;
+		}
+		i = (i + 1) & (NUM_SITES - 1);
+	}
+
+	if (stats.sites >= MAX_SITES) {
+		if (sites[OTHER_SITE].allocs == 0U) {
+			sites[OTHER_SITE].first_ms = now;
+		}
+		return OTHER_SITE;
+	}
+
+	stats.sites++;
+	sites[i].site = pc;
+	sites[i].first_ms = now;
+	return i;
+}
+
+static struct live_alloc *live_find(void *mem)
+{
+	uint32_t i = ptr_hash(mem) & (NUM_LIVE - 1);
+
+	while (live[i].mem != NULL) {
+		if (live[i].mem == mem) {
+			return &live[i];
+		}
+		i = (i + 1) & (NUM_LIVE - 1);
+	}
+	return NULL;
+}
+
+static struct live_alloc *live_insert(void *mem)
+{
+	uint32_t i = ptr_hash(mem) & (NUM_LIVE - 1);
+
+	while (live[i].mem != NULL) {
+		i = (i + 1) & (NUM_LIVE - 1);
+	}
+	live[i].mem = mem;
+	return &live[i];
+}
+
+/* Backward shift deletion: move later members of the probe run into
+ * the hole unless that would put them before their home slot.
+ */
+static void live_remove(struct live_alloc *e)
+{
+	uint32_t hole = e - live;
+	uint32_t i = hole;
+
+	while (true) {
+		i = (i + 1) & (NUM_LIVE - 1);
+		if (live[i].mem == NULL) {
+			break;
+		}
+
+		uint32_t home = ptr_hash(live[i].mem) & (NUM_LIVE - 1);
+
+		if (((i - home) & (NUM_LIVE - 1)) >=
+		    ((i - hole) & (NUM_LIVE - 1))) {
+			live[hole] = live[i];
+			hole = i;
+		}
+	}
+	live[hole].mem = NULL;
+}
+
+void z_heap_prof_alloc(void *mem, size_t bytes, void *caller)
+{
+	struct heap_prof_site *s;
+	struct live_alloc *e;
+	k_spinlock_key_t key;
+	uint32_t now;
+
+	if (k_is_user_context()) {
+		return;
+	}
+
+	now = k_uptime_get_32();
+	key = k_spin_lock(&lock);
+
+	if (!k_is_in_isr() && _current != NULL &&
+	    _current->heap_prof_site != NULL) {
+		caller = _current->heap_prof_site;
+	}
+
+	if (stats.tracked >= MAX_LIVE) {
+		stats.dropped++;
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	e = live_insert(mem);
+	e->bytes = bytes;
+	e->timestamp = now;
+	e->site = site_get(caller, now);
+	stats.tracked++;
+
+	s = &sites[e->site];
+	s->live_bytes += bytes;
+	s->live_count++;
+	s->peak_bytes = MAX(s->peak_bytes, s->live_bytes);
+	s->allocs++;
+	s->last_ms = now;
+
+	k_spin_unlock(&lock, key);
+}
+
+void z_heap_prof_free(void *mem)
+{
+	struct heap_prof_site *s;
+	struct live_alloc *e;
+	k_spinlock_key_t key;
+
+	if (k_is_user_context()) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	e = live_find(mem);
+	if (e == NULL) {
+		stats.untracked_frees++;
+	} else {
+		s = &sites[e->site];
+		s->live_bytes -= e->bytes;
+		s->live_count--;
+		s->frees++;
+		live_remove(e);
+		stats.tracked--;
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+void *z_heap_prof_site_enter(void *site)
+{
+	void *prev;
+
+	if (k_is_user_context() || k_is_in_isr() || _current == NULL) {
+		return NULL;
+	}
+
+	prev = _current->heap_prof_site;
+	if (prev == NULL) {
+		_current->heap_prof_site = site;
+	}
+	return prev;
+}
+
+void z_heap_prof_site_exit(void *prev)
+{
+	if (k_is_user_context() || k_is_in_isr() || _current == NULL) {
+		return;
+	}
+
+	_current->heap_prof_site = prev;
+}
+
+void heap_prof_site_foreach(heap_prof_site_cb_t cb, void *user_data)
+{
+	struct heap_prof_site snap;
+
+	for (int i = 0; i <= NUM_SITES; i++) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		snap = sites[i];
+		k_spin_unlock(&lock, key);
+
+		if (snap.site != NULL ||
+		    (i == OTHER_SITE && snap.allocs != 0U)) {
+			cb(&snap, user_data);
+		}
+	}
+}
+
+void heap_prof_live_foreach(heap_prof_live_cb_t cb, void *user_data)
+{
+	struct live_alloc snap;
+
+	for (int i = 0; i < NUM_LIVE; i++) {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		snap = live[i];
+		k_spin_unlock(&lock, key);
+
+		if (snap.mem != NULL) {
+			cb(snap.mem, snap.bytes, sites[snap.site].site,
+			   snap.timestamp, user_data);
+		}
+	}
+}
+
+void heap_prof_stats_get(struct heap_prof_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	*out = stats;
+	k_spin_unlock(&lock, key);
+}
+
+void heap_prof_reset(void)
+{
+	uint32_t now = k_uptime_get_32();
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (int i = 0; i <= NUM_SITES; i++) {
+		sites[i].allocs = 0U;
+		sites[i].frees = 0U;
+		sites[i].peak_bytes = sites[i].live_bytes;
+		sites[i].first_ms = now;
+		sites[i].last_ms = now;
+	}
+	stats.dropped = 0U;
+	stats.untracked_frees = 0U;
+
+	k_spin_unlock(&lock, key);
+}
+
+#ifdef CONFIG_HEAP_PROFILER_SHELL
+#include <shell/shell.h>
+
+/* Allocations per second over the site's active window */
+static uint32_t site_rate(const struct heap_prof_site *s)
+{
+	uint32_t window = s->last_ms - s->first_ms;
+
+	return window == 0U ? s->allocs : s->allocs * 1000U / window;
+}
+
+static void shell_site_cb(const struct heap_prof_site *s, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, "%p %10u %6u %10u %8u %8u %6u",
+		    s->site, s->live_bytes,
+		    s->live_count, s->peak_bytes, s->allocs, s->frees,
+		    site_rate(s));
+}
+
+static int cmd_sites(const struct shell *shell, size_t argc, char **argv)
+{
+	struct heap_prof_stats st;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "site       %10s %6s %10s %8s %8s %6s",
+		    "live", "count", "peak", "allocs", "frees", "/s");
+	heap_prof_site_foreach(shell_site_cb, (void *)shell);
+
+	heap_prof_stats_get(&st);
+	shell_print(shell, "tracked %u dropped %u untracked frees %u",
+		    st.tracked, st.dropped, st.untracked_frees);
+	return 0;
+}
+
+static void shell_live_cb(void *mem, size_t bytes, void *site,
+			  uint32_t timestamp_ms, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, "%p %8zu site %p age %u ms", mem, bytes, site,
+		    k_uptime_get_32() - timestamp_ms);
+}
+
+static int cmd_live(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	heap_prof_live_foreach(shell_live_cb, (void *)shell);
+	return 0;
+}
+
+static int cmd_reset(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	heap_prof_reset();
+	return 0;
+}
+
+/* Line format parsed by scripts/heap_profiler/heap_prof_decode.py */
+static void dump_site_cb(const struct heap_prof_site *s, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, "HPROF site %p live %u count %u peak %u "
+		    "allocs %u frees %u first %u last %u",
+		    s->site, s->live_bytes, s->live_count, s->peak_bytes,
+		    s->allocs, s->frees, s->first_ms, s->last_ms);
+}
+
+static void dump_live_cb(void *mem, size_t bytes, void *site,
+			 uint32_t timestamp_ms, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, "HPROF live %p size %zu site %p t %u",
+		    mem, bytes, site, timestamp_ms);
+}
+
+static int cmd_dump(const struct shell *shell, size_t argc, char **argv)
+{
+	struct heap_prof_stats st;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	heap_prof_stats_get(&st);
+	shell_print(shell, "HPROF stats tracked %u dropped %u "
+		    "untracked %u sites %u uptime %u",
+		    st.tracked, st.dropped, st.untracked_frees, st.sites,
+		    k_uptime_get_32());
+	heap_prof_site_foreach(dump_site_cb, (void *)shell);
+	heap_prof_live_foreach(dump_live_cb, (void *)shell);
+	shell_print(shell, "HPROF end");
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_heap_prof,
+	SHELL_CMD(sites, NULL, "List call sites", cmd_sites),
+	SHELL_CMD(live, NULL, "List live allocations", cmd_live),
+	SHELL_CMD(reset, NULL, "Reset counters and peaks", cmd_reset),
+	SHELL_CMD(dump, NULL, "Dump for heap_prof_decode.py", cmd_dump),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_REGISTER(heap_prof, &sub_heap_prof,
+		   "Heap allocation profiler", NULL);
+
+#endif /* CONFIG_HEAP_PROFILER_SHELL */
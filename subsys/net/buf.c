@@ -157,12 +157,16 @@ const struct net_buf_data_cb net_buf_fixed_cb = {
 
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 
+#define HEAP_DATA_ATTR \
+	((IS_ENABLED(CONFIG_NET_BUF_HEAP_FAST) ? SYS_MHEAP_ATTR_FAST : 0) | \
+	 (IS_ENABLED(CONFIG_NET_BUF_HEAP_DMA) ? SYS_MHEAP_ATTR_DMA : 0))
+
 static uint8_t *heap_data_alloc(struct net_buf *buf, size_t *size,
 			     k_timeout_t timeout)
 {
 	uint8_t *ref_count;
 
-	ref_count = k_malloc(1 + *size);
+	ref_count = k_malloc_attr(HEAP_DATA_ATTR, 1 + *size);
 	if (!ref_count) {
 		return NULL;
 	}
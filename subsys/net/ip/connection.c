@@ -54,11 +54,30 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+/** Both end points fully specified */
+#define NET_CONN_EXACT			0x78
+
+#define CONN_HASH_SIZE			CONFIG_NET_CONN_HASH_SIZE
+
+BUILD_ASSERT((CONN_HASH_SIZE & (CONN_HASH_SIZE - 1)) == 0,
+	     "CONFIG_NET_CONN_HASH_SIZE must be a power of two");
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+/* Every used connection is also in one of the lists below, linked
+ * through its hash_node: IP connections with both end points fully
+ * specified (e.g. established TCP connections) are hashed by their
+ * 5-tuple, other IP connections with a local port (bound or listening
+ * sockets) by protocol and local port, and the rest are kept in a
+ * single wildcard list.
+ */
+static sys_slist_t conn_exact[CONN_HASH_SIZE];
+static sys_slist_t conn_port[CONN_HASH_SIZE];
+static sys_slist_t conn_wildcard;
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -113,6 +132,178 @@ void conn_register_debug(struct net_conn *conn,
 #define conn_register_debug(...)
 #endif /* (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) */
 
+/* FNV-1a */
+#define CONN_HASH_INIT 2166136261U
+
+static uint32_t conn_hash_bytes(uint32_t hash, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	while (len-- > 0) {
+		hash = (hash ^ *p++) * 16777619U;
+	}
+
+	return hash;
+}
+
+static inline bool conn_family_is_ip(uint8_t family)
+{
+	return (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET) ||
+		(IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6);
+}
+
+static inline size_t conn_addr_len(uint8_t family)
+{
+	return family == AF_INET6 ? sizeof(struct in6_addr) :
+		sizeof(struct in_addr);
+}
+
+static inline const void *conn_addr(const struct sockaddr *addr)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		return &net_sin6(addr)->sin6_addr;
+	}
+
+	return &net_sin(addr)->sin_addr;
+}
+
+/* Ports are in network byte order */
+static sys_slist_t *conn_exact_list(uint16_t proto, uint8_t family,
+				    const void *remote_addr,
+				    const void *local_addr,
+				    uint16_t remote_port,
+				    uint16_t local_port)
+{
+	size_t len = conn_addr_len(family);
+	uint32_t hash = CONN_HASH_INIT;
+
+	hash = conn_hash_bytes(hash, &proto, sizeof(proto));
+	hash = conn_hash_bytes(hash, remote_addr, len);
+	hash = conn_hash_bytes(hash, local_addr, len);
+	hash = conn_hash_bytes(hash, &remote_port, sizeof(remote_port));
+	hash = conn_hash_bytes(hash, &local_port, sizeof(local_port));
+
+	return &conn_exact[hash & (CONN_HASH_SIZE - 1)];
+}
+
+static sys_slist_t *conn_port_list(uint16_t proto, uint16_t local_port)
+{
+	uint32_t hash = CONN_HASH_INIT;
+
+	hash = conn_hash_bytes(hash, &proto, sizeof(proto));
+	hash = conn_hash_bytes(hash, &local_port, sizeof(local_port));
+
+	return &conn_port[hash & (CONN_HASH_SIZE - 1)];
+}
+
+static sys_slist_t *conn_hash_list(struct net_conn *conn)
+{
+	if (!conn_family_is_ip(conn->family)) {
+		return &conn_wildcard;
+	}
+
+	if ((conn->flags & NET_CONN_EXACT) == NET_CONN_EXACT) {
+		return conn_exact_list(conn->proto, conn->family,
+				       conn_addr(&conn->remote_addr),
+				       conn_addr(&conn->local_addr),
+				       net_sin(&conn->remote_addr)->sin_port,
+				       net_sin(&conn->local_addr)->sin_port);
+	}
+
+	if (conn->flags & NET_CONN_LOCAL_PORT_SPEC) {
+		return conn_port_list(conn->proto,
+				      net_sin(&conn->local_addr)->sin_port);
+	}
+
+	return &conn_wildcard;
+}
+
+static struct net_conn *conn_find_exact(uint16_t proto, uint8_t family,
+					const void *remote_addr,
+					const void *local_addr,
+					uint16_t remote_port,
+					uint16_t local_port)
+{
+	size_t len = conn_addr_len(family);
+	sys_slist_t *list;
+	struct net_conn *conn;
+
+	list = conn_exact_list(proto, family, remote_addr, local_addr,
+			       remote_port, local_port);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, hash_node) {
+		if (conn->proto == proto && conn->family == family &&
+		    net_sin(&conn->remote_addr)->sin_port == remote_port &&
+		    net_sin(&conn->local_addr)->sin_port == local_port &&
+		    !memcmp(conn_addr(&conn->remote_addr), remote_addr, len) &&
+		    !memcmp(conn_addr(&conn->local_addr), local_addr, len)) {
+			return conn;
+		}
+	}
+
+	return NULL;
+}
+
+struct net_conn *net_conn_find(uint16_t proto, uint8_t family,
+			       const void *remote_addr,
+			       const void *local_addr,
+			       uint16_t remote_port,
+			       uint16_t local_port)
+{
+	if (!conn_family_is_ip(family)) {
+		return NULL;
+	}
+
+	return conn_find_exact(proto, family, remote_addr, local_addr,
+			       remote_port, local_port);
+}
+
+/* Iterates over the connections which may match a received packet:
+ * either all of them, or those of a few hash lists.
+ */
+struct conn_walk {
+	sys_slist_t *lists[2];
+	int num_lists;
+	int next_list;
+	sys_snode_t *node;
+	bool hashed;
+};
+
+static void conn_walk_init(struct conn_walk *walk, bool hashed)
+{
+	walk->num_lists = 0;
+	walk->next_list = 0;
+	walk->node = NULL;
+	walk->hashed = hashed;
+}
+
+static void conn_walk_add(struct conn_walk *walk, sys_slist_t *list)
+{
+	walk->lists[walk->num_lists++] = list;
+}
+
+static struct net_conn *conn_walk_next(struct conn_walk *walk)
+{
+	if (walk->node != NULL) {
+		walk->node = sys_slist_peek_next(walk->node);
+	}
+
+	while (walk->node == NULL) {
+		if (walk->next_list == walk->num_lists) {
+			return NULL;
+		}
+
+		walk->node = sys_slist_peek_head(walk->lists[walk->next_list]);
+		walk->next_list++;
+	}
+
+	if (walk->hashed) {
+		return CONTAINER_OF(walk->node, struct net_conn, hash_node);
+	}
+
+	return CONTAINER_OF(walk->node, struct net_conn, node);
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -132,6 +323,7 @@ static void conn_set_used(struct net_conn *conn)
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	sys_slist_prepend(conn_hash_list(conn), &conn->hash_node);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -141,8 +333,11 @@ static void conn_set_unused(struct net_conn *conn)
 	sys_slist_prepend(&conn_unused, &conn->node);
 }
 
-/* Check if we already have identical connection handler installed. */
-static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
+/* Check if we already have identical connection handler installed.
+ * An identical handler is necessarily in the same hash list.
+ */
+static struct net_conn *conn_find_handler(sys_slist_t *list,
+					  uint16_t proto, uint8_t family,
 					  const struct sockaddr *remote_addr,
 					  const struct sockaddr *local_addr,
 					  uint16_t remote_port,
@@ -151,7 +346,7 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 	struct net_conn *conn;
 	struct net_conn *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(list, conn, tmp, hash_node) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -251,15 +446,9 @@ int net_conn_register(uint16_t proto, uint8_t family,
 		      struct net_conn_handle **handle)
 {
 	struct net_conn *conn;
+	struct net_conn *found;
 	uint8_t flags = 0U;
 
-	conn = conn_find_handler(proto, family, remote_addr, local_addr,
-				 remote_port, local_port);
-	if (conn) {
-		NET_ERR("Identical connection handler %p already found.", conn);
-		return -EALREADY;
-	}
-
 	conn = conn_get_unused();
 	if (!conn) {
 		return -ENOENT;
@@ -351,6 +540,16 @@ int net_conn_register(uint16_t proto, uint8_t family,
 	conn->family = family;
 	conn->context = context;
 
+	found = conn_find_handler(conn_hash_list(conn), proto, family,
+				  remote_addr, local_addr, remote_port,
+				  local_port);
+	if (found) {
+		NET_ERR("Identical connection handler %p already found.",
+			found);
+		conn_set_unused(conn);
+		return -EALREADY;
+	}
+
 	if (handle) {
 		*handle = (struct net_conn_handle *)conn;
 	}
@@ -380,6 +579,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	sys_slist_find_and_remove(conn_hash_list(conn), &conn->hash_node);
 
 	conn_set_unused(conn);
 
@@ -558,6 +758,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
+	struct conn_walk walk;
 	struct net_conn *conn;
 	enum net_verdict ret;
 	uint16_t src_port;
@@ -623,7 +824,45 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	/* A unicast UDP or TCP packet can only match a connection of its
+	 * 5-tuple, one with its destination port, or a wildcard one.  If
+	 * there is a connection of its 5-tuple, it ranks first anyway.
+	 */
+	if (!is_mcast_pkt && !is_bcast_pkt &&
+	    conn_family_is_ip(net_pkt_family(pkt)) &&
+	    ((IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) ||
+	     (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP))) {
+		const void *src, *dst;
+
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    net_pkt_family(pkt) == AF_INET6) {
+			src = &ip_hdr->ipv6->src;
+			dst = &ip_hdr->ipv6->dst;
+		} else {
+			src = &ip_hdr->ipv4->src;
+			dst = &ip_hdr->ipv4->dst;
+		}
+
+		conn_walk_init(&walk, true);
+
+		conn = conn_find_exact(proto, net_pkt_family(pkt), src, dst,
+				       src_port, dst_port);
+		if (conn != NULL &&
+		    !(conn->context != NULL &&
+		      net_context_is_bound_to_iface(conn->context) &&
+		      net_pkt_iface(pkt) !=
+		      net_context_get_iface(conn->context))) {
+			best_match = conn;
+		} else {
+			conn_walk_add(&walk, conn_port_list(proto, dst_port));
+			conn_walk_add(&walk, &conn_wildcard);
+		}
+	} else {
+		conn_walk_init(&walk, false);
+		conn_walk_add(&walk, &conn_used);
+	}
+
+	while ((conn = conn_walk_next(&walk)) != NULL) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
 		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
@@ -655,6 +894,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 			 * in this packet.
 			 */
 			if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
+			    net_pkt_family(pkt) == AF_PACKET &&
 			    conn->family != AF_PACKET) {
 				raw_pkt_continue = true;
 			}
@@ -853,6 +1093,12 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_exact[i]);
+		sys_slist_init(&conn_port[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -51,6 +51,9 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Internal slist node of the connection's hash list */
+	sys_snode_t hash_node;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -149,6 +152,27 @@ static inline int net_conn_unregister(struct net_conn_handle *handle)
 }
 #endif
 
+/**
+ * @brief Find the connection handler of a 5-tuple.
+ *
+ * Only handlers registered with both end points fully specified, such as
+ * those of established TCP connections, are found.
+ *
+ * @param proto Protocol for the connection (UDP or TCP)
+ * @param family Protocol family (AF_INET or AF_INET6)
+ * @param remote_addr Remote IP address, struct in_addr or struct in6_addr
+ * @param local_addr Local IP address, struct in_addr or struct in6_addr
+ * @param remote_port Remote port, in network byte order
+ * @param local_port Local port, in network byte order
+ *
+ * @return The connection handler, NULL if there is none.
+ */
+struct net_conn *net_conn_find(uint16_t proto, uint8_t family,
+			       const void *remote_addr,
+			       const void *local_addr,
+			       uint16_t remote_port,
+			       uint16_t local_port);
+
 /**
  * @brief Change the callback and user_data for a registered connection
  * handle.
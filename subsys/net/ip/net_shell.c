@@ -1471,11 +1471,11 @@ static void tcp_cb(struct tcp *conn, void *user_data)
 	int *count = data->user_data;
 	uint16_t recv_mss = net_tcp_get_recv_mss(conn);
 
-	PR("%p %p   %5u    %5u %10u %10u %5u   %s\n",
+	PR("%p %p   %5u    %5u %10u %10u %5u %6u %5u   %s\n",
 	   conn, conn->context,
 	   ntohs(net_sin6_ptr(&conn->context->local)->sin6_port),
 	   ntohs(net_sin6(&conn->context->remote)->sin6_port),
-	   conn->seq, conn->ack, recv_mss,
+	   conn->seq, conn->ack, recv_mss, conn->cwnd, conn->rto,
 	   net_tcp_state_str(net_tcp_get_state(conn)));
 
 	(*count)++;
@@ -2031,7 +2031,7 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 
 #if defined(CONFIG_NET_TCP)
 	PR("\nTCP        Context   Src port Dst port   "
-	   "Send-Seq   Send-Ack  MSS    State\n");
+	   "Send-Seq   Send-Ack  MSS   Cwnd   RTO   State\n");
 
 	count = 0;
 
@@ -30,22 +30,33 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #define ACK_TIMEOUT K_MSEC(ACK_TIMEOUT_MS)
 #define FIN_TIMEOUT_MS MSEC_PER_SEC
 #define FIN_TIMEOUT K_MSEC(FIN_TIMEOUT_MS)
+#define RTO_MAX_MS (60 * MSEC_PER_SEC)
+#define FAST_RETRANSMIT_DUP_ACKS 3
+/* Timestamps of idle connections are not checked, RFC 7323 chapter 5.5 */
+#define TCP_PAWS_IDLE_MS (24U * 24U * 3600U * MSEC_PER_SEC)
 
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
-static int tcp_window = NET_IPV6_MTU;
+static int tcp_window = CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE ?
+	CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE : NET_IPV6_MTU;
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
+/* Protects the tcp_conns list only, each connection has its own lock */
 static K_MUTEX_DEFINE(tcp_lock);
 
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
-static struct k_work_q tcp_work_q;
-static K_KERNEL_STACK_DEFINE(work_q_stack, CONFIG_NET_TCP_WORKQ_STACK_SIZE);
+#define TCP_WORKQ_COUNT CONFIG_NET_TCP_WORKQ_COUNT
+#define MAX_NAME_LEN sizeof("tcp_work[y]")
+
+static struct k_work_q tcp_work_q[TCP_WORKQ_COUNT];
+static K_KERNEL_STACK_ARRAY_DEFINE(work_q_stack, TCP_WORKQ_COUNT,
+				   CONFIG_NET_TCP_WORKQ_STACK_SIZE);
 
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt);
+uint16_t net_tcp_get_recv_mss(const struct tcp *conn);
 
 int (*tcp_send_cb)(struct net_pkt *pkt) = NULL;
 size_t (*tcp_recv_cb)(struct tcp *conn, struct net_pkt *pkt) = NULL;
@@ -352,38 +363,28 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-#define tcp_conn_unref(conn)				\
-	tcp_conn_unref_debug(conn, __func__, __LINE__)
-
-static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
-#else
-static int tcp_conn_unref(struct tcp *conn)
-#endif
+/* Drops a reference, the connection is released with the last one. The
+ * count only reaches zero with tcp_lock held, together with the removal
+ * from tcp_conns, so tcp_conn_search() never finds a released connection.
+ */
+static int tcp_conn_release(struct tcp *conn)
 {
-	int ref_count = atomic_get(&conn->ref_count);
 	struct net_pkt *pkt;
+	int ref_count;
 
-#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
-	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
-		caller, line);
-#endif
+	k_mutex_lock(&tcp_lock, K_FOREVER);
 
-#if !defined(CONFIG_NET_TEST_PROTOCOL)
-	if (conn->in_connect) {
-		NET_DBG("conn: %p is waiting on connect semaphore", conn);
-		tcp_send_queue_flush(conn);
-		goto out;
+	ref_count = atomic_dec(&conn->ref_count) - 1;
+	if (ref_count == 0) {
+		sys_slist_find_and_remove(&tcp_conns, &conn->next);
 	}
-#endif /* CONFIG_NET_TEST_PROTOCOL */
 
-	k_mutex_lock(&tcp_lock, K_FOREVER);
+	k_mutex_unlock(&tcp_lock);
 
-	ref_count = atomic_dec(&conn->ref_count) - 1;
 	if (ref_count) {
 		tp_out(net_context_get_family(conn->context), conn->iface,
 		       "TP_TRACE", "event", "CONN_DELETE");
-		goto unlock;
+		goto out;
 	}
 
 	/* If there is any pending data, pass that to application */
@@ -422,19 +423,42 @@ static int tcp_conn_unref(struct tcp *conn)
 
 	k_delayed_work_cancel(&conn->timewait_timer);
 	k_delayed_work_cancel(&conn->fin_timer);
-
-	sys_slist_find_and_remove(&tcp_conns, &conn->next);
+	k_delayed_work_cancel(&conn->ack_timer);
 
 	memset(conn, 0, sizeof(*conn));
 
 	k_mem_slab_free(&tcp_conns_slab, (void **)&conn);
-
-unlock:
-	k_mutex_unlock(&tcp_lock);
 out:
 	return ref_count;
 }
 
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+#define tcp_conn_unref(conn)				\
+	tcp_conn_unref_debug(conn, __func__, __LINE__)
+
+static int tcp_conn_unref_debug(struct tcp *conn, const char *caller, int line)
+#else
+static int tcp_conn_unref(struct tcp *conn)
+#endif
+{
+	int ref_count = atomic_get(&conn->ref_count);
+
+#if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
+	NET_DBG("conn: %p, ref_count=%d (%s():%d)", conn, ref_count,
+		caller, line);
+#endif
+
+#if !defined(CONFIG_NET_TEST_PROTOCOL)
+	if (conn->in_connect) {
+		NET_DBG("conn: %p is waiting on connect semaphore", conn);
+		tcp_send_queue_flush(conn);
+		return ref_count;
+	}
+#endif /* CONFIG_NET_TEST_PROTOCOL */
+
+	return tcp_conn_release(conn);
+}
+
 int net_tcp_unref(struct net_context *context)
 {
 	int ref_count = 0;
@@ -497,7 +521,7 @@ static bool tcp_send_process_no_lock(struct tcp *conn)
 	}
 
 	if (conn->in_retransmission) {
-		k_delayed_work_submit_to_queue(&tcp_work_q, &conn->send_timer,
+		k_delayed_work_submit_to_queue(conn->work_q, &conn->send_timer,
 					       K_MSEC(tcp_rto));
 	}
 
@@ -542,7 +566,7 @@ static void tcp_send_timer_cancel(struct tcp *conn)
 		conn->in_retransmission = false;
 	} else {
 		conn->send_retries = tcp_retries;
-		k_delayed_work_submit_to_queue(&tcp_work_q, &conn->send_timer,
+		k_delayed_work_submit_to_queue(conn->work_q, &conn->send_timer,
 					       K_MSEC(tcp_rto));
 	}
 }
@@ -613,8 +637,13 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
+	/* The MSS is only sent in SYN segments and kept for the whole
+	 * connection, the other options only apply to this segment.
+	 */
 	recv_options->wnd_found = false;
+	recv_options->sack_perm_found = false;
+	recv_options->ts_found = false;
+	recv_options->sack_count = 0U;
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -658,9 +687,48 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = options[2];
 			recv_options->wnd_found = true;
 			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != TCPOLEN_SACK_PERM) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case TCPOPT_SACK:
+			if (opt_len < 2 + TCPOLEN_SACK_BLOCK ||
+			    (opt_len - 2) % TCPOLEN_SACK_BLOCK) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 2; i < opt_len; i += TCPOLEN_SACK_BLOCK) {
+				uint8_t n = recv_options->sack_count;
+
+				if (n == TCP_SACK_BLOCKS) {
+					break;
+				}
+
+				recv_options->sack[n].start =
+					sys_get_be32(options + i);
+				recv_options->sack[n].end =
+					sys_get_be32(options + i + 4);
+				recv_options->sack_count++;
+			}
+			break;
+		case TCPOPT_TIMESTAMP:
+			if (opt_len != TCPOLEN_TIMESTAMP) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->tsval = sys_get_be32(options + 2);
+			recv_options->tsecr = sys_get_be32(options + 6);
+			recv_options->ts_found = true;
+			break;
 		default:
 			continue;
 		}
@@ -755,11 +823,95 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Our timestamp clock ticks in milliseconds, RFC 7323 chapter 5.4 */
+static uint32_t tcp_ts_now(struct tcp *conn)
+{
+	return k_uptime_get_32() + conn->ts_offset;
+}
+
+/* Options of an outgoing segment. The SYN offers the options enabled in
+ * Kconfig, which are then only kept if the peer's SYN has them too.
+ */
+static size_t tcp_options_write(struct tcp *conn, uint8_t flags, bool data,
+				uint8_t *opts)
+{
+	uint8_t *p = opts;
+
+	if (flags & RST) {
+		return 0;
+	}
+
+	if (flags & SYN) {
+		*p++ = TCPOPT_MAXSEG;
+		*p++ = TCPOLEN_MAXSEG;
+		sys_put_be16(net_tcp_get_recv_mss(conn), p);
+		p += 2;
+
+		if (conn->wscale_ok) {
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_WINDOW;
+			*p++ = TCPOLEN_WINDOW;
+			*p++ = conn->rcv_wscale;
+		}
+
+		if (conn->sack_ok) {
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_SACK_PERM;
+			*p++ = TCPOLEN_SACK_PERM;
+		}
+	}
+
+	if (conn->ts_ok) {
+		*p++ = TCPOPT_NOP;
+		*p++ = TCPOPT_NOP;
+		*p++ = TCPOPT_TIMESTAMP;
+		*p++ = TCPOLEN_TIMESTAMP;
+		sys_put_be32(tcp_ts_now(conn), p);
+		sys_put_be32((flags & ACK) ? conn->ts_recent : 0U, p + 4);
+		p += 8;
+	}
+
+	/* Report the out-of-order data we hold, RFC 2018 chapter 4. Data
+	 * segments are sized for the timestamps only, so the block is
+	 * sent with pure ACKs.
+	 */
+	if (conn->sack_ok && !data && (flags & ACK) && !(flags & SYN) &&
+	    conn->queue_recv_data &&
+	    !net_pkt_is_empty(conn->queue_recv_data)) {
+		uint32_t start = tcp_get_seq(conn->queue_recv_data->buffer);
+
+		*p++ = TCPOPT_NOP;
+		*p++ = TCPOPT_NOP;
+		*p++ = TCPOPT_SACK;
+		*p++ = 2 + TCPOLEN_SACK_BLOCK;
+		sys_put_be32(start, p);
+		sys_put_be32(start + net_pkt_get_len(conn->queue_recv_data),
+			     p + 4);
+		p += 8;
+	}
+
+	return p - opts;
+}
+
+/* The window of SYN segments is never scaled, RFC 7323 chapter 2.2 */
+static uint16_t tcp_win_field(struct tcp *conn, uint8_t flags)
+{
+	uint32_t win = conn->recv_win;
+
+	if (!(flags & SYN)) {
+		win >>= conn->rcv_wscale;
+	}
+
+	return MIN(win, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *opts, size_t opts_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
@@ -770,16 +922,21 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + opts_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_win_field(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret < 0 || opts_len == 0) {
+		return ret;
+	}
+
+	return net_pkt_write(pkt, opts, opts_len);
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -802,10 +959,12 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	uint8_t opts[TCP_OPTIONS_MAX];
+	size_t opts_len = tcp_options_write(conn, flags, data != NULL, opts);
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + opts_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
@@ -823,7 +982,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, opts, opts_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
@@ -835,6 +994,12 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
+	if ((flags & ACK) && conn->ack_pending) {
+		/* The delayed ACK is carried by this segment */
+		conn->ack_pending = 0U;
+		k_delayed_work_cancel(&conn->ack_timer);
+	}
+
 	NET_DBG("%s", log_strdup(tcp_th(pkt)));
 
 	if (tcp_send_cb) {
@@ -888,9 +1053,17 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+/* At most the smaller of the congestion window and the peer's receive
+ * window can be in flight, RFC 5681 chapter 3.
+ */
+static int tcp_send_window(struct tcp *conn)
+{
+	return MIN((uint32_t)conn->send_win, conn->cwnd);
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !(conn->unacked_len < tcp_send_window(conn));
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -915,17 +1088,126 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Largest data segment, as the MSS does not cover options (RFC 6691) */
+static int tcp_seg_max(struct tcp *conn)
+{
+	return conn_mss(conn) - (conn->ts_ok ? 2 + TCPOLEN_TIMESTAMP : 0);
+}
+
+/* If the peer has SACKed seq, returns the end of its block */
+static bool tcp_sacked(struct tcp *conn, uint32_t seq, uint32_t *end)
+{
+	for (int i = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(seq, conn->sacked[i].start) >= 0 &&
+		    net_tcp_seq_cmp(seq, conn->sacked[i].end) < 0) {
+			*end = conn->sacked[i].end;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* How much of the len bytes at seq come before the next SACKed data */
+static int tcp_unsacked_len(struct tcp *conn, uint32_t seq, int len)
+{
+	for (int i = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(conn->sacked[i].start, seq) > 0) {
+			return MIN(len, (int)(conn->sacked[i].start - seq));
+		}
+	}
+
+	return len;
+}
+
+/* Adds a block to the scoreboard, which is kept sorted and merged. When
+ * it is full, the highest block is dropped, as holes are resent from
+ * the lowest one.
+ */
+static int tcp_sack_insert(struct tcp_sack_block *sb, int n, uint32_t start,
+			   uint32_t end)
+{
+	int i = 0, j;
+
+	while (i < n && net_tcp_seq_cmp(sb[i].end, start) < 0) {
+		i++;
+	}
+
+	for (j = i; j < n && net_tcp_seq_cmp(sb[j].start, end) <= 0; j++) {
+		if (net_tcp_seq_cmp(sb[j].start, start) < 0) {
+			start = sb[j].start;
+		}
+
+		if (net_tcp_seq_cmp(sb[j].end, end) > 0) {
+			end = sb[j].end;
+		}
+	}
+
+	if (j == i) {
+		if (n == TCP_SACK_BLOCKS) {
+			if (i == n) {
+				return n;
+			}
+			n--;
+		}
+
+		memmove(&sb[i + 1], &sb[i], (n - i) * sizeof(*sb));
+		n++;
+	} else {
+		memmove(&sb[i + 1], &sb[j], (n - j) * sizeof(*sb));
+		n -= j - i - 1;
+	}
+
+	sb[i].start = start;
+	sb[i].end = end;
+
+	return n;
+}
+
+/* Merges the SACK blocks of an ACK into the scoreboard, RFC 2018 */
+static void tcp_sack_update(struct tcp *conn)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	struct tcp_sack_block *sb = conn->sacked;
+	uint32_t max = conn->seq + conn->send_data_total;
+	int n = 0;
+
+	/* Forget the data which has been acked meanwhile */
+	for (int i = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(sb[i].end, conn->seq) > 0) {
+			sb[n].start = net_tcp_seq_cmp(sb[i].start,
+						      conn->seq) > 0 ?
+				sb[i].start : conn->seq;
+			sb[n].end = sb[i].end;
+			n++;
+		}
+	}
+
+	for (int i = 0; i < opts->sack_count; i++) {
+		uint32_t start = opts->sack[i].start;
+		uint32_t end = opts->sack[i].end;
+
+		/* Ignore blocks outside of the data in flight */
+		if (net_tcp_seq_cmp(start, conn->seq) < 0 ||
+		    net_tcp_seq_cmp(end, start) <= 0 ||
+		    net_tcp_seq_cmp(end, max) > 0) {
+			continue;
+		}
+
+		n = tcp_sack_insert(sb, n, start, end);
+	}
+
+	conn->sacked_count = n;
+}
+
+/* Send len bytes of the send_data queue, starting pos bytes after the
+ * oldest unacked byte.
+ */
+static int tcp_send_segment(struct tcp *conn, int pos, int len, bool resend)
 {
 	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
 
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
@@ -940,11 +1222,9 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
 	if (ret == 0) {
-		conn->unacked_len += len;
-
-		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		if (resend) {
 			net_stats_update_tcp_resent(conn->iface, len);
 			net_stats_update_tcp_seg_rexmit(conn->iface);
 		} else {
@@ -959,12 +1239,71 @@ static int tcp_send_data(struct tcp *conn)
 	 */
 	tcp_pkt_unref(pkt);
 
+ out:
+	return ret;
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	uint32_t seq, end;
+	int ret;
+	int len;
+
+	/* Data the peer has received out of order is not sent again */
+	while (tcp_sacked(conn, conn->seq + conn->unacked_len, &end)) {
+		conn->unacked_len = MIN(end - conn->seq,
+					conn->send_data_total);
+	}
+
+	seq = conn->seq + conn->unacked_len;
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   tcp_send_window(conn) - conn->unacked_len,
+		   tcp_seg_max(conn));
+	len = tcp_unsacked_len(conn, seq, len);
+	if (len <= 0) {
+		return 0;
+	}
+
+	ret = tcp_send_segment(conn, conn->unacked_len, len,
+			       conn->data_mode == TCP_DATA_MODE_RESEND);
+	if (ret == 0) {
+		conn->unacked_len += len;
+
+		/* Time one segment per round trip. Segments sent again
+		 * after a loss are not timed, as their ACK would be
+		 * ambiguous (Karn's algorithm).
+		 */
+		if (!conn->rtt_pending && len > 0 &&
+		    conn->data_mode == TCP_DATA_MODE_SEND &&
+		    net_tcp_seq_cmp(seq, conn->recover) > 0) {
+			conn->rtt_pending = true;
+			conn->rtt_seq = seq + len;
+			conn->rtt_start = k_uptime_get_32();
+		}
+	}
+
 	conn_send_data_dump(conn);
 
- out:
 	return ret;
 }
 
+/* Nagle's algorithm, RFC 1122 chapter 4.2.3.4: a partial segment waits
+ * until all the data in flight is acked, unless TCP_NODELAY is set. With
+ * TCP_CORK it waits until the option is cleared, there is no time limit.
+ */
+static bool tcp_nagle_hold(struct tcp *conn)
+{
+	if (tcp_unsent_len(conn) >= tcp_seg_max(conn)) {
+		return false;
+	}
+
+	if (conn->cork) {
+		return true;
+	}
+
+	return !conn->nodelay && conn->unacked_len > 0;
+}
+
 /* Send all queued but unsent data from the send_data packet by packet
  * until the receiver's window is full. */
 static int tcp_send_queued_data(struct tcp *conn)
@@ -983,6 +1322,10 @@ static int tcp_send_queued_data(struct tcp *conn)
 			break;
 		}
 
+		if (tcp_nagle_hold(conn)) {
+			break;
+		}
+
 		ret = tcp_send_data(conn);
 		if (ret < 0) {
 			break;
@@ -1007,9 +1350,9 @@ static int tcp_send_queued_data(struct tcp *conn)
 
 	if (subscribe) {
 		conn->send_data_retries = 0;
-		k_delayed_work_submit_to_queue(&tcp_work_q,
+		k_delayed_work_submit_to_queue(conn->work_q,
 					       &conn->send_data_timer,
-					       K_MSEC(tcp_rto));
+					       K_MSEC(conn->rto));
 	}
  out:
 	return ret;
@@ -1047,6 +1390,23 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	/* Everything sent so far is in doubt, RFC 6582 chapter 4 */
+	if (net_tcp_seq_cmp(conn->seq + conn->unacked_len - 1,
+			    conn->recover) > 0) {
+		conn->recover = conn->seq + conn->unacked_len - 1;
+	}
+
+	tcp_cc_congestion(conn, true);
+	conn->in_recovery = false;
+	conn->dup_acks = 0U;
+	conn->rtt_pending = false;
+
+	/* The receiver may have discarded the data it SACKed, so resend
+	 * everything from the left edge, RFC 2018 chapter 8.
+	 */
+	conn->sacked_count = 0U;
+	conn->sack_rexmit = conn->seq;
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1058,7 +1418,7 @@ static void tcp_resend_data(struct k_work *work)
 			NET_DBG("TCP connection in active close, "
 				"not disposing yet (waiting %dms)",
 				FIN_TIMEOUT_MS);
-			k_delayed_work_submit_to_queue(&tcp_work_q,
+			k_delayed_work_submit_to_queue(conn->work_q,
 						       &conn->fin_timer,
 						       FIN_TIMEOUT);
 
@@ -1074,8 +1434,11 @@ static void tcp_resend_data(struct k_work *work)
 		}
 	}
 
-	k_delayed_work_submit_to_queue(&tcp_work_q, &conn->send_data_timer,
-				       K_MSEC(tcp_rto));
+	/* Back off the timer, RFC 6298 chapter 5 */
+	conn->rto = MIN(conn->rto * 2U, RTO_MAX_MS);
+
+	k_delayed_work_submit_to_queue(conn->work_q, &conn->send_data_timer,
+				       K_MSEC(conn->rto));
 
  out:
 	k_mutex_unlock(&conn->lock);
@@ -1085,6 +1448,19 @@ static void tcp_resend_data(struct k_work *work)
 	}
 }
 
+static void tcp_send_delayed_ack(struct k_work *work)
+{
+	struct tcp *conn = CONTAINER_OF(work, struct tcp, ack_timer);
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->ack_pending) {
+		tcp_out(conn, ACK);
+	}
+
+	k_mutex_unlock(&conn->lock);
+}
+
 static void tcp_timewait_timeout(struct k_work *work)
 {
 	struct tcp *conn = CONTAINER_OF(work, struct tcp, timewait_timer);
@@ -1126,6 +1502,61 @@ static void tcp_conn_ref(struct tcp *conn)
 	NET_DBG("conn: %p, ref_count: %d", conn, ref_count);
 }
 
+/* Takes a reference unless the connection is being released */
+static bool tcp_conn_tryref(struct tcp *conn)
+{
+	atomic_val_t ref_count;
+
+	do {
+		ref_count = atomic_get(&conn->ref_count);
+		if (ref_count == 0) {
+			return false;
+		}
+	} while (!atomic_cas(&conn->ref_count, ref_count, ref_count + 1));
+
+	return true;
+}
+
+/* Packets of a connection are always processed by the same work queue,
+ * picked by a FNV-1a hash of its end points.
+ */
+static void tcp_conn_set_work_q(struct tcp *conn)
+{
+#if TCP_WORKQ_COUNT > 1
+	size_t len = tcp_endpoint_len(conn->src.sa.sa_family);
+	const uint8_t *src = (const uint8_t *)&conn->src;
+	const uint8_t *dst = (const uint8_t *)&conn->dst;
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ src[i]) * 16777619U;
+		hash = (hash ^ dst[i]) * 16777619U;
+	}
+
+	conn->work_q = &tcp_work_q[hash % TCP_WORKQ_COUNT];
+#else
+	ARG_UNUSED(conn);
+#endif
+}
+
+#if TCP_WORKQ_COUNT > 1
+static void tcp_recv_work(struct k_work *work)
+{
+	struct tcp *conn = CONTAINER_OF(work, struct tcp, rx_work);
+	struct net_pkt *pkt;
+
+	/* Each queued packet holds a reference to the connection */
+	while ((pkt = k_fifo_get(&conn->rx_queue, K_NO_WAIT)) != NULL) {
+		tcp_in(conn, pkt);
+		net_pkt_unref(pkt);
+
+		if (tcp_conn_release(conn) == 0) {
+			break;
+		}
+	}
+}
+#endif
+
 static struct tcp *tcp_conn_alloc(void)
 {
 	struct tcp *conn = NULL;
@@ -1160,13 +1591,28 @@ static struct tcp *tcp_conn_alloc(void)
 
 	conn->in_connect = false;
 	conn->state = TCP_LISTEN;
+	conn->work_q = &tcp_work_q[0];
 	conn->recv_win = tcp_window;
+	conn->rto = tcp_rto;
+
+	/* Options offered in the SYN, see tcp_options_negotiate() */
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE);
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK);
+	conn->ts_ok = IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS);
+	conn->ts_offset = sys_rand32_get();
+
+	while (conn->rcv_wscale < TCP_WSCALE_MAX &&
+	       (conn->recv_win >> conn->rcv_wscale) > UINT16_MAX) {
+		conn->rcv_wscale++;
+	}
 
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
 	 */
 	conn->seq = 0U;
 
+	tcp_cc_init(conn);
+
 	sys_slist_init(&conn->send_queue);
 
 	k_delayed_work_init(&conn->send_timer, tcp_send_process);
@@ -1174,10 +1620,14 @@ static struct tcp *tcp_conn_alloc(void)
 	k_delayed_work_init(&conn->fin_timer, tcp_fin_timeout);
 	k_delayed_work_init(&conn->send_data_timer, tcp_resend_data);
 	k_delayed_work_init(&conn->recv_queue_timer, tcp_cleanup_recv_queue);
+	k_delayed_work_init(&conn->ack_timer, tcp_send_delayed_ack);
 
-	tcp_conn_ref(conn);
+#if TCP_WORKQ_COUNT > 1
+	k_fifo_init(&conn->rx_queue);
+	k_work_init(&conn->rx_work, tcp_recv_work);
+#endif
 
-	sys_slist_append(&tcp_conns, &conn->next);
+	tcp_conn_ref(conn);
 out:
 	NET_DBG("conn: %p", conn);
 
@@ -1195,24 +1645,22 @@ fail:
 
 int net_tcp_get(struct net_context *context)
 {
-	int ret = 0;
 	struct tcp *conn;
 
-	k_mutex_lock(&tcp_lock, K_FOREVER);
-
 	conn = tcp_conn_alloc();
 	if (conn == NULL) {
-		ret = -ENOMEM;
-		goto out;
+		return -ENOMEM;
 	}
 
 	/* Mutually link the net_context and tcp connection */
 	conn->context = context;
 	context->tcp = conn;
-out:
+
+	k_mutex_lock(&tcp_lock, K_FOREVER);
+	sys_slist_append(&tcp_conns, &conn->next);
 	k_mutex_unlock(&tcp_lock);
 
-	return ret;
+	return 0;
 }
 
 static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
@@ -1233,21 +1681,70 @@ static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
 		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
 }
 
+static const void *tcp_endpoint_addr(union tcp_endpoint *ep)
+{
+	if (ep->sa.sa_family == AF_INET6) {
+		return &ep->sin6.sin6_addr;
+	}
+
+	return &ep->sin.sin_addr;
+}
+
+/* Returns the connection of the packet with a reference taken, to be
+ * dropped with tcp_conn_release().
+ */
 static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	bool found = false;
+	union tcp_endpoint src, dst;
+	struct net_conn *net_conn;
+	struct tcp *stale = NULL;
+	struct tcp *found = NULL;
 	struct tcp *conn;
-	struct tcp *tmp;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_SRC) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_DST) < 0) {
+		return NULL;
+	}
+
+	k_mutex_lock(&tcp_lock, K_FOREVER);
 
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
+	/* Connections normally register their connection handler with
+	 * both end points, so a hash lookup of the packet's 5-tuple finds
+	 * them. The connection may be released concurrently, so it is
+	 * only compared once referenced.
+	 */
+	net_conn = net_conn_find(IPPROTO_TCP, src.sa.sa_family,
+				 tcp_endpoint_addr(&src),
+				 tcp_endpoint_addr(&dst),
+				 src.sin.sin_port, dst.sin.sin_port);
+	if (net_conn != NULL && net_conn->context != NULL) {
+		conn = net_conn->context->tcp;
+		if (conn != NULL && tcp_conn_tryref(conn)) {
+			if (tcp_conn_cmp(conn, pkt)) {
+				found = conn;
+				goto out;
+			}
+			stale = conn;
+		}
+	}
+
+	/* Those with a wildcard local address, and those created by the
+	 * test protocol, are not hashed by their 5-tuple.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp_conns, conn, next) {
+		if (tcp_conn_cmp(conn, pkt) && tcp_conn_tryref(conn)) {
+			found = conn;
 			break;
 		}
 	}
+out:
+	k_mutex_unlock(&tcp_lock);
+
+	if (stale != NULL) {
+		tcp_conn_release(stale);
+	}
 
-	return found ? conn : NULL;
+	return found;
 }
 
 static struct tcp *tcp_conn_new(struct net_pkt *pkt);
@@ -1280,13 +1777,29 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 			goto in;
 		}
 
+		/* Referenced for the input as if found by tcp_conn_search() */
+		tcp_conn_ref(conn);
+
 		net_ipaddr_copy(&conn_old->context->remote, &conn->dst.sa);
 
 		conn->accepted_conn = conn_old;
+		conn->nodelay = conn_old->nodelay;
+		conn->cork = conn_old->cork;
 	}
  in:
 	if (conn) {
+#if TCP_WORKQ_COUNT > 1
+		/* Hand the packet over to the work queue of the connection,
+		 * so that independent connections are processed in parallel.
+		 * The packet takes over the reference to the connection.
+		 */
+		net_pkt_ref(pkt);
+		k_fifo_put(&conn->rx_queue, pkt);
+		k_work_submit_to_queue(conn->work_q, &conn->rx_work);
+#else
 		tcp_in(conn, pkt);
+		tcp_conn_release(conn);
+#endif
 	}
 
 	return NET_DROP;
@@ -1424,6 +1937,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		goto err;
 	}
 
+	tcp_conn_set_work_q(conn);
+
 	NET_DBG("conn: src: %s, dst: %s",
 		log_strdup(net_sprint_addr(conn->src.sa.sa_family,
 				(const void *)&conn->src.sin.sin_addr)),
@@ -1582,23 +2097,48 @@ static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 		pkt->buffer = NULL;
 
 		if (!k_delayed_work_pending(&conn->recv_queue_timer)) {
-			k_delayed_work_submit_to_queue(&tcp_work_q,
+			k_delayed_work_submit_to_queue(conn->work_q,
 						       &conn->recv_queue_timer,
 						       K_MSEC(CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT));
 		}
 	}
 }
 
+/* Delayed ACK, RFC 1122 chapter 4.2.3.2. At least every second full-sized
+ * segment is acked at once, and data filling a hole in the receive queue
+ * too (RFC 5681 chapter 4.2). Other data is acked by the next outgoing
+ * segment, or when the timer expires.
+ */
+static void tcp_ack_data(struct tcp *conn, size_t len, bool now)
+{
+	conn->ack_pending += len;
+
+	if (CONFIG_NET_TCP_ACK_DELAY && !now &&
+	    conn->ack_pending < 2U * net_tcp_get_recv_mss(conn)) {
+		if (!k_delayed_work_pending(&conn->ack_timer)) {
+			k_delayed_work_submit_to_queue(conn->work_q,
+					&conn->ack_timer,
+					K_MSEC(CONFIG_NET_TCP_ACK_DELAY));
+		}
+		return;
+	}
+
+	tcp_out(conn, ACK);
+}
+
 static bool tcp_data_received(struct tcp *conn, struct net_pkt *pkt,
 			      size_t *len)
 {
+	bool hole = CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
+		!net_pkt_is_empty(conn->queue_recv_data);
+
 	if (tcp_data_get(conn, pkt, len) < 0) {
 		return false;
 	}
 
 	net_stats_update_tcp_seg_recv(conn->iface);
 	conn_ack(conn, *len);
-	tcp_out(conn, ACK);
+	tcp_ack_data(conn, *len, hole);
 
 	return true;
 }
@@ -1620,6 +2160,220 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
 }
 
+/* RFC 6298 chapter 2 */
+static void tcp_rtt_sample(struct tcp *conn, uint32_t rtt)
+{
+	rtt = MAX(rtt, 1U);
+
+	if (conn->srtt == 0U) {
+		conn->srtt = rtt << 3;
+		conn->rttvar = rtt << 1;
+	} else {
+		int32_t delta = (int32_t)rtt - (int32_t)(conn->srtt >> 3);
+
+		/* RTTVAR = 3/4 RTTVAR + 1/4 |delta|, SRTT = 7/8 SRTT + 1/8 R */
+		conn->rttvar += abs(delta) - (conn->rttvar >> 2);
+		conn->srtt += delta;
+	}
+
+	conn->rto = CLAMP((conn->srtt >> 3) + MAX(conn->rttvar, 1U),
+			  (uint32_t)tcp_rto, RTO_MAX_MS);
+
+	NET_DBG("conn: %p rtt=%u srtt=%u rttvar=%u rto=%u", conn, rtt,
+		conn->srtt >> 3, conn->rttvar >> 2, conn->rto);
+}
+
+/* Resend the oldest unacked data, up to the first SACKed block */
+static void tcp_resend_first(struct tcp *conn)
+{
+	int len = tcp_unsacked_len(conn, conn->seq,
+				   MIN(conn->unacked_len, tcp_seg_max(conn)));
+
+	if (len <= 0 || tcp_send_segment(conn, 0, len, true) < 0) {
+		return;
+	}
+
+	if (net_tcp_seq_cmp(conn->seq + len, conn->sack_rexmit) > 0) {
+		conn->sack_rexmit = conn->seq + len;
+	}
+}
+
+/* Resend the next hole below the highest SACKed data, a simplified
+ * NextSeg() of RFC 6675 chapter 4.
+ */
+static bool tcp_sack_resend_hole(struct tcp *conn)
+{
+	uint32_t seq = conn->sack_rexmit;
+	uint32_t end;
+	int len;
+
+	if (conn->sacked_count == 0U) {
+		return false;
+	}
+
+	if (net_tcp_seq_cmp(seq, conn->seq) < 0) {
+		seq = conn->seq;
+	}
+
+	while (tcp_sacked(conn, seq, &end)) {
+		seq = end;
+	}
+
+	if (net_tcp_seq_cmp(seq,
+			    conn->sacked[conn->sacked_count - 1].start) >= 0) {
+		return false;
+	}
+
+	len = tcp_unsacked_len(conn, seq, tcp_seg_max(conn));
+	if (tcp_send_segment(conn, seq - conn->seq, len, true) < 0) {
+		return false;
+	}
+
+	conn->sack_rexmit = seq + len;
+
+	return true;
+}
+
+/* RTT measurement and congestion window update on an ACK of new data */
+static void tcp_new_ack(struct tcp *conn, uint32_t len_acked)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	uint32_t mss = conn_mss(conn);
+	int flight = MAX(conn->unacked_len, 0);
+
+	if (conn->ts_ok && opts->ts_found && opts->tsecr != 0U) {
+		/* RTTM, RFC 7323 chapter 4 */
+		conn->rtt_pending = false;
+		tcp_rtt_sample(conn, tcp_ts_now(conn) - opts->tsecr);
+	} else if (conn->rtt_pending &&
+		   net_tcp_seq_cmp(conn->seq, conn->rtt_seq) >= 0) {
+		conn->rtt_pending = false;
+		tcp_rtt_sample(conn, k_uptime_get_32() - conn->rtt_start);
+	}
+
+	conn->dup_acks = 0U;
+
+	if (!conn->in_recovery) {
+		tcp_cc_ack(conn, len_acked);
+		return;
+	}
+
+	if (net_tcp_seq_cmp(conn->seq, conn->recover) > 0) {
+		/* Full acknowledgment, leave fast recovery */
+		conn->cwnd = MIN(conn->ssthresh,
+				 MAX((uint32_t)flight, mss) + mss);
+		conn->in_recovery = false;
+		NET_DBG("conn: %p recovered, cwnd=%u", conn, conn->cwnd);
+		return;
+	}
+
+	/* Partial acknowledgment, RFC 6582 chapter 3.2: the next segment
+	 * was lost too, resend it and deflate the window by the amount of
+	 * data acked.
+	 */
+	tcp_resend_first(conn);
+
+	conn->cwnd -= MIN(conn->cwnd, len_acked);
+	if (len_acked >= mss) {
+		conn->cwnd += mss;
+	}
+
+	conn->cwnd = MAX(conn->cwnd, mss);
+}
+
+/* Fast retransmit and fast recovery, RFC 5681 chapter 3.2 and RFC 6582 */
+static void tcp_dup_ack(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->in_recovery) {
+		/* Another segment has left the network */
+		conn->cwnd += mss;
+
+		if (tcp_sack_resend_hole(conn)) {
+			return;
+		}
+
+		(void)tcp_send_queued_data(conn);
+		return;
+	}
+
+	if (++conn->dup_acks < FAST_RETRANSMIT_DUP_ACKS) {
+		return;
+	}
+
+	/* Losses of data sent before the previous congestion event were
+	 * already taken into account.
+	 */
+	if (net_tcp_seq_cmp(conn->seq, conn->recover) <= 0) {
+		return;
+	}
+
+	NET_DBG("conn: %p fast retransmit, seq %u", conn, conn->seq);
+
+	tcp_cc_congestion(conn, false);
+	conn->recover = conn->seq + conn->unacked_len - 1;
+	conn->in_recovery = true;
+	conn->rtt_pending = false;
+	conn->sack_rexmit = conn->seq;
+
+	tcp_resend_first(conn);
+}
+
+/* Keep the options offered in our SYN only if the peer's SYN has them
+ * too, RFC 7323 chapters 2.2 and 3.2 and RFC 2018 chapter 2.
+ */
+static void tcp_options_negotiate(struct tcp *conn)
+{
+	struct tcp_options *opts = &conn->recv_options;
+
+	conn->wscale_ok = conn->wscale_ok && opts->wnd_found;
+	conn->sack_ok = conn->sack_ok && opts->sack_perm_found;
+	conn->ts_ok = conn->ts_ok && opts->ts_found;
+
+	if (conn->wscale_ok) {
+		conn->snd_wscale = MIN(opts->window, TCP_WSCALE_MAX);
+	} else {
+		conn->rcv_wscale = 0U;
+		conn->recv_win = MIN(conn->recv_win, UINT16_MAX);
+	}
+
+	if (conn->ts_ok) {
+		conn->ts_recent = opts->tsval;
+		conn->ts_recent_stamp = k_uptime_get_32();
+	}
+
+	NET_DBG("conn: %p wscale %u/%u sack %u ts %u", conn,
+		conn->snd_wscale, conn->rcv_wscale, conn->sack_ok,
+		conn->ts_ok);
+}
+
+/* PAWS, RFC 7323 chapter 5.3. Returns false if the segment is an old
+ * duplicate, otherwise updates the timestamp to echo.
+ */
+static bool tcp_paws_check(struct tcp *conn, struct tcphdr *th, uint8_t fl)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	uint32_t now = k_uptime_get_32();
+
+	if (!conn->ts_ok || !opts->ts_found || (fl & (SYN | RST))) {
+		return true;
+	}
+
+	/* TS.Recent is no longer valid after a long idle period */
+	if ((int32_t)(opts->tsval - conn->ts_recent) < 0 &&
+	    now - conn->ts_recent_stamp < TCP_PAWS_IDLE_MS) {
+		return false;
+	}
+
+	if (!net_tcp_seq_greater(th_seq(th), conn->ack)) {
+		conn->ts_recent = opts->tsval;
+		conn->ts_recent_stamp = now;
+	}
+
+	return true;
+}
+
 /* TCP state machine, everything happens here */
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 {
@@ -1631,6 +2385,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	struct net_pkt *recv_pkt;
 	void *recv_user_data;
 	struct k_fifo *recv_data_fifo;
+	uint32_t prev_send_win = 0U;
 	size_t len;
 	int ret;
 
@@ -1662,6 +2417,9 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	conn->recv_options.ts_found = false;
+	conn->recv_options.sack_count = 0U;
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1670,11 +2428,26 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th && !tcp_paws_check(conn, th, fl)) {
+		NET_DBG("DROP: Old timestamp %u (recent %u)",
+			conn->recv_options.tsval, conn->ts_recent);
+		net_stats_update_tcp_seg_drop(conn->iface);
+		tcp_out(conn, ACK);
+		k_mutex_unlock(&conn->lock);
+		return;
+	}
+
 	if (th) {
 		size_t max_win;
 
+		prev_send_win = conn->send_win;
 		conn->send_win = ntohs(th_win(th));
 
+		/* The window of SYN segments is not scaled */
+		if (!(fl & SYN)) {
+			conn->send_win <<= conn->snd_wscale;
+		}
+
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
 			max_win = CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE;
@@ -1704,13 +2477,14 @@ next_state:
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_options_negotiate(conn);
 			tcp_out(conn, SYN | ACK);
 			conn_seq(conn, + 1);
 			next = TCP_SYN_RECEIVED;
 
 			/* Close the connection if we do not receive ACK on time.
 			 */
-			k_delayed_work_submit_to_queue(&tcp_work_q,
+			k_delayed_work_submit_to_queue(conn->work_q,
 						       &conn->establish_timer,
 						       ACK_TIMEOUT);
 		} else {
@@ -1724,6 +2498,7 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_delayed_work_cancel(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			tcp_cc_init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
@@ -1757,12 +2532,14 @@ next_state:
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
 			conn_ack(conn, th_seq(th) + 1);
+			tcp_options_negotiate(conn);
 			if (len) {
 				if (tcp_data_get(conn, pkt, &len) < 0) {
 					break;
 				}
 				conn_ack(conn, + len);
 			}
+			tcp_cc_init(conn);
 			k_sem_give(&conn->connect_sem);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
@@ -1802,6 +2579,10 @@ next_state:
 			break;
 		}
 
+		if (th && conn->sack_ok && conn->recv_options.sack_count) {
+			tcp_sack_update(conn);
+		}
+
 		if (th && net_tcp_seq_cmp(th_ack(th), conn->seq) > 0) {
 			uint32_t len_acked = th_ack(th) - conn->seq;
 
@@ -1824,6 +2605,8 @@ next_state:
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+			tcp_new_ack(conn, len_acked);
+
 			conn_send_data_dump(conn);
 
 			if (!k_delayed_work_remaining_get(&conn->send_data_timer)) {
@@ -1854,6 +2637,12 @@ next_state:
 				conn_state(conn, TCP_CLOSED);
 				break;
 			}
+		} else if (th && len == 0 && th_ack(th) == conn->seq &&
+			   conn->unacked_len > 0 &&
+			   conn->data_mode == TCP_DATA_MODE_SEND &&
+			   conn->send_win == prev_send_win &&
+			   !(fl & (SYN | FIN))) {
+			tcp_dup_ack(conn);
 		}
 
 		if (th && len) {
@@ -1868,6 +2657,8 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+				/* Duplicate ACK with the SACK block */
+				tcp_out(conn, ACK);
 			}
 		}
 		break;
@@ -1918,7 +2709,7 @@ next_state:
 		}
 		break;
 	case TCP_TIME_WAIT:
-		k_delayed_work_submit_to_queue(&tcp_work_q,
+		k_delayed_work_submit_to_queue(conn->work_q,
 					       &conn->timewait_timer,
 					       K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
 		break;
@@ -1988,6 +2779,12 @@ int net_tcp_put(struct net_context *context)
 					state ? state : "<unknown>"; })));
 
 	if (conn && conn->state == TCP_ESTABLISHED) {
+		/* Data held back by TCP_CORK is sent before the FIN */
+		if (conn->cork) {
+			conn->cork = false;
+			(void)tcp_send_queued_data(conn);
+		}
+
 		/* Send all remaining data if possible. */
 		if (conn->send_data_total > 0) {
 			NET_DBG("conn %p pending %zu bytes", conn,
@@ -1996,15 +2793,15 @@ int net_tcp_put(struct net_context *context)
 
 			/* How long to wait until all the data has been sent?
 			 */
-			k_delayed_work_submit_to_queue(&tcp_work_q,
+			k_delayed_work_submit_to_queue(conn->work_q,
 						       &conn->send_data_timer,
-						       K_MSEC(tcp_rto));
+						       K_MSEC(conn->rto));
 		} else {
 			int ret;
 
 			NET_DBG("TCP connection in active close, not "
 				"disposing yet (waiting %dms)", FIN_TIMEOUT_MS);
-			k_delayed_work_submit_to_queue(&tcp_work_q,
+			k_delayed_work_submit_to_queue(conn->work_q,
 						       &conn->fin_timer,
 						       FIN_TIMEOUT);
 
@@ -2046,6 +2843,76 @@ int net_tcp_update_recv_wnd(struct net_context *context, int32_t delta)
 	return -EPROTONOSUPPORT;
 }
 
+int net_tcp_set_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       const void *value, size_t len)
+{
+	struct tcp *conn = context->tcp;
+	bool flush = false;
+	int ret = 0;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	switch (option) {
+	case TCP_OPT_NODELAY:
+		conn->nodelay = *(const int *)value != 0;
+		flush = conn->nodelay;
+		break;
+	case TCP_OPT_CORK:
+		conn->cork = *(const int *)value != 0;
+		flush = !conn->cork;
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	/* Data held back so far is sent now */
+	if (flush && conn->state == TCP_ESTABLISHED) {
+		(void)tcp_send_queued_data(conn);
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	return ret;
+}
+
+int net_tcp_get_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       void *value, size_t *len)
+{
+	struct tcp *conn = context->tcp;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
+
+	if (*len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	switch (option) {
+	case TCP_OPT_NODELAY:
+		*(int *)value = conn->nodelay;
+		break;
+	case TCP_OPT_CORK:
+		*(int *)value = conn->cork;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 /* net_context queues the outgoing data for the TCP connection */
 int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 {
@@ -2084,8 +2951,9 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		 * conn is embedded, and calling that function directly here
 		 * and in the work handler.
 		 */
-		(void)k_work_schedule_for_queue(&tcp_work_q,
-						&conn->send_data_timer.work, K_NO_WAIT);
+		(void)k_work_schedule_for_queue(conn->work_q,
+						&conn->send_data_timer.work,
+						K_NO_WAIT);
 
 		ret = -EAGAIN;
 		goto out;
@@ -2218,6 +3086,8 @@ int net_tcp_connect(struct net_context *context,
 		ret = -EPROTONOSUPPORT;
 	}
 
+	tcp_conn_set_work_q(conn);
+
 	if (!(IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 	      IS_ENABLED(CONFIG_NET_TEST))) {
 		conn->seq = tcp_init_isn(&conn->src.sa, &conn->dst.sa);
@@ -2417,14 +3287,17 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
 			/* Make an extra reference, the sanity check suite
-			 * will delete the connection explicitly
+			 * will delete the connection explicitly, and one
+			 * for the input
 			 */
 			tcp_conn_ref(conn);
+			tcp_conn_ref(conn);
 		}
 
 		if (conn) {
 			conn->iface = pkt->iface;
 			tcp_in(conn, pkt);
+			tcp_conn_release(conn);
 		}
 	}
 
@@ -2486,7 +3359,8 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 {
 	struct net_udp_hdr *uh = net_udp_get_hdr(pkt, NULL);
 	size_t data_len = ntohs(uh->len) - sizeof(*uh);
-	struct tcp *conn = tcp_conn_search(pkt);
+	struct tcp *found = tcp_conn_search(pkt);
+	struct tcp *conn = found;
 	size_t json_len = 0;
 	struct tp *tp;
 	struct tp_new *tp_new;
@@ -2550,6 +3424,10 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 
 				conn = (void *)sys_slist_peek_head(&tcp_conns);
 				context = conn->context;
+				/* Drops the reference of the search too */
+				if (conn == found) {
+					found = NULL;
+				}
 				while (tcp_conn_unref(conn))
 					;
 				tcp_free(context);
@@ -2621,6 +3499,10 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 		tp_output(pkt->family, pkt->iface, buf, 1);
 	}
 
+	if (found != NULL) {
+		tcp_conn_release(found);
+	}
+
 	return NET_DROP;
 }
 
@@ -2730,12 +3612,22 @@ void net_tcp_init(void)
 #define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
 #endif
 
-	/* Use private workqueue in order not to block the system work queue.
+	/* Use private workqueues in order not to block the system work
+	 * queue. Connections are spread over them by flow hash.
 	 */
-	k_work_q_start(&tcp_work_q, work_q_stack,
-		       K_KERNEL_STACK_SIZEOF(work_q_stack),
-		       THREAD_PRIORITY);
+	for (int i = 0; i < TCP_WORKQ_COUNT; i++) {
+		k_work_q_start(&tcp_work_q[i], work_q_stack[i],
+			       K_KERNEL_STACK_SIZEOF(work_q_stack[i]),
+			       THREAD_PRIORITY);
+
+		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
+			char name[MAX_NAME_LEN];
 
-	k_thread_name_set(&tcp_work_q.thread, "tcp_work");
-	NET_DBG("Workq started. Thread ID: %p", &tcp_work_q.thread);
+			snprintk(name, sizeof(name), "tcp_work[%d]", i);
+			k_thread_name_set(&tcp_work_q[i].thread, name);
+		}
+
+		NET_DBG("Workq %d started. Thread ID: %p", i,
+			&tcp_work_q[i].thread);
+	}
 }
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* TCP congestion control. The congestion window follows slow start
+ * (RFC 5681) below the slow start threshold, and the congestion
+ * avoidance of the connection's algorithm above it: NewReno (RFC 5681,
+ * RFC 6582) or CUBIC (RFC 8312). Fast retransmit and fast recovery are
+ * driven by tcp2.c.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr.h>
+#include <net/net_ip.h>
+#include <net/net_context.h>
+#include "tcp2_priv.h"
+
+static void newreno_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	/* One segment per window of acked data, RFC 5681 chapter 3.1 */
+	conn->cc_acked += acked;
+	if (conn->cc_acked >= conn->cwnd) {
+		conn->cc_acked -= conn->cwnd;
+		conn->cwnd += conn_mss(conn);
+	}
+}
+
+static uint32_t newreno_ssthresh(struct tcp *conn)
+{
+	/* RFC 5681 equation 4 */
+	return MAX((uint32_t)MAX(conn->unacked_len, 0) / 2U,
+		   2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.cong_avoid = newreno_cong_avoid,
+	.ssthresh = newreno_ssthresh,
+};
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+/* beta_cubic = 0.7 and C = 0.4 */
+#define CUBIC_BETA_10 7U
+#define CUBIC_C_10 4
+
+/* Limits the time offset so that its cube fits in 64 bits */
+#define CUBIC_MAX_T_MS 100000
+
+static uint32_t cubic_root(uint64_t a)
+{
+	uint64_t x = 0U;
+	uint64_t b;
+
+	for (int s = 63; s >= 0; s -= 3) {
+		x <<= 1;
+		b = 3U * x * (x + 1U) + 1U;
+		if ((a >> s) >= b) {
+			a -= b << s;
+			x++;
+		}
+	}
+
+	return (uint32_t)x;
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	memset(&conn->cubic, 0, sizeof(conn->cubic));
+}
+
+static void cubic_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_cubic *cubic = &conn->cubic;
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	int64_t t, target;
+
+	if (cubic->epoch_start == 0U) {
+		cubic->epoch_start = now ? now : 1U;
+
+		if (conn->cwnd < cubic->w_max) {
+			uint64_t delta = cubic->w_max - conn->cwnd;
+
+			/* K = cubic_root((W_max - cwnd) / C), in ms */
+			cubic->k = cubic_root(delta * 10U * NSEC_PER_SEC /
+					      (CUBIC_C_10 * mss));
+			cubic->origin = cubic->w_max;
+		} else {
+			cubic->k = 0U;
+			cubic->origin = conn->cwnd;
+		}
+
+		cubic->w_est = conn->cwnd;
+	}
+
+	/* W_cubic(t + RTT) = C * (t + RTT - K)^3 + W_max, RFC 8312
+	 * chapter 4.1, computed in thousandths of a segment.
+	 */
+	t = (int64_t)(now - cubic->epoch_start) + (conn->srtt >> 3) -
+		cubic->k;
+	t = CLAMP(t, -CUBIC_MAX_T_MS, CUBIC_MAX_T_MS);
+	target = (int64_t)cubic->origin +
+		CUBIC_C_10 * t * t * t / 10000000 * mss / 1000;
+
+	/* TCP friendly region, RFC 8312 chapter 4.2, with
+	 * 3 * (1 - beta_cubic) / (1 + beta_cubic) = 9 / 17
+	 */
+	cubic->w_est += (uint32_t)((uint64_t)9U * mss * acked /
+				   (17U * conn->cwnd));
+	target = MAX(target, (int64_t)cubic->w_est);
+
+	/* Grow at most by half the window per round trip */
+	target = MIN(target, (int64_t)conn->cwnd + conn->cwnd / 2U);
+
+	if (target > conn->cwnd) {
+		conn->cwnd += (uint32_t)((uint64_t)(target - conn->cwnd) *
+					 acked / conn->cwnd);
+	}
+}
+
+static uint32_t cubic_ssthresh(struct tcp *conn)
+{
+	struct tcp_cubic *cubic = &conn->cubic;
+
+	/* Fast convergence, RFC 8312 chapter 4.6 */
+	if (conn->cwnd < cubic->w_max) {
+		cubic->w_max = conn->cwnd * (10U + CUBIC_BETA_10) / 20U;
+	} else {
+		cubic->w_max = conn->cwnd;
+	}
+
+	cubic->epoch_start = 0U;
+
+	return MAX(conn->cwnd * CUBIC_BETA_10 / 10U, 2U * conn_mss(conn));
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.cong_avoid = cubic_cong_avoid,
+	.ssthresh = cubic_ssthresh,
+};
+
+#define TCP_CC_DEFAULT tcp_cc_cubic
+#else
+#define TCP_CC_DEFAULT tcp_cc_newreno
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
+
+void tcp_cc_init(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cc == NULL) {
+		conn->cc = &TCP_CC_DEFAULT;
+	}
+
+	/* Initial window, RFC 6928 */
+	conn->cwnd = MIN(10U * mss, MAX(2U * mss, 14600U));
+	conn->ssthresh = TCP_WIN_MAX;
+	conn->cc_acked = 0U;
+	conn->recover = conn->seq - 1U;
+	conn->dup_acks = 0U;
+	conn->in_recovery = false;
+
+	if (conn->cc->init) {
+		conn->cc->init(conn);
+	}
+}
+
+void tcp_cc_ack(struct tcp *conn, uint32_t acked)
+{
+	if (conn->cwnd >= TCP_WIN_MAX) {
+		return;
+	}
+
+	if (conn->cwnd < conn->ssthresh) {
+		/* Slow start, growing by at most one segment per ACK */
+		conn->cwnd += MIN(acked, conn_mss(conn));
+		return;
+	}
+
+	conn->cc->cong_avoid(conn, acked);
+}
+
+void tcp_cc_congestion(struct tcp *conn, bool timeout)
+{
+	uint32_t mss = conn_mss(conn);
+
+	/* The threshold is kept when the same data times out again */
+	if (!timeout || conn->send_data_retries == 0U) {
+		conn->ssthresh = conn->cc->ssthresh(conn);
+	}
+
+	conn->cc_acked = 0U;
+
+	if (timeout) {
+		/* Loss window, RFC 5681 chapter 3.1 */
+		conn->cwnd = mss;
+	} else {
+		/* Inflated by the three segments which left the network */
+		conn->cwnd = conn->ssthresh + 3U * mss;
+	}
+
+	NET_DBG("conn: %p %s %s cwnd=%u ssthresh=%u", conn, conn->cc->name,
+		timeout ? "timeout" : "fast retransmit", conn->cwnd,
+		conn->ssthresh);
+}
@@ -139,6 +139,25 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+#define TCPOPT_TIMESTAMP	8
+
+#define TCPOLEN_MAXSEG	4
+#define TCPOLEN_WINDOW	3
+#define TCPOLEN_SACK_PERM	2
+#define TCPOLEN_TIMESTAMP	10
+#define TCPOLEN_SACK_BLOCK	8
+
+/* TCP header max options size */
+#define TCP_OPTIONS_MAX 40
+
+/* Largest window shift, RFC 7323 chapter 2.3 */
+#define TCP_WSCALE_MAX 14
+#define TCP_WIN_MAX ((uint32_t)UINT16_MAX << TCP_WSCALE_MAX)
+
+/* SACK blocks kept from the peer, and the most a SACK option can carry */
+#define TCP_SACK_BLOCKS 4
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -194,19 +213,61 @@ enum tcp_data_mode {
 	TCP_DATA_MODE_RESEND = 1
 };
 
+/* Options of net_tcp_set_option(), set with the socket options */
+enum tcp_conn_option {
+	TCP_OPT_NODELAY = 1,
+	TCP_OPT_CORK = 2
+};
+
 union tcp_endpoint {
 	struct sockaddr sa;
 	struct sockaddr_in sin;
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
+
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
+	uint32_t tsval;
+	uint32_t tsecr;
+	struct tcp_sack_block sack[TCP_SACK_BLOCKS];
+	uint8_t sack_count;
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
+	bool ts_found : 1;
+};
+
+struct tcp;
+
+/* Congestion control algorithm, see tcp2_cc.c. Slow start, fast
+ * retransmit and fast recovery are common to all algorithms.
+ */
+struct tcp_cc_ops {
+	const char *name;
+	/* Connection established, congestion window initialized */
+	void (*init)(struct tcp *conn);
+	/* New data acked while in congestion avoidance */
+	void (*cong_avoid)(struct tcp *conn, uint32_t acked);
+	/* Congestion detected, returns the new slow start threshold */
+	uint32_t (*ssthresh)(struct tcp *conn);
 };
 
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+struct tcp_cubic {
+	uint32_t w_max;		/* Window before the last reduction */
+	uint32_t origin;	/* Window at the plateau of the curve */
+	uint32_t w_est;		/* Window of standard TCP, RFC 8312 4.2 */
+	uint32_t epoch_start;	/* Uptime when the epoch started, in ms */
+	uint32_t k;		/* Time to reach origin, in ms */
+};
+#endif
+
 struct tcp { /* TCP connection */
 	sys_snode_t next;
 	struct net_context *context;
@@ -227,6 +288,12 @@ struct tcp { /* TCP connection */
 	struct k_delayed_work recv_queue_timer;
 	struct k_delayed_work send_data_timer;
 	struct k_delayed_work timewait_timer;
+	struct k_delayed_work ack_timer;
+	struct k_work_q *work_q; /* runs the timers and input of this conn */
+#if CONFIG_NET_TCP_WORKQ_COUNT > 1
+	struct k_fifo rx_queue;	/* input packets waiting for work_q */
+	struct k_work rx_work;
+#endif
 	union {
 		/* Because FIN and establish timers are never happening
 		 * at the same time, share the timer between them to
@@ -245,12 +312,42 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t recv_win;
+	uint32_t send_win;
+	const struct tcp_cc_ops *cc;
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	struct tcp_cubic cubic;
+#endif
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t cc_acked;	/* Bytes acked towards the next cwnd increase */
+	uint32_t recover;	/* Highest seq sent at the congestion event */
+	uint32_t rtt_seq;	/* Ack completing the timed segment */
+	uint32_t rtt_start;	/* Uptime when it was sent, in ms */
+	uint32_t srtt;		/* Smoothed RTT, in ms << 3 */
+	uint32_t rttvar;	/* RTT variation, in ms << 2 */
+	uint32_t rto;		/* Retransmission timeout, in ms */
+	uint32_t ts_offset;	/* Added to the uptime for our timestamps */
+	uint32_t ts_recent;	/* Timestamp to echo, RFC 7323 chapter 4.3 */
+	uint32_t ts_recent_stamp; /* Uptime when ts_recent was set, in ms */
+	struct tcp_sack_block sacked[TCP_SACK_BLOCKS]; /* Sorted by seq */
+	uint32_t sack_rexmit;	/* End of the last hole resent in recovery */
+	uint32_t ack_pending;	/* Received bytes not acked yet */
+	uint8_t sacked_count;
+	uint8_t snd_wscale : 4;
+	uint8_t rcv_wscale : 4;
 	uint8_t send_data_retries;
+	uint8_t dup_acks;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool in_recovery : 1;
+	bool rtt_pending : 1;
+	bool wscale_ok : 1;
+	bool sack_ok : 1;
+	bool ts_ok : 1;
+	bool nodelay : 1;	/* Nagle's algorithm is disabled */
+	bool cork : 1;		/* Partial segments are held back */
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -270,3 +367,12 @@ struct tcp { /* TCP connection */
 	_flags(_fl, _op, _mask, strlen("" #_args) ? _args : true)
 
 typedef void (*net_tcp_cb_t)(struct tcp *conn, void *user_data);
+
+extern const struct tcp_cc_ops tcp_cc_newreno;
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+extern const struct tcp_cc_ops tcp_cc_cubic;
+#endif
+
+void tcp_cc_init(struct tcp *conn);
+void tcp_cc_ack(struct tcp *conn, uint32_t acked);
+void tcp_cc_congestion(struct tcp *conn, bool timeout);
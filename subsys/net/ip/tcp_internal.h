@@ -338,6 +338,66 @@ static inline int net_tcp_update_recv_wnd(struct net_context *context,
 }
 #endif
 
+/**
+ * @brief Set a TCP connection option
+ *
+ * @param context Network context
+ * @param option Option to set
+ * @param value Option value, an int
+ * @param len Option length
+ *
+ * @return 0 on success, -EINVAL if the option or its length is invalid,
+ *         -ENOTCONN if there is no TCP connection, -EPROTONOSUPPORT if
+ *         TCP is not supported
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_set_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       const void *value, size_t len);
+#else
+static inline int net_tcp_set_option(struct net_context *context,
+				     enum tcp_conn_option option,
+				     const void *value, size_t len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(option);
+	ARG_UNUSED(value);
+	ARG_UNUSED(len);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
+/**
+ * @brief Get a TCP connection option
+ *
+ * @param context Network context
+ * @param option Option to get
+ * @param value Option value, an int
+ * @param len Option length
+ *
+ * @return 0 on success, -EINVAL if the option or its length is invalid,
+ *         -ENOTCONN if there is no TCP connection, -EPROTONOSUPPORT if
+ *         TCP is not supported
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_get_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       void *value, size_t *len);
+#else
+static inline int net_tcp_get_option(struct net_context *context,
+				     enum tcp_conn_option option,
+				     void *value, size_t *len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(option);
+	ARG_UNUSED(value);
+	ARG_UNUSED(len);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
 /**
  * @brief Queue a TCP FIN packet if needed to close the socket
  *
@@ -26,6 +26,7 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #endif
 
 #include "../../ip/net_stats.h"
+#include "../../ip/tcp_internal.h"
 
 #include "sockets_internal.h"
 
@@ -1582,6 +1583,43 @@ int zsock_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 		}
 
 		break;
+
+	case IPPROTO_TCP:
+		switch (optname) {
+		case TCP_NODELAY:
+			ret = net_tcp_get_option(ctx, TCP_OPT_NODELAY,
+						 optval, optlen);
+			if (ret == -ENOTCONN || ret == -EPROTONOSUPPORT) {
+				/* No native TCP connection, Nagle's
+				 * algorithm is not in use.
+				 */
+				if (*optlen != sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				*(int *)optval = 0;
+				return 0;
+			}
+
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
+
+		case TCP_CORK:
+			ret = net_tcp_get_option(ctx, TCP_OPT_CORK,
+						 optval, optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
+		}
+		break;
 	}
 
 	errno = ENOPROTOOPT;
@@ -1815,9 +1853,31 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 	case IPPROTO_TCP:
 		switch (optname) {
 		case TCP_NODELAY:
-			/* Ignore for now. Provided to let port
-			 * existing apps.
-			 */
+			ret = net_tcp_set_option(ctx, TCP_OPT_NODELAY,
+						 optval, optlen);
+			if (ret == -ENOTCONN || ret == -EPROTONOSUPPORT) {
+				/* Ignored without a native TCP connection,
+				 * as it used to be, to let port existing
+				 * apps.
+				 */
+				return 0;
+			}
+
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
+
+		case TCP_CORK:
+			ret = net_tcp_set_option(ctx, TCP_OPT_CORK,
+						 optval, optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
 			return 0;
 		}
 		break;
@@ -15,6 +15,7 @@
 #include <device.h>
 #include <drivers/timer/system_timer.h>
 #include <kernel.h>
+#include <sys/libc-hooks.h>
 
 static int cmd_kernel_version(const struct shell *shell,
 			      size_t argc, char **argv)
@@ -215,6 +216,92 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_SCHED_IPI_STATS)
+static int cmd_kernel_ipi(const struct shell *shell,
+			  size_t argc, char **argv)
+{
+	struct k_ipi_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (k_sched_ipi_stats_get(i, &stats) != 0) {
+			continue;
+		}
+
+		shell_print(shell,
+			    "CPU %d:\tsent %u\treceived %u\tswitched %u",
+			    i, stats.sent, stats.received, stats.switched);
+	}
+
+	return 0;
+}
+#endif
+
+static void print_heap_stats(const struct shell *shell, const char *name,
+			     const struct sys_heap_runtime_stats *stats)
+{
+	size_t frag = stats->free_bytes == 0U ? 0U :
+		100U - (100U * stats->largest_free_bytes) / stats->free_bytes;
+
+	shell_print(shell, "%s: allocated %zu free %zu max %zu "
+		    "largest free %zu (%zu%% fragmented)", name,
+		    stats->allocated_bytes, stats->free_bytes,
+		    stats->max_allocated_bytes, stats->largest_free_bytes,
+		    frag);
+
+	shell_fprintf(shell, SHELL_NORMAL, "\tfree chunks per bucket:");
+	for (int i = 0; i < stats->num_buckets; i++) {
+		if (stats->bucket_free_chunks[i] != 0U) {
+			shell_fprintf(shell, SHELL_NORMAL, " %d:%u", i,
+				      stats->bucket_free_chunks[i]);
+		}
+	}
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static int cmd_kernel_heaps(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	struct sys_heap_runtime_stats stats;
+	char name[32];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	/* Includes the k_malloc() heap memory pool */
+	Z_STRUCT_SECTION_FOREACH(k_heap, h) {
+		k_heap_runtime_stats_get(h, &stats);
+		snprintk(name, sizeof(name), "k_heap %p", h);
+		print_heap_stats(shell, name, &stats);
+	}
+
+#if (CONFIG_HEAP_MEM_POOL_REGIONS > 0)
+	struct sys_multi_heap_region_stats region;
+
+	for (int i = 0; k_malloc_region_stats_get(i, &region) == 0; i++) {
+		shell_print(shell, "k_malloc region %d: attr%s%s%s allocs %u "
+			    "(%u fallback)", i,
+			    (region.attr & SYS_MHEAP_ATTR_FAST) ? " fast" : "",
+			    (region.attr & SYS_MHEAP_ATTR_DMA) ? " dma" : "",
+			    (region.attr & SYS_MHEAP_ATTR_CACHEABLE) ?
+			    " cacheable" : "",
+			    region.allocs, region.fallback_allocs);
+		print_heap_stats(shell, "\theap", &region.heap);
+	}
+#endif
+
+#if defined(CONFIG_MINIMAL_LIBC_MALLOC) && \
+	(CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE > 0)
+	if (malloc_runtime_stats_get(&stats) == 0) {
+		print_heap_stats(shell, "malloc arena", &stats);
+	}
+#endif
+
+	return 0;
+}
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -243,6 +330,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+	SHELL_CMD(heaps, NULL, "Heap usage statistics.", cmd_kernel_heaps),
+#if defined(CONFIG_SCHED_IPI_STATS)
+	SHELL_CMD(ipi, NULL, "Scheduler IPI statistics.", cmd_kernel_ipi),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
@@ -13,12 +13,23 @@
  *  1. From __start to main()
  *  2. From __start to task
  *  3. From __start to idle
+ *  4. Time spent in the POST_KERNEL and APPLICATION init levels
  */
 
 #include <zephyr.h>
 #include <tc_util.h>
 #include <kernel_internal.h>
 
+static void print_init_level(const char *name, int level)
+{
+	uint32_t cycles = z_timestamp_init_level[level];
+	uint32_t us = (uint32_t)ceiling_fraction(USEC_PER_SEC *
+						 (uint64_t)cycles,
+						 sys_clock_hw_cycles_per_sec());
+
+	TC_PRINT("%-14s: %u cycles, %u us\n", name, cycles, us);
+}
+
 void main(void)
 {
 	uint32_t task_time_stamp;	/* timestamp at beginning of first task */
@@ -52,6 +63,8 @@ void main(void)
 						       task_us);
 	TC_PRINT("_start->idle  : %u cycles, %u us\n", z_timestamp_idle,
 						       idle_us);
+	print_init_level("POST_KERNEL", _SYS_INIT_LEVEL_POST_KERNEL);
+	print_init_level("APPLICATION", _SYS_INIT_LEVEL_APPLICATION);
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	TC_END_RESULT(TC_PASS);
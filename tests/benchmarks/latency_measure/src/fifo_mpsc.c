@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief measure ISR to thread hand-off through a FIFO
+ *
+ * This file contains tests that compare a regular FIFO with a lock-free
+ * multi-producer, single-consumer FIFO.  A higher priority thread waits
+ * on the FIFO and an ISR puts items into it, first one at a time to
+ * measure the time from the put to the thread getting the item, then
+ * in bursts to measure the cost of a put and of a get when the FIFO is
+ * not empty.
+ */
+
+#include <zephyr.h>
+#include <irq_offload.h>
+
+#include "utils.h"
+
+#define N_RUNS 64
+#define N_BURST 64
+#define CONSUMER_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+struct fifo_item {
+	void *fifo_reserved;
+	uint32_t data;
+};
+
+static struct fifo_item items[N_BURST];
+static struct k_fifo fifo;
+
+static K_THREAD_STACK_DEFINE(consumer_stack, CONSUMER_STACK_SIZE);
+static struct k_thread consumer_thread;
+
+static timing_t timestamp_start;
+static timing_t timestamp_end;
+static timing_t timestamp_got;
+
+static void consumer(void *p1, void *p2, void *p3)
+{
+	while (k_fifo_get(&fifo, K_FOREVER) != NULL) {
+		timestamp_got = timing_counter_get();
+	}
+}
+
+static void put_isr(const void *unused)
+{
+	ARG_UNUSED(unused);
+
+	timestamp_start = timing_counter_get();
+	k_fifo_put(&fifo, &items[0]);
+}
+
+static void burst_isr(const void *unused)
+{
+	ARG_UNUSED(unused);
+
+	timestamp_start = timing_counter_get();
+	for (int i = 0; i < N_BURST; i++) {
+		k_fifo_put(&fifo, &items[i]);
+	}
+	timestamp_end = timing_counter_get();
+}
+
+static void fifo_test(const char *mode)
+{
+	uint64_t handoff = 0U, put = 0U, get = 0U;
+	char tag[64];
+
+	k_thread_create(&consumer_thread, consumer_stack,
+			K_THREAD_STACK_SIZEOF(consumer_stack), consumer,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+
+	timing_start();
+
+	/* The consumer is pending, so it preempts on ISR exit */
+	for (int run = 0; run < N_RUNS; run++) {
+		irq_offload(put_isr, NULL);
+		handoff += timing_cycles_get(&timestamp_start, &timestamp_got);
+	}
+
+	/* Only the first put of a burst finds the consumer pending */
+	for (int run = 0; run < N_RUNS; run++) {
+		irq_offload(burst_isr, NULL);
+		put += timing_cycles_get(&timestamp_start, &timestamp_end);
+		get += timing_cycles_get(&timestamp_end, &timestamp_got);
+	}
+
+	timing_stop();
+
+	k_fifo_cancel_wait(&fifo);
+	k_thread_join(&consumer_thread, K_FOREVER);
+
+	snprintk(tag, sizeof(tag), "Average ISR to thread FIFO hand-off (%s)",
+		 mode);
+	PRINT_STATS_AVG(tag, (uint32_t)handoff, N_RUNS);
+	snprintk(tag, sizeof(tag), "Average FIFO put from ISR, burst (%s)",
+		 mode);
+	PRINT_STATS_AVG(tag, (uint32_t)put, N_RUNS * N_BURST);
+	snprintk(tag, sizeof(tag), "Average FIFO get, burst (%s)", mode);
+	PRINT_STATS_AVG(tag, (uint32_t)get, N_RUNS * N_BURST);
+}
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int fifo_mpsc(void)
+{
+	k_fifo_init(&fifo);
+	fifo_test("spinlock");
+
+#ifdef CONFIG_QUEUE_MPSC
+	k_fifo_init_mpsc(&fifo);
+	fifo_test("MPSC");
+#endif
+
+	return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <stdlib.h>
+
+/* malloc() contention benchmark.  Runs rounds with a growing number
+ * of threads at the same preemptible priority, each allocating and
+ * freeing small blocks as fast as it can.
+ */
+
+#define MAX_THREADS 8
+#define BURST 8
+#define STACK_SIZE 1024
+#define THREAD_PRIO 5
+
+#define WARMUP_MS 100
+#define MEASURE_MS 1000
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MAX_THREADS, STACK_SIZE);
+static struct k_thread threads[MAX_THREADS];
+
+/* One counter per thread, so counting does not itself contend */
+static uint32_t ops[MAX_THREADS];
+
+/* Threads must not be aborted while they might hold an arena lock */
+static volatile bool running;
+
+static const size_t sizes[] = { 16, 24, 40, 64, 100, 128, 200, 256 };
+
+static void alloc_free(void *p1, void *p2, void *p3)
+{
+	int me = POINTER_TO_INT(p1);
+	void *blocks[BURST];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (running) {
+		for (int i = 0; i < BURST; i++) {
+			blocks[i] = malloc(sizes[(me + i) % ARRAY_SIZE(sizes)]);
+		}
+		for (int i = 0; i < BURST; i++) {
+			free(blocks[i]);
+		}
+		ops[me] += 2 * BURST;
+	}
+}
+
+static uint64_t total_ops(int n)
+{
+	uint64_t sum = 0U;
+
+	for (int i = 0; i < n; i++) {
+		sum += ops[i];
+	}
+	return sum;
+}
+
+static void run(int n)
+{
+	uint64_t start, end;
+	int64_t t0, t1;
+
+	running = true;
+	for (int i = 0; i < n; i++) {
+		ops[i] = 0U;
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				alloc_free, INT_TO_POINTER(i), NULL, NULL,
+				THREAD_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_msleep(WARMUP_MS);
+
+	t0 = k_uptime_get();
+	start = total_ops(n);
+	k_msleep(MEASURE_MS);
+	end = total_ops(n);
+	t1 = k_uptime_get();
+
+	running = false;
+	for (int i = 0; i < n; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	printk("arenas %d threads %d ops/s %u\n",
+	       CONFIG_MINIMAL_LIBC_MALLOC_ARENAS, n,
+	       (uint32_t)((end - start) * 1000U / (t1 - t0)));
+}
+
+void main(void)
+{
+	for (int n = 1; n <= MAX_THREADS; n *= 2) {
+		run(n);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP memory slab throughput benchmark.  One thread per CPU
+ * allocates a burst of blocks from a shared slab and frees them
+ * again, as fast as it can.  The slab is sized so that it never runs
+ * out, so the numbers reflect the fast path only.
+ */
+
+#define NUM_THREADS CONFIG_MP_NUM_CPUS
+#define BURST 4
+#define BLOCK_SIZE 64
+#define NUM_BLOCKS (NUM_THREADS * 32)
+#define STACK_SIZE 1024
+#define THREAD_PRIO 5
+
+#define WARMUP_MS 200
+#define MEASURE_MS 2000
+
+K_MEM_SLAB_DEFINE(slab, BLOCK_SIZE, NUM_BLOCKS, 8);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread threads[NUM_THREADS];
+
+/* One counter per thread, so counting does not itself contend */
+static uint32_t ops[NUM_THREADS];
+
+static void alloc_free(void *p1, void *p2, void *p3)
+{
+	int me = POINTER_TO_INT(p1);
+	void *blocks[BURST];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		for (int i = 0; i < BURST; i++) {
+			(void)k_mem_slab_alloc(&slab, &blocks[i], K_FOREVER);
+		}
+		for (int i = 0; i < BURST; i++) {
+			k_mem_slab_free(&slab, &blocks[i]);
+		}
+		ops[me] += 2 * BURST;
+	}
+}
+
+static uint64_t total_ops(void)
+{
+	uint64_t sum = 0U;
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		sum += ops[i];
+	}
+	return sum;
+}
+
+void main(void)
+{
+	uint64_t start, end;
+	int64_t t0, t1;
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				alloc_free, INT_TO_POINTER(i), NULL, NULL,
+				THREAD_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_msleep(WARMUP_MS);
+
+	t0 = k_uptime_get();
+	start = total_ops();
+	k_msleep(MEASURE_MS);
+	end = total_ops();
+	t1 = k_uptime_get();
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	printk("cpus %d magazines %s ops/s %u\n", CONFIG_MP_NUM_CPUS,
+	       IS_ENABLED(CONFIG_MEM_SLAB_MAGAZINES) ? "on" : "off",
+	       (uint32_t)((end - start) * 1000U / (t1 - t0)));
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	struct k_mem_slab_cache_stats stats;
+
+	k_mem_slab_cache_stats_get(&slab, &stats);
+	printk("alloc hits %u misses %u free hits %u misses %u exchanges %u\n",
+	       stats.alloc_hits, stats.alloc_misses, stats.free_hits,
+	       stats.free_misses, stats.exchanges);
+#endif
+
+	printk("fin\n");
+}
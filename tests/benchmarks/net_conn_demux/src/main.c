@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* Connection demultiplexing benchmark.  For each socket count below,
+ * filler UDP sockets are opened until that many are registered, then
+ * N_PACKETS are sent from a connected client to a bound server socket
+ * over the loopback interface and the receive rate is reported.
+ */
+
+#define N_PACKETS 2000
+#define PACKET_SIZE 64
+#define MAX_FILLERS 256
+
+#define MY_ADDR "192.0.2.1"
+#define SERVER_PORT 4242
+#define CLIENT_PORT 4243
+#define FILLER_PORT 20000
+#define REMOTE_PORT 30000
+
+static const int socket_counts[] = { 1, 16, 64, MAX_FILLERS };
+
+static int fillers[MAX_FILLERS];
+static int n_fillers;
+static uint8_t packet[PACKET_SIZE];
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+/* The simulated time does not advance while the CPU is busy */
+extern uint64_t get_host_us_time(void);
+
+static uint64_t now_us(void)
+{
+	return get_host_us_time();
+}
+#else
+static uint64_t now_us(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+#endif
+
+static void make_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, MY_ADDR, &addr->sin_addr);
+}
+
+static int udp_socket(uint16_t local_port, uint16_t remote_port)
+{
+	struct sockaddr_in addr;
+	int sock;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (sock < 0) {
+		printk("socket() failed: %d\n", errno);
+		return -1;
+	}
+
+	make_addr(&addr, local_port);
+	if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("bind(%u) failed: %d\n", local_port, errno);
+		close(sock);
+		return -1;
+	}
+
+	if (remote_port != 0) {
+		make_addr(&addr, remote_port);
+		if (connect(sock, (struct sockaddr *)&addr,
+			    sizeof(addr)) < 0) {
+			printk("connect(%u) failed: %d\n", remote_port, errno);
+			close(sock);
+			return -1;
+		}
+	}
+
+	return sock;
+}
+
+/* Odd fillers are connected, so both the bound and the fully specified
+ * connection lookups carry their share of sockets.
+ */
+static int open_fillers(int count)
+{
+	while (n_fillers < count) {
+		int i = n_fillers;
+		int sock = udp_socket(FILLER_PORT + i,
+				      (i & 1) ? REMOTE_PORT + i : 0);
+
+		if (sock < 0) {
+			return -1;
+		}
+		fillers[n_fillers++] = sock;
+	}
+
+	return 0;
+}
+
+static int run(int server, int client, uint32_t *rate)
+{
+	uint64_t start, elapsed;
+
+	start = now_us();
+
+	for (int i = 0; i < N_PACKETS; i++) {
+		if (send(client, packet, sizeof(packet), 0) < 0) {
+			printk("send() failed: %d\n", errno);
+			return -1;
+		}
+		if (recv(server, packet, sizeof(packet), 0) < 0) {
+			printk("recv() failed: %d\n", errno);
+			return -1;
+		}
+	}
+
+	elapsed = MAX(now_us() - start, 1);
+	*rate = (uint32_t)(N_PACKETS * USEC_PER_SEC / elapsed);
+	return 0;
+}
+
+void main(void)
+{
+	int server, client;
+	uint32_t rate;
+
+	server = udp_socket(SERVER_PORT, 0);
+	client = udp_socket(CLIENT_PORT, SERVER_PORT);
+	if (server < 0 || client < 0) {
+		return;
+	}
+
+	/* Warm up the packet and buffer pools */
+	if (run(server, client, &rate) < 0) {
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(socket_counts); i++) {
+		if (open_fillers(socket_counts[i]) < 0 ||
+		    run(server, client, &rate) < 0) {
+			return;
+		}
+		printk("%4d sockets: %u packets/s\n", socket_counts[i], rate);
+	}
+
+	for (int i = 0; i < n_fillers; i++) {
+		close(fillers[i]);
+	}
+	close(server);
+	close(client);
+
+	printk("fin\n");
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+
+/* TCP request/response benchmark.  For each way of writing the request
+ * below, N_TRANSACTIONS requests are sent from a client socket to a
+ * server socket over the loopback interface, each answered with a
+ * response, and the IPv4 packets sent per transaction are reported.
+ */
+
+#define N_TRANSACTIONS 100
+#define REQUEST_SIZE 64
+#define REQUEST_HEADER_SIZE 16
+#define RESPONSE_SIZE 256
+
+#define MY_ADDR "192.0.2.1"
+#define SERVER_PORT 4242
+
+enum write_mode {
+	WRITE_ONE,
+	WRITE_SPLIT,
+	WRITE_SPLIT_NODELAY,
+	WRITE_SPLIT_CORK,
+};
+
+static const char *const mode_names[] = {
+	[WRITE_ONE] = "one write",
+	[WRITE_SPLIT] = "split",
+	[WRITE_SPLIT_NODELAY] = "split nodelay",
+	[WRITE_SPLIT_CORK] = "split cork",
+};
+
+static uint8_t request[REQUEST_SIZE];
+static uint8_t response[RESPONSE_SIZE];
+
+static uint32_t packets_sent(void)
+{
+	struct net_stats_ip ip;
+
+	if (net_mgmt(NET_REQUEST_STATS_GET_IPV4, NULL, &ip, sizeof(ip)) < 0) {
+		return 0;
+	}
+
+	return ip.sent;
+}
+
+static int set_tcp_opt(int sock, int optname, int val)
+{
+	if (setsockopt(sock, IPPROTO_TCP, optname, &val, sizeof(val)) < 0) {
+		printk("setsockopt(%d) failed: %d\n", optname, errno);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int send_all(int sock, const uint8_t *buf, size_t len)
+{
+	if (send(sock, buf, len, 0) != (ssize_t)len) {
+		printk("send() failed: %d\n", errno);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int recv_all(int sock, uint8_t *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = recv(sock, buf, len, 0);
+		if (ret <= 0) {
+			printk("recv() failed: %d\n", errno);
+			return -1;
+		}
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static int send_request(int sock, enum write_mode mode)
+{
+	if (mode == WRITE_ONE) {
+		return send_all(sock, request, sizeof(request));
+	}
+
+	if (mode == WRITE_SPLIT_CORK && set_tcp_opt(sock, TCP_CORK, 1) < 0) {
+		return -1;
+	}
+
+	if (send_all(sock, request, REQUEST_HEADER_SIZE) < 0 ||
+	    send_all(sock, request + REQUEST_HEADER_SIZE,
+		     sizeof(request) - REQUEST_HEADER_SIZE) < 0) {
+		return -1;
+	}
+
+	if (mode == WRITE_SPLIT_CORK) {
+		return set_tcp_opt(sock, TCP_CORK, 0);
+	}
+
+	return 0;
+}
+
+static int connect_pair(int listener, int *client, int *server)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+
+	inet_pton(AF_INET, MY_ADDR, &addr.sin_addr);
+
+	*client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (*client < 0) {
+		printk("socket() failed: %d\n", errno);
+		return -1;
+	}
+
+	if (connect(*client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("connect() failed: %d\n", errno);
+		close(*client);
+		return -1;
+	}
+
+	*server = accept(listener, NULL, NULL);
+	if (*server < 0) {
+		printk("accept() failed: %d\n", errno);
+		close(*client);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int run(int listener, enum write_mode mode)
+{
+	uint32_t packets, elapsed;
+	int64_t start;
+	int client, server;
+	int ret = 0;
+
+	if (connect_pair(listener, &client, &server) < 0) {
+		return -1;
+	}
+
+	if (mode == WRITE_SPLIT_NODELAY &&
+	    set_tcp_opt(client, TCP_NODELAY, 1) < 0) {
+		ret = -1;
+		goto out;
+	}
+
+	packets = packets_sent();
+	start = k_uptime_get();
+
+	for (int i = 0; i < N_TRANSACTIONS; i++) {
+		if (send_request(client, mode) < 0 ||
+		    recv_all(server, request, sizeof(request)) < 0 ||
+		    send_all(server, response, sizeof(response)) < 0 ||
+		    recv_all(client, response, sizeof(response)) < 0) {
+			ret = -1;
+			goto out;
+		}
+	}
+
+	elapsed = (uint32_t)(k_uptime_get() - start);
+
+	/* Let the last delayed ACK go out */
+	k_msleep(CONFIG_NET_TCP_ACK_DELAY + 10);
+
+	packets = (packets_sent() - packets) * 100U / N_TRANSACTIONS;
+	printk("%-14s %u.%02u packets/transaction, %u ms\n", mode_names[mode],
+	       packets / 100U, packets % 100U, elapsed);
+
+out:
+	close(client);
+	close(server);
+	return ret;
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int listener;
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0) {
+		printk("socket() failed: %d\n", errno);
+		return;
+	}
+
+	if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, 1) < 0) {
+		printk("bind() or listen() failed: %d\n", errno);
+		close(listener);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(mode_names); i++) {
+		if (run(listener, i) < 0) {
+			break;
+		}
+	}
+
+	close(listener);
+
+	printk("fin\n");
+}
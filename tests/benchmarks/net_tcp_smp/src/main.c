@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* TCP SMP scaling benchmark.  For each connection count below, that
+ * many client sockets are connected to a listening server socket over
+ * the loopback interface, then a sender thread per connection writes
+ * BYTES_PER_CONN bytes which a receiver thread per connection reads
+ * back, and the aggregate rate is reported.
+ */
+
+#define MAX_CONNS 4
+#define BYTES_PER_CONN (64 * 1024)
+#define CHUNK_SIZE 1024
+#define STACK_SIZE 1536
+#define PRIORITY K_PRIO_PREEMPT(8)
+
+#define MY_ADDR "192.0.2.1"
+#define SERVER_PORT 4242
+#define CLIENT_PORT 5000
+
+static const int conn_counts[] = { 1, 2, MAX_CONNS };
+
+static K_THREAD_STACK_ARRAY_DEFINE(sender_stacks, MAX_CONNS, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(receiver_stacks, MAX_CONNS, STACK_SIZE);
+static struct k_thread senders[MAX_CONNS];
+static struct k_thread receivers[MAX_CONNS];
+static K_SEM_DEFINE(done, 0, MAX_CONNS);
+
+static int clients[MAX_CONNS];
+static int servers[MAX_CONNS];
+static uint8_t tx_buf[MAX_CONNS][CHUNK_SIZE];
+static uint8_t rx_buf[MAX_CONNS][CHUNK_SIZE];
+static atomic_t failed;
+
+static void make_addr(struct sockaddr_in *addr, uint16_t port)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = htons(port);
+	inet_pton(AF_INET, MY_ADDR, &addr->sin_addr);
+}
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	int i = POINTER_TO_INT(p1);
+	size_t left = BYTES_PER_CONN;
+	ssize_t len;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (left > 0) {
+		len = send(clients[i], tx_buf[i], MIN(left, CHUNK_SIZE), 0);
+		if (len < 0) {
+			printk("send() failed: %d\n", errno);
+			atomic_set(&failed, 1);
+			return;
+		}
+		left -= len;
+	}
+}
+
+static void receiver(void *p1, void *p2, void *p3)
+{
+	int i = POINTER_TO_INT(p1);
+	size_t left = BYTES_PER_CONN;
+	ssize_t len;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (left > 0) {
+		len = recv(servers[i], rx_buf[i], sizeof(rx_buf[i]), 0);
+		if (len <= 0) {
+			printk("recv() failed: %d\n", errno);
+			atomic_set(&failed, 1);
+			break;
+		}
+		left -= len;
+	}
+
+	k_sem_give(&done);
+}
+
+/* Distinct client ports in each round, as the previous connections may
+ * still be closing.
+ */
+static int open_conns(int listener, int count, int round)
+{
+	struct sockaddr_in addr;
+
+	for (int i = 0; i < count; i++) {
+		clients[i] = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (clients[i] < 0) {
+			printk("socket() failed: %d\n", errno);
+			return -1;
+		}
+
+		make_addr(&addr, CLIENT_PORT + round * MAX_CONNS + i);
+		if (bind(clients[i], (struct sockaddr *)&addr,
+			 sizeof(addr)) < 0) {
+			printk("bind() failed: %d\n", errno);
+			return -1;
+		}
+
+		make_addr(&addr, SERVER_PORT);
+		if (connect(clients[i], (struct sockaddr *)&addr,
+			    sizeof(addr)) < 0) {
+			printk("connect() failed: %d\n", errno);
+			return -1;
+		}
+
+		servers[i] = accept(listener, NULL, NULL);
+		if (servers[i] < 0) {
+			printk("accept() failed: %d\n", errno);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void close_conns(int count)
+{
+	for (int i = 0; i < count; i++) {
+		close(clients[i]);
+		close(servers[i]);
+	}
+}
+
+static int run(int count, uint32_t *rate)
+{
+	uint64_t start, elapsed;
+
+	start = k_ticks_to_us_floor64(k_uptime_ticks());
+
+	for (int i = 0; i < count; i++) {
+		k_thread_create(&receivers[i], receiver_stacks[i], STACK_SIZE,
+				receiver, INT_TO_POINTER(i), NULL, NULL,
+				PRIORITY, 0, K_NO_WAIT);
+		k_thread_create(&senders[i], sender_stacks[i], STACK_SIZE,
+				sender, INT_TO_POINTER(i), NULL, NULL,
+				PRIORITY, 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < count; i++) {
+		if (k_sem_take(&done, K_SECONDS(60)) < 0) {
+			printk("receiver timed out\n");
+			return -1;
+		}
+	}
+
+	elapsed = MAX(k_ticks_to_us_floor64(k_uptime_ticks()) - start, 1);
+
+	for (int i = 0; i < count; i++) {
+		k_thread_join(&senders[i], K_FOREVER);
+		k_thread_join(&receivers[i], K_FOREVER);
+	}
+
+	if (atomic_get(&failed)) {
+		return -1;
+	}
+
+	/* A byte per microsecond is 1000 KB/s */
+	*rate = (uint32_t)((uint64_t)count * BYTES_PER_CONN * 1000U /
+			   elapsed);
+	return 0;
+}
+
+void main(void)
+{
+	struct sockaddr_in addr;
+	uint32_t rate;
+	int listener;
+
+	listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (listener < 0) {
+		printk("socket() failed: %d\n", errno);
+		return;
+	}
+
+	make_addr(&addr, SERVER_PORT);
+	if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(listener, MAX_CONNS) < 0) {
+		printk("listen() failed: %d\n", errno);
+		return;
+	}
+
+	printk("%d TCP work queue(s), %d CPU(s)\n",
+	       CONFIG_NET_TCP_WORKQ_COUNT, CONFIG_MP_NUM_CPUS);
+
+	for (int i = 0; i < ARRAY_SIZE(conn_counts); i++) {
+		int count = conn_counts[i];
+
+		if (open_conns(listener, count, i) < 0 ||
+		    run(count, &rate) < 0) {
+			return;
+		}
+		printk("%d connections: %u KB/s\n", count, rate);
+
+		close_conns(count);
+		k_sleep(K_MSEC(100));
+	}
+
+	close(listener);
+
+	printk("fin\n");
+}
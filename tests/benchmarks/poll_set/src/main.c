@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timing/timing.h>
+
+/* Poll set vs k_poll() benchmark.  A low priority thread keeps giving
+ * a pseudo-randomly chosen one of N semaphores, the main thread waits
+ * for any of them, takes it and waits again.  Each iteration therefore
+ * costs one blocking wait, one wakeup and finding the ready semaphore.
+ */
+
+#define MAX_EVENTS 256
+#define N_RUNS 1000
+#define STACK_SIZE 1024
+
+static const int sizes[] = { 8, 64, MAX_EVENTS };
+
+static struct k_sem sems[MAX_EVENTS];
+static struct k_poll_event events[MAX_EVENTS];
+K_POLL_SET_DEFINE(bench_set, MAX_EVENTS);
+
+static K_THREAD_STACK_DEFINE(giver_stack, STACK_SIZE);
+static struct k_thread giver_thread;
+static volatile bool giving;
+
+static uint32_t rand_state = 0x12345678;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32: deterministic, so both methods see the same load */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+/* Only runs while the main thread is blocked */
+static void giver(void *p1, void *p2, void *p3)
+{
+	int n = POINTER_TO_INT(p1);
+
+	while (giving) {
+		k_sem_give(&sems[next_rand() % n]);
+	}
+}
+
+static void start_giver(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_sem_init(&sems[i], 0, 1);
+	}
+
+	rand_state = 0x12345678;
+	giving = true;
+	k_thread_create(&giver_thread, giver_stack,
+			K_THREAD_STACK_SIZEOF(giver_stack), giver,
+			INT_TO_POINTER(n), NULL, NULL,
+			K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+}
+
+static void stop_giver(void)
+{
+	giving = false;
+	k_thread_join(&giver_thread, K_FOREVER);
+}
+
+static uint32_t run_k_poll(int n)
+{
+	timing_t start, end;
+
+	for (int i = 0; i < n; i++) {
+		k_poll_event_init(&events[i], K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &sems[i]);
+	}
+
+	start_giver(n);
+	start = timing_counter_get();
+
+	for (int run = 0; run < N_RUNS; run++) {
+		(void)k_poll(events, n, K_FOREVER);
+
+		for (int i = 0; i < n; i++) {
+			if (events[i].state == K_POLL_STATE_SEM_AVAILABLE) {
+				(void)k_sem_take(&sems[i], K_NO_WAIT);
+			}
+			events[i].state = K_POLL_STATE_NOT_READY;
+		}
+	}
+
+	end = timing_counter_get();
+	stop_giver();
+
+	return (uint32_t)(timing_cycles_get(&start, &end) / N_RUNS);
+}
+
+static uint32_t run_poll_set(int n)
+{
+	struct k_poll_set_result result;
+	timing_t start, end;
+
+	start_giver(n);
+
+	for (int i = 0; i < n; i++) {
+		(void)k_poll_set_add(&bench_set, K_POLL_TYPE_SEM_AVAILABLE,
+				     &sems[i]);
+	}
+
+	start = timing_counter_get();
+
+	for (int run = 0; run < N_RUNS; run++) {
+		(void)k_poll_set_wait(&bench_set, &result, 1, K_FOREVER);
+		(void)k_sem_take(&sems[result.id], K_NO_WAIT);
+	}
+
+	end = timing_counter_get();
+	stop_giver();
+
+	for (int i = 0; i < n; i++) {
+		(void)k_poll_set_remove(&bench_set, i);
+	}
+
+	return (uint32_t)(timing_cycles_get(&start, &end) / N_RUNS);
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		uint32_t poll = run_k_poll(sizes[i]);
+		uint32_t set = run_poll_set(sizes[i]);
+
+		printk("n %3d k_poll %8u k_poll_set %8u (cycles)\n",
+		       sizes[i], poll, set);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP reader-writer lock benchmark.  1 up to NUM_CPUS threads look up
+ * a TABLE_SIZE entry table, holding the lock for reading, and update
+ * one entry, holding it for writing, once every WRITE_INTERVAL
+ * operations.  The table is protected by a k_rwlock, then by a
+ * k_mutex.  A timer stops the threads after MEASURE_MS and samples the
+ * number of operations done so far.
+ */
+
+#define NUM_CPUS CONFIG_MP_NUM_CPUS
+#define TABLE_SIZE 64
+#define WRITE_INTERVAL 100
+#define STACK_SIZE 1024
+#define THREAD_PRIO K_PRIO_PREEMPT(1)
+
+#define MEASURE_MS 1000
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_CPUS, STACK_SIZE);
+static struct k_thread threads[NUM_CPUS];
+
+static struct k_rwlock rwlock;
+static struct k_mutex mutex;
+
+static uint32_t table[TABLE_SIZE];
+
+/* One counter per thread, so counting does not itself contend */
+static uint32_t ops[NUM_CPUS];
+
+static bool use_rwlock;
+static volatile bool running;
+static uint32_t sampled;
+
+static uint32_t lookup(uint32_t key)
+{
+	uint32_t sum = 0U;
+
+	for (int i = 0; i < TABLE_SIZE; i++) {
+		if (table[i] != key) {
+			sum += table[i];
+		}
+	}
+	return sum;
+}
+
+static void read_op(uint32_t key)
+{
+	if (use_rwlock) {
+		(void)k_rwlock_read_lock(&rwlock, K_FOREVER);
+		(void)lookup(key);
+		(void)k_rwlock_unlock(&rwlock);
+	} else {
+		(void)k_mutex_lock(&mutex, K_FOREVER);
+		(void)lookup(key);
+		(void)k_mutex_unlock(&mutex);
+	}
+}
+
+static void write_op(uint32_t key)
+{
+	if (use_rwlock) {
+		(void)k_rwlock_write_lock(&rwlock, K_FOREVER);
+		table[key % TABLE_SIZE]++;
+		(void)k_rwlock_unlock(&rwlock);
+	} else {
+		(void)k_mutex_lock(&mutex, K_FOREVER);
+		table[key % TABLE_SIZE]++;
+		(void)k_mutex_unlock(&mutex);
+	}
+}
+
+static void thread_entry(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	uint32_t n = 0U;
+
+	while (running) {
+		if ((n % WRITE_INTERVAL) == 0U) {
+			write_op(n);
+		} else {
+			read_op(n);
+		}
+		ops[id] = ++n;
+	}
+}
+
+static void stop_fn(struct k_timer *timer)
+{
+	uint32_t sum = 0U;
+
+	running = false;
+	for (int i = 0; i < NUM_CPUS; i++) {
+		sum += ops[i];
+	}
+	sampled = sum;
+}
+
+K_TIMER_DEFINE(stop_timer, stop_fn, NULL);
+
+static void run(const char *name, int nthreads)
+{
+	for (int i = 0; i < NUM_CPUS; i++) {
+		ops[i] = 0U;
+	}
+	running = true;
+	k_timer_start(&stop_timer, K_MSEC(MEASURE_MS), K_NO_WAIT);
+
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				thread_entry, INT_TO_POINTER(i), NULL, NULL,
+				THREAD_PRIO, 0, K_NO_WAIT);
+	}
+
+	(void)k_timer_status_sync(&stop_timer);
+	for (int i = 0; i < nthreads; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+
+	printk("%-8s threads %2d ops/s %u\n", name, nthreads,
+	       (uint32_t)((uint64_t)sampled * 1000U / MEASURE_MS));
+}
+
+void main(void)
+{
+	k_rwlock_init(&rwlock, 0);
+	k_mutex_init(&mutex);
+
+	use_rwlock = true;
+	for (int n = 1; n <= NUM_CPUS; n++) {
+		run("k_rwlock", n);
+	}
+
+	use_rwlock = false;
+	for (int n = 1; n <= NUM_CPUS; n++) {
+		run("k_mutex", n);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP wakeup throughput benchmark.  Two ping-pong pairs per CPU
+ * bounce a semaphore handoff back and forth as fast as they can,
+ * counting every wakeup.  All pairs run at the same preemptible
+ * priority so the scheduler is free to spread them across CPUs.
+ */
+
+#define PAIRS_PER_CPU 2
+#define NUM_PAIRS (CONFIG_MP_NUM_CPUS * PAIRS_PER_CPU)
+#define NUM_THREADS (NUM_PAIRS * 2)
+#define STACK_SIZE 1024
+#define THREAD_PRIO 5
+
+#define WARMUP_MS 200
+#define MEASURE_MS 2000
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread threads[NUM_THREADS];
+static struct k_sem sems[NUM_THREADS];
+
+/* One counter per thread, so counting does not itself contend */
+static uint32_t wakeups[NUM_THREADS];
+
+static void pingpong(void *p1, void *p2, void *p3)
+{
+	int me = POINTER_TO_INT(p1);
+	int partner = me ^ 1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_give(&sems[partner]);
+		k_sem_take(&sems[me], K_FOREVER);
+		wakeups[me]++;
+	}
+}
+
+static uint64_t total_wakeups(void)
+{
+	uint64_t sum = 0U;
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		sum += wakeups[i];
+	}
+	return sum;
+}
+
+void main(void)
+{
+	uint64_t start, end;
+	int64_t t0, t1;
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		/* The odd thread of each pair starts out owing a wakeup */
+		k_sem_init(&sems[i], i & 1, 1);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				pingpong, INT_TO_POINTER(i), NULL, NULL,
+				THREAD_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_msleep(WARMUP_MS);
+
+	t0 = k_uptime_get();
+	start = total_wakeups();
+	k_msleep(MEASURE_MS);
+	end = total_wakeups();
+	t1 = k_uptime_get();
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	printk("cpus %d runq %s pairs %d wakeups/s %u\n",
+	       CONFIG_MP_NUM_CPUS,
+	       IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "percpu" : "shared",
+	       NUM_PAIRS, (uint32_t)((end - start) * 1000U / (t1 - t0)));
+	printk("fin\n");
+}
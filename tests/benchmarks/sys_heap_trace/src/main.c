@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/sys_heap.h>
+#include <timing/timing.h>
+#include "heap.h"
+
+#define HEAP_SZ (16 * 1024)
+#define NUM_SLOTS 256
+#define NUM_OPS 20000
+
+/* Live bytes the trace hovers around, as a fraction of the heap */
+#define TARGET_PCT 60
+
+static char heapmem[HEAP_SZ] __aligned(8);
+static struct sys_heap heap;
+
+/* A trace op allocates "size" bytes into "slot", or frees the slot
+ * if size is zero.
+ */
+struct trace_op {
+	uint16_t slot;
+	uint16_t size;
+};
+
+static struct trace_op trace[NUM_OPS];
+static void *slots[NUM_SLOTS];
+
+static uint32_t rand_state = 0x2545f491;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32: deterministic, so every build replays the same ops */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+/* Mostly a few small exact sizes (headers, timers, small net_bufs),
+ * some medium buffers and the occasional large one
+ */
+static uint16_t trace_size(void)
+{
+	static const uint16_t small[] = { 12, 16, 24, 32, 40, 48 };
+	uint32_t r = next_rand() % 100;
+
+	if (r < 75) {
+		return small[next_rand() % ARRAY_SIZE(small)];
+	} else if (r < 95) {
+		return 64 + next_rand() % 192;
+	}
+	return 512 + next_rand() % 1024;
+}
+
+static void trace_generate(void)
+{
+	uint16_t sizes[NUM_SLOTS] = { 0 };
+	uint32_t live = 0U;
+
+	for (int i = 0; i < NUM_OPS; i++) {
+		uint16_t slot = next_rand() % NUM_SLOTS;
+		bool below = live * 100U < HEAP_SZ * TARGET_PCT;
+
+		if (sizes[slot] == 0U && (below || (next_rand() & 3) == 0U)) {
+			sizes[slot] = trace_size();
+			live += sizes[slot];
+			trace[i].size = sizes[slot];
+		} else if (sizes[slot] != 0U) {
+			live -= sizes[slot];
+			sizes[slot] = 0U;
+			trace[i].size = 0U;
+		} else {
+			/* empty slot while above target: free something */
+			while (sizes[slot] == 0U) {
+				slot = (slot + 1) % NUM_SLOTS;
+			}
+			live -= sizes[slot];
+			sizes[slot] = 0U;
+			trace[i].size = 0U;
+		}
+		trace[i].slot = slot;
+	}
+}
+
+/* Largest block the heap can still hand out */
+static size_t largest_alloc(void)
+{
+	size_t lo = 0, hi = HEAP_SZ;
+
+	while (lo < hi) {
+		size_t mid = (lo + hi + 1) / 2;
+		void *p = sys_heap_alloc(&heap, mid);
+
+		if (p != NULL) {
+			sys_heap_free(&heap, p);
+			lo = mid;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return lo;
+}
+
+/* Free bytes, counting chunks parked in fast bins as free */
+static size_t free_bytes(void)
+{
+	struct z_heap *h = heap.heap;
+	size_t bytes = 0;
+
+	for (chunkid_t c = right_chunk(h, 0); c < h->end_chunk;
+	     c = right_chunk(h, c)) {
+		if (!chunk_used(h, c) && !solo_free_header(h, c)) {
+			bytes += chunksz_to_bytes(h, chunk_size(h, c));
+		}
+	}
+
+#ifdef CONFIG_SYS_HEAP_FAST_BINS
+	for (int i = 0; i < CONFIG_SYS_HEAP_FAST_BIN_SIZES; i++) {
+		bytes += h->fast_bins[i].count *
+			chunksz_to_bytes(h, min_chunk_size(h) + i);
+	}
+#endif
+
+	return bytes;
+}
+
+void main(void)
+{
+	uint64_t alloc_cycles = 0U, free_cycles = 0U;
+	uint32_t allocs = 0U, frees = 0U, failed = 0U;
+	timing_t start, end;
+	size_t largest, free;
+
+	timing_init();
+	timing_start();
+
+	trace_generate();
+	sys_heap_init(&heap, heapmem, HEAP_SZ);
+
+	for (int i = 0; i < NUM_OPS; i++) {
+		struct trace_op *op = &trace[i];
+		unsigned int key = irq_lock();
+
+		if (op->size != 0U) {
+			start = timing_counter_get();
+			slots[op->slot] = sys_heap_alloc(&heap, op->size);
+			end = timing_counter_get();
+			alloc_cycles += timing_cycles_get(&start, &end);
+			allocs++;
+			failed += slots[op->slot] == NULL ? 1 : 0;
+		} else {
+			start = timing_counter_get();
+			sys_heap_free(&heap, slots[op->slot]);
+			end = timing_counter_get();
+			free_cycles += timing_cycles_get(&start, &end);
+			frees++;
+			slots[op->slot] = NULL;
+		}
+
+		irq_unlock(key);
+	}
+
+	timing_stop();
+
+	largest = largest_alloc();
+	free = free_bytes();
+
+	printk("ops %d allocs %u frees %u failed %u\n", NUM_OPS, allocs,
+	       frees, failed);
+	printk("fast bins %s alloc %u free %u (cycles)\n",
+	       IS_ENABLED(CONFIG_SYS_HEAP_FAST_BINS) ? "on" : "off",
+	       (uint32_t)(alloc_cycles / allocs),
+	       (uint32_t)(free_cycles / frees));
+	printk("largest %u free %u frag %u%%\n", (uint32_t)largest,
+	       (uint32_t)free,
+	       free != 0 ? (uint32_t)(100U - 100U * largest / free) : 0U);
+	printk("validate %s\n", sys_heap_validate(&heap) ? "ok" : "FAILED");
+	printk("fin\n");
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+#include <timing/timing.h>
+#include <drivers/timer/system_timer.h>
+
+/* Timeout queue microbenchmark.  With N background timeouts queued,
+ * it measures the cost of adding one more timeout, aborting it again
+ * and running a sys_clock_announce() that expires nothing, i.e. the
+ * per-interrupt cost of finding the next deadline.  Compare the
+ * output between CONFIG_TIMEOUT_QUEUE_DUMB and
+ * CONFIG_TIMEOUT_QUEUE_SCALABLE to see how each backend scales.
+ */
+
+#define MAX_TIMEOUTS 512
+#define N_RUNS 64
+
+/* Far enough in the future that nothing expires during the run */
+#define BASE_TICKS 1000000
+
+static struct _timeout background[MAX_TIMEOUTS];
+static struct _timeout probe;
+
+static const int sizes[] = { 1, 8, 32, 128, 256, MAX_TIMEOUTS };
+
+static uint32_t rand_state = 0x12345678;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32: deterministic, so both backends see the same load */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static void dummy_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+}
+
+static void run(int n)
+{
+	uint64_t insert = 0U, cancel = 0U, announce = 0U;
+	timing_t start, end;
+
+	for (int i = 0; i < n; i++) {
+		z_init_timeout(&background[i]);
+		z_add_timeout(&background[i], dummy_fn,
+			      K_TICKS(BASE_TICKS + (next_rand() % BASE_TICKS)));
+	}
+
+	for (int i = 0; i < N_RUNS; i++) {
+		k_timeout_t t = K_TICKS(BASE_TICKS + (next_rand() % BASE_TICKS));
+		unsigned int key = irq_lock();
+
+		z_init_timeout(&probe);
+
+		start = timing_counter_get();
+		z_add_timeout(&probe, dummy_fn, t);
+		end = timing_counter_get();
+		insert += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		z_abort_timeout(&probe);
+		end = timing_counter_get();
+		cancel += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		sys_clock_announce(0);
+		end = timing_counter_get();
+		announce += timing_cycles_get(&start, &end);
+
+		irq_unlock(key);
+	}
+
+	for (int i = 0; i < n; i++) {
+		z_abort_timeout(&background[i]);
+	}
+
+	printk("n %4d insert %6u abort %6u announce %6u (cycles)\n", n,
+	       (uint32_t)(insert / N_RUNS), (uint32_t)(cancel / N_RUNS),
+	       (uint32_t)(announce / N_RUNS));
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	printk("Timeout queue backend: %s\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_QUEUE_SCALABLE) ? "scalable" : "dumb");
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		run(sizes[i]);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/mutex.h>
+#include <sys/fmutex.h>
+#include <app_memory/app_memdomain.h>
+#include <timing/timing.h>
+
+/* User mode mutex benchmark.  A user thread locks and unlocks a free
+ * mutex N_RUNS times, then two user threads of the same priority each
+ * lock it, yield to the other and unlock it N_RUNS times, so that every
+ * lock finds the other thread waiting or every unlock has to wake it.
+ */
+
+#define N_RUNS 1000
+#define STACK_SIZE 1024
+#define THREAD_PRIO K_PRIO_PREEMPT(1)
+
+K_APPMEM_PARTITION_DEFINE(bench_partition);
+
+K_APP_BMEM(bench_partition) SYS_MUTEX_DEFINE(smutex);
+K_APP_BMEM(bench_partition) SYS_FMUTEX_DEFINE(fmutex);
+
+K_APP_BMEM(bench_partition) static uint32_t uncontended_cycles;
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2, STACK_SIZE);
+static struct k_thread threads[2];
+
+struct bench {
+	const char *name;
+	int (*lock)(void);
+	int (*unlock)(void);
+};
+
+static int smutex_lock(void)
+{
+	return sys_mutex_lock(&smutex, K_FOREVER);
+}
+
+static int smutex_unlock(void)
+{
+	return sys_mutex_unlock(&smutex);
+}
+
+static int fmutex_lock(void)
+{
+	return sys_fmutex_lock(&fmutex, K_FOREVER);
+}
+
+static int fmutex_unlock(void)
+{
+	return sys_fmutex_unlock(&fmutex);
+}
+
+static const struct bench benches[] = {
+	{ "sys_mutex", smutex_lock, smutex_unlock },
+	{ "sys_fmutex", fmutex_lock, fmutex_unlock },
+};
+
+static void uncontended_entry(void *p1, void *p2, void *p3)
+{
+	const struct bench *bench = p1;
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (int i = 0; i < N_RUNS; i++) {
+		(void)bench->lock();
+		(void)bench->lock();
+		(void)bench->unlock();
+		(void)bench->unlock();
+	}
+	end = timing_counter_get();
+
+	uncontended_cycles = (uint32_t)timing_cycles_get(&start, &end);
+}
+
+static void contended_entry(void *p1, void *p2, void *p3)
+{
+	const struct bench *bench = p1;
+
+	for (int i = 0; i < N_RUNS; i++) {
+		(void)bench->lock();
+		k_yield();
+		(void)bench->unlock();
+	}
+}
+
+static void spawn(int i, k_thread_entry_t entry, const struct bench *bench)
+{
+	k_thread_create(&threads[i], stacks[i], STACK_SIZE, entry,
+			(void *)bench, NULL, NULL, THREAD_PRIO,
+			K_USER | K_INHERIT_PERMS, K_NO_WAIT);
+}
+
+static void run(const struct bench *bench)
+{
+	timing_t start, end;
+	uint32_t contended;
+
+	spawn(0, uncontended_entry, bench);
+	k_thread_join(&threads[0], K_FOREVER);
+
+	start = timing_counter_get();
+	spawn(0, contended_entry, bench);
+	spawn(1, contended_entry, bench);
+	k_thread_join(&threads[0], K_FOREVER);
+	k_thread_join(&threads[1], K_FOREVER);
+	end = timing_counter_get();
+	contended = (uint32_t)timing_cycles_get(&start, &end);
+
+	printk("%-10s uncontended %6u cycles\n", bench->name,
+	       uncontended_cycles / (N_RUNS * 2));
+	printk("%-10s contended   %6u cycles\n", bench->name,
+	       contended / (N_RUNS * 2));
+}
+
+void main(void)
+{
+	k_mem_domain_add_partition(&k_mem_domain_default, &bench_partition);
+
+	timing_init();
+	timing_start();
+
+	for (int i = 0; i < ARRAY_SIZE(benches); i++) {
+		run(&benches[i]);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
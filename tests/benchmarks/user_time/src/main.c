@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <app_memory/app_memdomain.h>
+#include <timing/timing.h>
+
+/* User mode time benchmark.  A user thread reads the uptime N_RUNS times
+ * with each of the routines below and reports the average cost of a call.
+ */
+
+#define N_RUNS 1000
+#define STACK_SIZE 1024
+#define THREAD_PRIO K_PRIO_PREEMPT(1)
+
+K_APPMEM_PARTITION_DEFINE(bench_partition);
+
+K_APP_BMEM(bench_partition) static volatile int64_t sink;
+K_APP_BMEM(bench_partition) static uint32_t cycles;
+
+static K_THREAD_STACK_DEFINE(stack, STACK_SIZE);
+static struct k_thread thread;
+
+struct bench {
+	const char *name;
+	int64_t (*read)(void);
+};
+
+static int64_t uptime_syscall(void)
+{
+	return z_uptime_ticks();
+}
+
+static int64_t uptime_ticks(void)
+{
+	return k_uptime_ticks();
+}
+
+static int64_t uptime_get(void)
+{
+	return k_uptime_get();
+}
+
+static int64_t cyc_to_ns(void)
+{
+	return k_cyc_to_ns_floor64(sink);
+}
+
+static const struct bench benches[] = {
+	{ "z_uptime_ticks", uptime_syscall },
+	{ "k_uptime_ticks", uptime_ticks },
+	{ "k_uptime_get", uptime_get },
+	{ "k_cyc_to_ns", cyc_to_ns },
+};
+
+static void bench_entry(void *p1, void *p2, void *p3)
+{
+	const struct bench *bench = p1;
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (int i = 0; i < N_RUNS; i++) {
+		sink = bench->read();
+	}
+	end = timing_counter_get();
+
+	cycles = (uint32_t)timing_cycles_get(&start, &end);
+}
+
+static void run(const struct bench *bench)
+{
+	k_thread_create(&thread, stack, STACK_SIZE, bench_entry,
+			(void *)bench, NULL, NULL, THREAD_PRIO,
+			K_USER | K_INHERIT_PERMS, K_NO_WAIT);
+	k_thread_join(&thread, K_FOREVER);
+
+	printk("%-16s %6u cycles\n", bench->name, cycles / N_RUNS);
+}
+
+void main(void)
+{
+	k_mem_domain_add_partition(&k_mem_domain_default, &bench_partition);
+
+	timing_init();
+	timing_start();
+
+	for (int i = 0; i < ARRAY_SIZE(benches); i++) {
+		run(&benches[i]);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/p4wq.h>
+
+/* SMP work queue throughput benchmark.  ITEMS_PER_CPU items per CPU
+ * each burn BURN_ITERATIONS loop iterations and resubmit themselves,
+ * first on a single threaded k_work_q, then on a k_work_q with a
+ * worker per CPU, then on a p4wq with a thread per CPU.  A timer stops
+ * the resubmissions after MEASURE_MS and samples the number of items
+ * processed so far, so the measurement doesn't depend on the main
+ * thread getting a CPU while the queues are saturated.
+ */
+
+#define NUM_CPUS CONFIG_MP_NUM_CPUS
+#define ITEMS_PER_CPU 4
+#define NUM_ITEMS (NUM_CPUS * ITEMS_PER_CPU)
+#define BURN_ITERATIONS 2000
+#define STACK_SIZE 1024
+#define WORKQ_PRIO K_PRIO_PREEMPT(1)
+
+#define MEASURE_MS 2000
+#define SETTLE_MS 100
+
+static K_THREAD_STACK_DEFINE(single_stack, STACK_SIZE);
+static struct k_work_q single_queue;
+
+static K_THREAD_STACK_DEFINE(pool_stack, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, NUM_CPUS - 1, STACK_SIZE);
+static struct k_work_q pool_queue;
+static struct k_work_q_worker workers[NUM_CPUS - 1];
+
+K_P4WQ_DEFINE(p4wq, NUM_CPUS, STACK_SIZE);
+
+static struct k_work works[NUM_ITEMS];
+static struct k_p4wq_work p4works[NUM_ITEMS];
+
+/* One counter per item, so counting does not itself contend */
+static uint32_t processed[NUM_ITEMS];
+
+static struct k_work_q *cur_queue;
+static volatile bool running;
+static uint32_t sampled;
+
+static void burn(void)
+{
+	volatile uint32_t acc = 0;
+
+	for (int i = 0; i < BURN_ITERATIONS; i++) {
+		acc += i;
+	}
+}
+
+static void work_handler(struct k_work *work)
+{
+	burn();
+	processed[work - works]++;
+	if (running) {
+		(void)k_work_submit_to_queue(cur_queue, work);
+	}
+}
+
+static void p4wq_handler(struct k_p4wq_work *work)
+{
+	burn();
+	processed[work - p4works]++;
+	if (running) {
+		work->priority = 0;
+		work->deadline = 0;
+		k_p4wq_submit(&p4wq, work);
+	}
+}
+
+static void stop_fn(struct k_timer *timer)
+{
+	uint32_t sum = 0U;
+
+	running = false;
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		sum += processed[i];
+	}
+	sampled = sum;
+}
+
+K_TIMER_DEFINE(stop_timer, stop_fn, NULL);
+
+static void start_measurement(void)
+{
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		processed[i] = 0U;
+	}
+	running = true;
+	k_timer_start(&stop_timer, K_MSEC(MEASURE_MS), K_NO_WAIT);
+}
+
+static void report(const char *name, int threads)
+{
+	(void)k_timer_status_sync(&stop_timer);
+	printk("%-8s threads %2d items/s %u\n", name, threads,
+	       (uint32_t)((uint64_t)sampled * 1000U / MEASURE_MS));
+}
+
+static void run_work_q(struct k_work_q *queue, int threads)
+{
+	cur_queue = queue;
+	start_measurement();
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		k_work_init(&works[i], work_handler);
+		(void)k_work_submit_to_queue(queue, &works[i]);
+	}
+
+	report("k_work_q", threads);
+	(void)k_work_queue_drain(queue, false);
+}
+
+static void run_p4wq(void)
+{
+	start_measurement();
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		p4works[i].priority = 0;
+		p4works[i].deadline = 0;
+		p4works[i].handler = p4wq_handler;
+		k_p4wq_submit(&p4wq, &p4works[i]);
+	}
+
+	report("p4wq", NUM_CPUS);
+
+	/* Nothing resubmits any more, let the last items finish */
+	k_msleep(SETTLE_MS);
+}
+
+void main(void)
+{
+	k_work_queue_start(&single_queue, single_stack,
+			   K_THREAD_STACK_SIZEOF(single_stack),
+			   WORKQ_PRIO, NULL);
+
+	k_work_queue_start(&pool_queue, pool_stack,
+			   K_THREAD_STACK_SIZEOF(pool_stack),
+			   WORKQ_PRIO, NULL);
+	for (int i = 0; i < NUM_CPUS - 1; i++) {
+		(void)k_work_queue_add_worker(&pool_queue, &workers[i],
+				worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				WORKQ_PRIO, -1);
+	}
+
+	run_work_q(&single_queue, 1);
+	run_work_q(&pool_queue, NUM_CPUS);
+	run_p4wq();
+
+	printk("fin\n");
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timing/timing.h>
+
+/* Copy vs claim benchmark.  A low priority producer thread fills
+ * N_FRAMES frames and passes them to the main thread, which sums the
+ * words of each frame, through a k_msgq and a k_pipe holding
+ * QUEUE_FRAMES frames.  The copying variants build and check the frame
+ * in a local buffer, the claiming variants do so in the queue's buffer.
+ */
+
+#define MAX_FRAME 4096
+#define QUEUE_FRAMES 4
+#define N_FRAMES 200
+#define STACK_SIZE 1024
+
+static const size_t sizes[] = { 1024, 2048, MAX_FRAME };
+
+static char __aligned(4) msgq_buf[QUEUE_FRAMES * MAX_FRAME];
+static struct k_msgq msgq;
+
+static unsigned char __aligned(4) pipe_buf[QUEUE_FRAMES * MAX_FRAME];
+static struct k_pipe pipe;
+
+static uint32_t producer_frame[MAX_FRAME / sizeof(uint32_t)];
+static uint32_t consumer_frame[MAX_FRAME / sizeof(uint32_t)];
+
+static K_THREAD_STACK_DEFINE(producer_stack, STACK_SIZE);
+static struct k_thread producer_thread;
+
+static size_t frame_size;
+static uint32_t checksum;
+
+static void fill(uint32_t *frame, uint32_t seq)
+{
+	for (size_t i = 0; i < frame_size / sizeof(uint32_t); i++) {
+		frame[i] = seq + i;
+	}
+}
+
+static void check(const uint32_t *frame)
+{
+	for (size_t i = 0; i < frame_size / sizeof(uint32_t); i++) {
+		checksum += frame[i];
+	}
+}
+
+static void msgq_copy_producer(void *p1, void *p2, void *p3)
+{
+	for (uint32_t seq = 0; seq < N_FRAMES; seq++) {
+		fill(producer_frame, seq);
+		(void)k_msgq_put(&msgq, producer_frame, K_FOREVER);
+	}
+}
+
+static void msgq_claim_producer(void *p1, void *p2, void *p3)
+{
+	void *slot;
+
+	for (uint32_t seq = 0; seq < N_FRAMES; seq++) {
+		(void)k_msgq_put_claim(&msgq, &slot, K_FOREVER);
+		fill(slot, seq);
+		(void)k_msgq_put_finish(&msgq, true);
+	}
+}
+
+static void msgq_copy_consumer(void)
+{
+	for (int i = 0; i < N_FRAMES; i++) {
+		(void)k_msgq_get(&msgq, consumer_frame, K_FOREVER);
+		check(consumer_frame);
+	}
+}
+
+static void msgq_claim_consumer(void)
+{
+	void *frame;
+
+	for (int i = 0; i < N_FRAMES; i++) {
+		(void)k_msgq_get_claim(&msgq, &frame, 1, K_FOREVER);
+		check(frame);
+		(void)k_msgq_get_finish(&msgq, 1);
+	}
+}
+
+static void pipe_copy_producer(void *p1, void *p2, void *p3)
+{
+	size_t written;
+
+	for (uint32_t seq = 0; seq < N_FRAMES; seq++) {
+		fill(producer_frame, seq);
+		(void)k_pipe_put(&pipe, producer_frame, frame_size, &written,
+				 frame_size, K_FOREVER);
+	}
+}
+
+/* The pipe only ever holds whole frames and its buffer is a multiple of
+ * the frame size, so claims never stop short of a frame
+ */
+static void pipe_claim_producer(void *p1, void *p2, void *p3)
+{
+	void *mem;
+
+	for (uint32_t seq = 0; seq < N_FRAMES; seq++) {
+		(void)k_pipe_put_claim(&pipe, &mem, frame_size, K_FOREVER);
+		fill(mem, seq);
+		(void)k_pipe_put_finish(&pipe, frame_size);
+	}
+}
+
+static void pipe_copy_consumer(void)
+{
+	size_t read;
+
+	for (int i = 0; i < N_FRAMES; i++) {
+		(void)k_pipe_get(&pipe, consumer_frame, frame_size, &read,
+				 frame_size, K_FOREVER);
+		check(consumer_frame);
+	}
+}
+
+static void pipe_claim_consumer(void)
+{
+	void *frame;
+
+	for (int i = 0; i < N_FRAMES; i++) {
+		(void)k_pipe_get_claim(&pipe, &frame, frame_size, K_FOREVER);
+		check(frame);
+		(void)k_pipe_get_finish(&pipe, frame_size);
+	}
+}
+
+/* Returns cycles per frame, the consumer's checksum is left in checksum */
+static uint32_t run(k_thread_entry_t producer, void (*consumer)(void))
+{
+	timing_t start, end;
+
+	k_msgq_init(&msgq, msgq_buf, frame_size, QUEUE_FRAMES);
+	k_pipe_init(&pipe, pipe_buf, frame_size * QUEUE_FRAMES);
+	checksum = 0U;
+
+	start = timing_counter_get();
+
+	k_thread_create(&producer_thread, producer_stack,
+			K_THREAD_STACK_SIZEOF(producer_stack), producer,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(10), 0, K_NO_WAIT);
+	consumer();
+	k_thread_join(&producer_thread, K_FOREVER);
+
+	end = timing_counter_get();
+
+	return (uint32_t)(timing_cycles_get(&start, &end) / N_FRAMES);
+}
+
+void main(void)
+{
+	uint32_t msgq_copy, msgq_claim, pipe_copy, pipe_claim, sum;
+	bool ok;
+
+	timing_init();
+	timing_start();
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		frame_size = sizes[i];
+
+		msgq_copy = run(msgq_copy_producer, msgq_copy_consumer);
+		sum = checksum;
+		msgq_claim = run(msgq_claim_producer, msgq_claim_consumer);
+		ok = (checksum == sum);
+		pipe_copy = run(pipe_copy_producer, pipe_copy_consumer);
+		ok = ok && (checksum == sum);
+		pipe_claim = run(pipe_claim_producer, pipe_claim_consumer);
+		ok = ok && (checksum == sum);
+
+		if (!ok) {
+			printk("frame %4zu: checksum mismatch\n", frame_size);
+		}
+
+		printk("frame %4zu msgq %8u %8u pipe %8u %8u (cycles)\n",
+		       frame_size, msgq_copy, msgq_claim, pipe_copy,
+		       pipe_claim);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -29,6 +29,23 @@ extern void test_fifo_loop(void);
 extern void test_fifo_cancel_wait(void);
 extern void test_fifo_is_empty_thread(void);
 extern void test_fifo_is_empty_isr(void);
+#ifdef CONFIG_QUEUE_MPSC
+extern void test_fifo_mpsc_put_get(void);
+extern void test_fifo_mpsc_isr2thread(void);
+extern void test_fifo_mpsc_poll(void);
+extern void test_fifo_mpsc_producers(void);
+#else
+#define dummy_test(_name) \
+	static void _name(void) \
+	{ \
+		ztest_test_skip(); \
+	}
+
+dummy_test(test_fifo_mpsc_put_get);
+dummy_test(test_fifo_mpsc_isr2thread);
+dummy_test(test_fifo_mpsc_poll);
+dummy_test(test_fifo_mpsc_producers);
+#endif
 
 /*test case main entry*/
 void test_main(void)
@@ -41,6 +58,10 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_fifo_loop),
 			 ztest_1cpu_unit_test(test_fifo_cancel_wait),
 			 ztest_unit_test(test_fifo_is_empty_thread),
-			 ztest_unit_test(test_fifo_is_empty_isr));
+			 ztest_unit_test(test_fifo_is_empty_isr),
+			 ztest_unit_test(test_fifo_mpsc_put_get),
+			 ztest_1cpu_unit_test(test_fifo_mpsc_isr2thread),
+			 ztest_1cpu_unit_test(test_fifo_mpsc_poll),
+			 ztest_unit_test(test_fifo_mpsc_producers));
 	ztest_run_test_suite(fifo_api);
 }
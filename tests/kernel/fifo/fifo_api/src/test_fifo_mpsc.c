@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_fifo.h"
+
+#ifdef CONFIG_QUEUE_MPSC
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LIST_LEN 4
+#define N_PRODUCERS 3
+#define N_ITEMS 200
+
+/**TESTPOINT: init via K_FIFO_DEFINE_MPSC*/
+K_FIFO_DEFINE_MPSC(kfifo_mpsc);
+
+static struct k_fifo fifo_mpsc;
+static fdata_t data[LIST_LEN];
+static fdata_t prod_data[N_PRODUCERS][N_ITEMS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(prod_stacks, N_PRODUCERS, STACK_SIZE);
+static struct k_thread prod_threads[N_PRODUCERS];
+
+static void put_isr(const void *p)
+{
+	k_fifo_put(&fifo_mpsc, (void *)p);
+}
+
+static void put_entry(void *p1, void *p2, void *p3)
+{
+	k_msleep(20);
+	irq_offload(put_isr, p1);
+}
+
+static void producer_entry(void *p1, void *p2, void *p3)
+{
+	fdata_t *items = p1;
+
+	for (int i = 0; i < N_ITEMS; i++) {
+		items[i].data = i;
+		k_fifo_put(&fifo_mpsc, &items[i]);
+		if ((i % 16) == 0) {
+			k_yield();
+		}
+	}
+}
+
+static void check_order(struct k_fifo *fifo, int n)
+{
+	for (int i = 0; i < n; i++) {
+		fdata_t *rx = k_fifo_get(fifo, K_NO_WAIT);
+
+		zassert_equal(rx, &data[i], "item %d out of order", i);
+	}
+	zassert_true(k_fifo_is_empty(fifo), "");
+	zassert_is_null(k_fifo_get(fifo, K_NO_WAIT), "");
+}
+
+/**
+ * @addtogroup kernel_fifo_tests
+ * @{
+ */
+
+/**
+ * @brief Test appending to and getting from an MPSC FIFO
+ *
+ * @see k_fifo_init_mpsc(), K_FIFO_DEFINE_MPSC()
+ */
+void test_fifo_mpsc_put_get(void)
+{
+	sys_slist_t list;
+
+	k_fifo_init_mpsc(&fifo_mpsc);
+
+	zassert_true(k_fifo_is_empty(&fifo_mpsc), "");
+	k_fifo_put(&fifo_mpsc, &data[0]);
+	zassert_false(k_fifo_is_empty(&fifo_mpsc), "");
+	zassert_equal(k_fifo_peek_head(&fifo_mpsc), &data[0], "");
+	irq_offload(put_isr, &data[1]);
+	k_fifo_put(&fifo_mpsc, &data[2]);
+	k_fifo_put(&fifo_mpsc, &data[3]);
+	check_order(&fifo_mpsc, LIST_LEN);
+
+	for (int i = 0; i < LIST_LEN - 1; i++) {
+		data[i].snode.next = &data[i + 1].snode;
+	}
+	data[LIST_LEN - 1].snode.next = NULL;
+	k_fifo_put_list(&fifo_mpsc, &data[0], &data[LIST_LEN - 1]);
+	check_order(&fifo_mpsc, LIST_LEN);
+
+	sys_slist_init(&list);
+	k_fifo_put(&kfifo_mpsc, &data[0]);
+	for (int i = 1; i < LIST_LEN; i++) {
+		sys_slist_append(&list, &data[i].snode);
+	}
+	k_fifo_put_slist(&kfifo_mpsc, &list);
+	check_order(&kfifo_mpsc, LIST_LEN);
+}
+
+/**
+ * @brief Test that an ISR put wakes the waiting consumer
+ */
+void test_fifo_mpsc_isr2thread(void)
+{
+	k_fifo_init_mpsc(&fifo_mpsc);
+
+	k_thread_create(&prod_threads[0], prod_stacks[0], STACK_SIZE,
+			put_entry, &data[0], NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	zassert_equal(k_fifo_get(&fifo_mpsc, K_MSEC(500)), &data[0],
+		      "consumer not woken");
+	zassert_true(k_fifo_is_empty(&fifo_mpsc), "");
+	k_thread_join(&prod_threads[0], K_FOREVER);
+
+	zassert_is_null(k_fifo_get(&fifo_mpsc, K_MSEC(20)), "");
+}
+
+/**
+ * @brief Test that k_poll() sees items in an MPSC FIFO
+ */
+void test_fifo_mpsc_poll(void)
+{
+	struct k_poll_event event;
+
+	k_fifo_init_mpsc(&fifo_mpsc);
+	k_poll_event_init(&event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &fifo_mpsc);
+
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), -EAGAIN, "");
+
+	k_thread_create(&prod_threads[0], prod_stacks[0], STACK_SIZE,
+			put_entry, &data[0], NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	zassert_equal(k_poll(&event, 1, K_MSEC(500)), 0, "");
+	zassert_equal(event.state, K_POLL_STATE_FIFO_DATA_AVAILABLE, "");
+	zassert_equal(k_fifo_get(&fifo_mpsc, K_NO_WAIT), &data[0], "");
+	k_thread_join(&prod_threads[0], K_FOREVER);
+}
+
+/**
+ * @brief Test concurrent producers
+ *
+ * @details Every producer's items must arrive exactly once and in the
+ * order it put them.
+ */
+void test_fifo_mpsc_producers(void)
+{
+	int next[N_PRODUCERS] = { 0 };
+
+	k_fifo_init_mpsc(&fifo_mpsc);
+
+	for (int i = 0; i < N_PRODUCERS; i++) {
+		k_thread_create(&prod_threads[i], prod_stacks[i], STACK_SIZE,
+				producer_entry, prod_data[i], NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int n = 0; n < N_PRODUCERS * N_ITEMS; n++) {
+		fdata_t *rx = k_fifo_get(&fifo_mpsc, K_MSEC(1000));
+		int p;
+
+		zassert_not_null(rx, "item %d lost", n);
+		p = (rx - &prod_data[0][0]) / N_ITEMS;
+		zassert_true(p >= 0 && p < N_PRODUCERS, "bogus item");
+		zassert_equal(rx->data, next[p], "producer %d out of order", p);
+		next[p]++;
+	}
+
+	for (int i = 0; i < N_PRODUCERS; i++) {
+		k_thread_join(&prod_threads[i], K_FOREVER);
+	}
+	zassert_true(k_fifo_is_empty(&fifo_mpsc), "");
+}
+
+/**
+ * @}
+ */
+
+#endif /* CONFIG_QUEUE_MPSC */
@@ -23,6 +23,10 @@ extern void test_msgq_alloc(void);
 extern void test_msgq_pend_thread(void);
 extern void test_msgq_empty(void);
 extern void test_msgq_full(void);
+extern void test_msgq_claim(void);
+extern void test_msgq_claim_busy(void);
+extern void test_msgq_claim_wait(void);
+extern void test_msgq_get_batch(void);
 #ifdef CONFIG_USERSPACE
 extern void test_msgq_user_thread(void);
 extern void test_msgq_user_thread_overflow(void);
@@ -84,6 +88,10 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_msgq_pend_thread),
 			 ztest_1cpu_unit_test(test_msgq_empty),
 			 ztest_1cpu_unit_test(test_msgq_full),
+			 ztest_unit_test(test_msgq_claim),
+			 ztest_unit_test(test_msgq_claim_busy),
+			 ztest_1cpu_unit_test(test_msgq_claim_wait),
+			 ztest_1cpu_unit_test(test_msgq_get_batch),
 			 ztest_unit_test(test_msgq_alloc));
 	ztest_run_test_suite(msgq_api);
 }
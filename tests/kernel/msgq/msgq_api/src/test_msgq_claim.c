@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+static ZTEST_BMEM char __aligned(4) claim_buf[MSGQ_LEN * MSG_SIZE];
+static struct k_msgq claim_msgq;
+
+static K_THREAD_STACK_DEFINE(claim_stack, STACK_SIZE);
+static struct k_thread claim_thread;
+
+static uint32_t msgs[MSGQ_LEN] = { MSG0, MSG1 };
+
+static void put_msg_entry(void *p1, void *p2, void *p3)
+{
+	k_msleep(TIMEOUT_MS / 2);
+	zassert_equal(k_msgq_put(&claim_msgq, &msgs[0], K_NO_WAIT), 0, "");
+}
+
+static void get_msg_entry(void *p1, void *p2, void *p3)
+{
+	uint32_t data;
+
+	k_msleep(TIMEOUT_MS / 2);
+	zassert_equal(k_msgq_get(&claim_msgq, &data, K_NO_WAIT), 0, "");
+	zassert_equal(data, MSG0, "");
+}
+
+static void spawn(k_thread_entry_t entry)
+{
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE, entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+}
+
+/**
+ * @brief Test writing and reading messages in place
+ *
+ * @ingroup kernel_message_queue_tests
+ *
+ * @see k_msgq_put_claim(), k_msgq_put_finish(), k_msgq_get_claim(),
+ * k_msgq_get_finish()
+ */
+void test_msgq_claim(void)
+{
+	uint32_t data;
+	void *slot;
+
+	k_msgq_init(&claim_msgq, claim_buf, MSG_SIZE, MSGQ_LEN);
+
+	/* an aborted claim leaves the queue alone */
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, K_NO_WAIT), 0, "");
+	zassert_equal(k_msgq_put_finish(&claim_msgq, false), 0, "");
+	zassert_equal(k_msgq_num_used_get(&claim_msgq), 0, "");
+	zassert_equal(k_msgq_put_finish(&claim_msgq, true), -EINVAL,
+		      "finished without a claim");
+
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, K_NO_WAIT),
+			      0, "");
+		*(uint32_t *)slot = msgs[i];
+		zassert_equal(k_msgq_put_finish(&claim_msgq, true), 0, "");
+	}
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, K_NO_WAIT), -ENOMSG,
+		      "claimed a slot of a full queue");
+
+	/* messages are claimed in order, and released partially */
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, MSGQ_LEN,
+				       K_NO_WAIT), MSGQ_LEN, "");
+	zassert_equal(((uint32_t *)slot)[0], MSG0, "");
+	zassert_equal(((uint32_t *)slot)[1], MSG1, "");
+	zassert_equal(k_msgq_get_finish(&claim_msgq, MSGQ_LEN + 1), -EINVAL,
+		      "released more than claimed");
+	zassert_equal(k_msgq_get_finish(&claim_msgq, 1), 0, "");
+
+	zassert_equal(k_msgq_get(&claim_msgq, &data, K_NO_WAIT), 0, "");
+	zassert_equal(data, MSG1, "");
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, 1, K_NO_WAIT),
+		      -ENOMSG, "claimed a message of an empty queue");
+}
+
+/**
+ * @brief Test that copying calls fail while a claim is held
+ *
+ * @ingroup kernel_message_queue_tests
+ */
+void test_msgq_claim_busy(void)
+{
+	uint32_t data;
+	void *slot;
+
+	k_msgq_init(&claim_msgq, claim_buf, MSG_SIZE, MSGQ_LEN);
+
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, K_NO_WAIT), 0, "");
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, K_NO_WAIT), -EBUSY,
+		      "second put claim");
+	zassert_equal(k_msgq_put(&claim_msgq, &msgs[0], K_NO_WAIT), -EBUSY,
+		      "put during a put claim");
+	*(uint32_t *)slot = msgs[0];
+	zassert_equal(k_msgq_put_finish(&claim_msgq, true), 0, "");
+
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, 1, K_NO_WAIT), 1,
+		      "");
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, 1, K_NO_WAIT),
+		      -EBUSY, "second get claim");
+	zassert_equal(k_msgq_get(&claim_msgq, &data, K_NO_WAIT), -EBUSY,
+		      "get during a get claim");
+	zassert_equal(k_msgq_get_batch(&claim_msgq, &data, 1, K_NO_WAIT),
+		      -EBUSY, "batch get during a get claim");
+
+	/* puts still work while messages are claimed */
+	zassert_equal(k_msgq_put(&claim_msgq, &msgs[1], K_NO_WAIT), 0, "");
+	zassert_equal(k_msgq_get_finish(&claim_msgq, 1), 0, "");
+
+	zassert_equal(k_msgq_get(&claim_msgq, &data, K_NO_WAIT), 0, "");
+	zassert_equal(data, MSG1, "");
+
+	/* purging drops a get claim */
+	zassert_equal(k_msgq_put(&claim_msgq, &msgs[0], K_NO_WAIT), 0, "");
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, 1, K_NO_WAIT), 1,
+		      "");
+	k_msgq_purge(&claim_msgq);
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, 1, K_NO_WAIT),
+		      -ENOMSG, "");
+}
+
+/**
+ * @brief Test that blocked claimers are served by copying calls
+ *
+ * @ingroup kernel_message_queue_tests
+ */
+void test_msgq_claim_wait(void)
+{
+	void *slot;
+
+	k_msgq_init(&claim_msgq, claim_buf, MSG_SIZE, MSGQ_LEN);
+
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, 1, TIMEOUT),
+		      -EAGAIN, "");
+
+	/* a message put while waiting is claimed for us */
+	spawn(put_msg_entry);
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &slot, MSGQ_LEN,
+				       K_FOREVER), 1, "");
+	zassert_equal(*(uint32_t *)slot, MSG0, "");
+	zassert_equal(k_msgq_get_finish(&claim_msgq, 1), 0, "");
+	k_thread_join(&claim_thread, K_FOREVER);
+
+	/* so is a slot freed while waiting */
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put(&claim_msgq, &msgs[0], K_NO_WAIT),
+			      0, "");
+	}
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, TIMEOUT), -EAGAIN,
+		      "");
+
+	spawn(get_msg_entry);
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &slot, K_FOREVER), 0, "");
+	*(uint32_t *)slot = msgs[1];
+	zassert_equal(k_msgq_put_finish(&claim_msgq, true), 0, "");
+	k_thread_join(&claim_thread, K_FOREVER);
+
+	zassert_equal(k_msgq_num_used_get(&claim_msgq), MSGQ_LEN, "");
+	k_msgq_purge(&claim_msgq);
+}
+
+/**
+ * @brief Test getting several messages at once
+ *
+ * @ingroup kernel_message_queue_tests
+ *
+ * @see k_msgq_get_batch()
+ */
+void test_msgq_get_batch(void)
+{
+	uint32_t data[MSGQ_LEN + 1];
+
+	k_msgq_init(&claim_msgq, claim_buf, MSG_SIZE, MSGQ_LEN);
+
+	zassert_equal(k_msgq_get_batch(&claim_msgq, data, MSGQ_LEN + 1,
+				       K_NO_WAIT), -ENOMSG, "");
+	zassert_equal(k_msgq_get_batch(&claim_msgq, data, 0, K_NO_WAIT),
+		      -EINVAL, "");
+
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put(&claim_msgq, &msgs[i], K_NO_WAIT),
+			      0, "");
+	}
+
+	zassert_equal(k_msgq_get_batch(&claim_msgq, data, MSGQ_LEN + 1,
+				       K_NO_WAIT), MSGQ_LEN, "");
+	zassert_equal(data[0], MSG0, "");
+	zassert_equal(data[1], MSG1, "");
+
+	/* blocks for the first message only */
+	spawn(put_msg_entry);
+	zassert_equal(k_msgq_get_batch(&claim_msgq, data, MSGQ_LEN,
+				       K_FOREVER), 1, "");
+	zassert_equal(data[0], MSG0, "");
+	k_thread_join(&claim_thread, K_FOREVER);
+}
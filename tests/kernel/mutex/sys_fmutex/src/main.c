@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/fmutex.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_THREADS 3
+#define N_INCREMENTS 200
+#define TIMEOUT_MS 100
+
+#ifdef CONFIG_USERSPACE
+#define THREAD_OPTIONS (K_USER | K_INHERIT_PERMS)
+#else
+#define THREAD_OPTIONS 0
+#endif
+
+ZTEST_BMEM SYS_FMUTEX_DEFINE(fmutex);
+ZTEST_BMEM SYS_FCONDVAR_DEFINE(fcondvar);
+
+static ZTEST_BMEM int helper_ret[N_THREADS];
+static ZTEST_BMEM int counter;
+static ZTEST_BMEM bool ready;
+
+K_THREAD_STACK_ARRAY_DEFINE(stacks, N_THREADS, STACK_SIZE);
+static struct k_thread threads[N_THREADS];
+
+static void spawn(int i, k_thread_entry_t entry)
+{
+	k_thread_create(&threads[i], stacks[i], STACK_SIZE, entry,
+			INT_TO_POINTER(i), NULL, NULL,
+			k_thread_priority_get(k_current_get()),
+			THREAD_OPTIONS, K_NO_WAIT);
+}
+
+static void join_all(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+}
+
+static void not_owner_entry(void *p1, void *p2, void *p3)
+{
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), -EBUSY, "");
+	zassert_equal(sys_fmutex_lock(&fmutex, K_MSEC(TIMEOUT_MS)), -EAGAIN,
+		      "");
+	helper_ret[0] = sys_fmutex_unlock(&fmutex);
+}
+
+static void increment_entry(void *p1, void *p2, void *p3)
+{
+	int c;
+
+	for (int i = 0; i < N_INCREMENTS; i++) {
+		zassert_equal(sys_fmutex_lock(&fmutex, K_FOREVER), 0, "");
+		c = counter;
+		/* let the others pile up on the mutex */
+		k_yield();
+		counter = c + 1;
+		zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+	}
+}
+
+static void wait_entry(void *p1, void *p2, void *p3)
+{
+	int i = POINTER_TO_INT(p1);
+
+	zassert_equal(sys_fmutex_lock(&fmutex, K_FOREVER), 0, "");
+	while (!ready) {
+		helper_ret[i] = sys_fcondvar_wait(&fcondvar, &fmutex,
+						  K_FOREVER);
+		if (helper_ret[i] != 0) {
+			break;
+		}
+	}
+	counter++;
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+}
+
+static void wake_up(bool all)
+{
+	/* let the waiters wait */
+	k_msleep(TIMEOUT_MS / 10);
+
+	zassert_equal(sys_fmutex_lock(&fmutex, K_FOREVER), 0, "");
+	ready = true;
+	if (all) {
+		zassert_equal(sys_fcondvar_broadcast(&fcondvar), 0, "");
+	} else {
+		zassert_equal(sys_fcondvar_signal(&fcondvar), 0, "");
+	}
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+}
+
+/**
+ * @brief Test recursive locking and unlocking
+ *
+ * @ingroup kernel_mutex_tests
+ *
+ * @see sys_fmutex_lock(), sys_fmutex_unlock()
+ */
+void test_fmutex_recursive(void)
+{
+	zassert_equal(sys_fmutex_init(&fmutex), 0, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), -EINVAL,
+		      "unlocked an unlocked mutex");
+
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), 0, "");
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), 0, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), -EINVAL,
+		      "unlocked more often than locked");
+}
+
+/**
+ * @brief Test that only the owner gets and unlocks the mutex
+ *
+ * @ingroup kernel_mutex_tests
+ */
+void test_fmutex_owner(void)
+{
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), 0, "");
+	spawn(0, not_owner_entry);
+	join_all(1);
+	zassert_equal(helper_ret[0], -EPERM, "unlocked another's mutex");
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+}
+
+/**
+ * @brief Test mutual exclusion between contending threads
+ *
+ * @ingroup kernel_mutex_tests
+ */
+void test_fmutex_contended(void)
+{
+	counter = 0;
+
+	for (int i = 0; i < N_THREADS; i++) {
+		spawn(i, increment_entry);
+	}
+	join_all(N_THREADS);
+
+	zassert_equal(counter, N_THREADS * N_INCREMENTS, "lost increments");
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), 0,
+		      "mutex left locked");
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+}
+
+/**
+ * @brief Test that waiting on a condition variable times out
+ *
+ * @ingroup kernel_mutex_tests
+ *
+ * @see sys_fcondvar_wait()
+ */
+void test_fcondvar_timeout(void)
+{
+	zassert_equal(sys_fcondvar_init(&fcondvar), 0, "");
+	zassert_equal(sys_fcondvar_wait(&fcondvar, &fmutex, K_NO_WAIT),
+		      -EPERM, "waited without the mutex");
+
+	/* the mutex is locked again with its lock count */
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), 0, "");
+	zassert_equal(sys_fmutex_lock(&fmutex, K_NO_WAIT), 0, "");
+	zassert_equal(sys_fcondvar_wait(&fcondvar, &fmutex,
+					K_MSEC(TIMEOUT_MS)), -EAGAIN, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), 0, "");
+	zassert_equal(sys_fmutex_unlock(&fmutex), -EINVAL, "");
+}
+
+/**
+ * @brief Test that a signal wakes up a waiting thread
+ *
+ * @ingroup kernel_mutex_tests
+ *
+ * @see sys_fcondvar_signal()
+ */
+void test_fcondvar_signal(void)
+{
+	counter = 0;
+	ready = false;
+
+	spawn(0, wait_entry);
+	wake_up(false);
+	join_all(1);
+
+	zassert_equal(helper_ret[0], 0, "");
+	zassert_equal(counter, 1, "");
+}
+
+/**
+ * @brief Test that a broadcast wakes up all waiting threads
+ *
+ * @ingroup kernel_mutex_tests
+ *
+ * @see sys_fcondvar_broadcast()
+ */
+void test_fcondvar_broadcast(void)
+{
+	counter = 0;
+	ready = false;
+
+	for (int i = 0; i < N_THREADS; i++) {
+		spawn(i, wait_entry);
+	}
+	wake_up(true);
+	join_all(N_THREADS);
+
+	for (int i = 0; i < N_THREADS; i++) {
+		zassert_equal(helper_ret[i], 0, "");
+	}
+	zassert_equal(counter, N_THREADS, "");
+}
+
+void test_main(void)
+{
+#ifdef CONFIG_USERSPACE
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_access_grant(k_current_get(), &threads[i],
+				      &stacks[i]);
+	}
+#endif
+
+	ztest_test_suite(fmutex,
+			 ztest_user_unit_test(test_fmutex_recursive),
+			 ztest_user_unit_test(test_fmutex_owner),
+			 ztest_user_unit_test(test_fmutex_contended),
+			 ztest_user_unit_test(test_fcondvar_timeout),
+			 ztest_user_unit_test(test_fcondvar_signal),
+			 ztest_user_unit_test(test_fcondvar_broadcast));
+	ztest_run_test_suite(fmutex);
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Tests for writing and reading pipe data in place
+ * @ingroup kernel_pipe_tests
+ * @{
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define PIPE_SIZE 8
+#define TIMEOUT_MS 100
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static unsigned char __aligned(4) claim_buf[PIPE_SIZE];
+static struct k_pipe claim_pipe;
+
+static K_THREAD_STACK_DEFINE(claim_stack, STACK_SIZE);
+static struct k_thread claim_thread;
+
+static const unsigned char pattern[] = "0123456789abcdef";
+
+static void put_entry(void *p1, void *p2, void *p3)
+{
+	size_t written;
+
+	k_msleep(TIMEOUT_MS / 2);
+	zassert_equal(k_pipe_put(&claim_pipe, (void *)pattern, 4, &written,
+				 4, K_NO_WAIT), 0, "");
+}
+
+static void get_entry(void *p1, void *p2, void *p3)
+{
+	unsigned char data[4];
+	size_t read;
+
+	k_msleep(TIMEOUT_MS / 2);
+	zassert_equal(k_pipe_get(&claim_pipe, data, sizeof(data), &read,
+				 sizeof(data), K_NO_WAIT), 0, "");
+}
+
+/* Reads PIPE_SIZE bytes, which must match the start of pattern */
+static void reader_entry(void *p1, void *p2, void *p3)
+{
+	unsigned char data[PIPE_SIZE];
+	size_t read;
+
+	zassert_equal(k_pipe_get(&claim_pipe, data, sizeof(data), &read,
+				 sizeof(data), K_FOREVER), 0, "");
+	zassert_mem_equal(data, pattern, sizeof(data), "");
+}
+
+static void spawn(k_thread_entry_t entry)
+{
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE, entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+}
+
+/**
+ * @brief Test writing and reading pipe data in place
+ *
+ * @see k_pipe_put_claim(), k_pipe_put_finish(), k_pipe_get_claim(),
+ * k_pipe_get_finish()
+ */
+void test_pipe_claim(void)
+{
+	unsigned char data[PIPE_SIZE];
+	size_t read;
+	void *mem;
+
+	k_pipe_init(&claim_pipe, claim_buf, sizeof(claim_buf));
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, 6, K_NO_WAIT), 6,
+		      "");
+	zassert_equal(mem, claim_buf, "");
+	memcpy(mem, pattern, 6);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 7), -EINVAL,
+		      "wrote more than claimed");
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 6), 0, "");
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 6, "");
+
+	/* partially consumed data stays at the head of the pipe */
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, PIPE_SIZE,
+				       K_NO_WAIT), 6, "");
+	zassert_mem_equal(mem, pattern, 6, "");
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), 0, "");
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 2, "");
+
+	/* claims stop at the end of the buffer */
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, PIPE_SIZE,
+				       K_NO_WAIT), 2, "");
+	memcpy(mem, pattern + 6, 2);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 2), 0, "");
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, PIPE_SIZE,
+				       K_NO_WAIT), 4, "");
+	zassert_equal(mem, claim_buf, "");
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 0), 0, "abort failed");
+
+	zassert_equal(k_pipe_get(&claim_pipe, data, sizeof(data), &read, 1,
+				 K_NO_WAIT), 0, "");
+	zassert_equal(read, 4, "aborted claim was written");
+	zassert_mem_equal(data, pattern + 4, 4, "");
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, 1, K_NO_WAIT), -EIO,
+		      "claimed data of an empty pipe");
+}
+
+/**
+ * @brief Test that copying calls fail while a claim is held
+ */
+void test_pipe_claim_busy(void)
+{
+	unsigned char data[4];
+	size_t bytes;
+	void *mem;
+
+	k_pipe_init(&claim_pipe, claim_buf, sizeof(claim_buf));
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, 4, K_NO_WAIT), 4,
+		      "");
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, 4, K_NO_WAIT),
+		      -EBUSY, "second put claim");
+	zassert_equal(k_pipe_put(&claim_pipe, (void *)pattern, 4, &bytes, 0,
+				 K_NO_WAIT), -EBUSY, "put during a put claim");
+	memcpy(mem, pattern, 4);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 4), 0, "");
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, 4, K_NO_WAIT), 4,
+		      "");
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, 4, K_NO_WAIT),
+		      -EBUSY, "second get claim");
+	zassert_equal(k_pipe_get(&claim_pipe, data, 4, &bytes, 0, K_NO_WAIT),
+		      -EBUSY, "get during a get claim");
+
+	/* puts still work while data is claimed */
+	zassert_equal(k_pipe_put(&claim_pipe, (void *)pattern, 4, &bytes, 4,
+				 K_NO_WAIT), 0, "");
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), 0, "");
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 4, "");
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, 0, K_NO_WAIT),
+		      -EINVAL, "");
+	k_pipe_init(&claim_pipe, NULL, 0);
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, 1, K_NO_WAIT),
+		      -EINVAL, "claimed data of a bufferless pipe");
+}
+
+/**
+ * @brief Test that blocked claimers are woken by copying calls
+ */
+void test_pipe_claim_wait(void)
+{
+	size_t written;
+	void *mem;
+
+	k_pipe_init(&claim_pipe, claim_buf, sizeof(claim_buf));
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, PIPE_SIZE,
+				       K_MSEC(TIMEOUT_MS)), -EAGAIN, "");
+
+	spawn(put_entry);
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &mem, PIPE_SIZE,
+				       K_FOREVER), 4, "");
+	zassert_mem_equal(mem, pattern, 4, "");
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), 0, "");
+	k_thread_join(&claim_thread, K_FOREVER);
+
+	zassert_equal(k_pipe_put(&claim_pipe, (void *)pattern, PIPE_SIZE,
+				 &written, PIPE_SIZE, K_NO_WAIT), 0, "");
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &mem, PIPE_SIZE,
+				       K_MSEC(TIMEOUT_MS)), -EAGAIN, "");
+
+	spawn(get_entry);
+	zassert_true(k_pipe_put_claim(&claim_pipe, &mem, PIPE_SIZE,
+				      K_FOREVER) > 0, "");
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 0), 0, "");
+	k_thread_join(&claim_thread, K_FOREVER);
+}
+
+/**
+ * @brief Test that finishing a claim serves waiting readers
+ */
+void test_pipe_claim_feeds_reader(void)
+{
+	void *mem;
+	int n;
+
+	k_pipe_init(&claim_pipe, claim_buf, sizeof(claim_buf));
+
+	/* the reader waits on the empty pipe and needs two claims */
+	spawn(reader_entry);
+	k_msleep(TIMEOUT_MS / 2);
+
+	n = k_pipe_put_claim(&claim_pipe, &mem, PIPE_SIZE / 2, K_NO_WAIT);
+	zassert_equal(n, PIPE_SIZE / 2, "");
+	memcpy(mem, pattern, n);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, n), 0, "");
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0,
+		      "data not handed to the reader");
+
+	n = k_pipe_put_claim(&claim_pipe, &mem, PIPE_SIZE / 2, K_NO_WAIT);
+	zassert_equal(n, PIPE_SIZE / 2, "");
+	memcpy(mem, pattern + PIPE_SIZE / 2, n);
+	zassert_equal(k_pipe_put_finish(&claim_pipe, n), 0, "");
+
+	zassert_equal(k_thread_join(&claim_thread, K_MSEC(TIMEOUT_MS)), 0,
+		      "reader not woken");
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, "");
+}
+
+/**
+ * @}
+ */
@@ -16,6 +16,11 @@ extern void test_poll_grant_access(void);
 extern void test_poll_fail_grant_access(void);
 extern void test_poll_lower_prio(void);
 extern void test_condition_met_type_err(void);
+extern void test_poll_set_ready(void);
+extern void test_poll_set_round_robin(void);
+extern void test_poll_set_wait(void);
+extern void test_poll_set_user(void);
+extern void test_poll_set_grant_access(void);
 #ifdef CONFIG_USERSPACE
 extern void test_k_poll_user_num_err(void);
 extern void test_k_poll_user_mem_err(void);
@@ -61,6 +66,7 @@ void test_main(void)
 {
 	test_poll_grant_access();
 	test_poll_fail_grant_access();
+	test_poll_set_grant_access();
 
 	k_thread_heap_assign(k_current_get(), &test_heap);
 
@@ -74,6 +80,10 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_poll_lower_prio),
 			 ztest_1cpu_unit_test(test_poll_threadstate),
 			 ztest_1cpu_unit_test(test_condition_met_type_err),
+			 ztest_1cpu_unit_test(test_poll_set_ready),
+			 ztest_1cpu_unit_test(test_poll_set_round_robin),
+			 ztest_1cpu_unit_test(test_poll_set_wait),
+			 ztest_user_unit_test(test_poll_set_user),
 			 ztest_user_unit_test(test_k_poll_user_num_err),
 			 ztest_user_unit_test(test_k_poll_user_mem_err),
 			 ztest_user_unit_test(test_k_poll_user_type_sem_err),
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define SET_SIZE 4
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_POLL_SET_DEFINE(set_test_set, SET_SIZE);
+K_POLL_SET_DEFINE(set_user_set, 1);
+K_SEM_DEFINE(set_sem, 0, 1);
+K_SEM_DEFINE(set_user_sem, 0, 1);
+K_FIFO_DEFINE(set_fifo);
+static struct k_poll_signal set_signal;
+
+static struct k_thread set_thread;
+K_THREAD_STACK_DEFINE(set_stack, STACK_SIZE);
+
+static struct k_poll_set_result results[SET_SIZE];
+
+/* Index of entry id in results[0..n), or -1 */
+static int find_result(int n, int id)
+{
+	for (int i = 0; i < n; i++) {
+		if (results[i].id == id) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Test that a poll set reports exactly the ready entries
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_add(), k_poll_set_wait(), k_poll_set_remove()
+ */
+void test_poll_set_ready(void)
+{
+	struct { void *private; uint32_t msg; } msg = { NULL, 0x1337 };
+	int sem_id, fifo_id, signal_id, n, i;
+
+	k_poll_signal_init(&set_signal);
+
+	sem_id = k_poll_set_add(&set_test_set, K_POLL_TYPE_SEM_AVAILABLE,
+				&set_sem);
+	fifo_id = k_poll_set_add(&set_test_set,
+				 K_POLL_TYPE_FIFO_DATA_AVAILABLE, &set_fifo);
+	signal_id = k_poll_set_add(&set_test_set, K_POLL_TYPE_SIGNAL,
+				   &set_signal);
+	zassert_true(sem_id >= 0 && fifo_id >= 0 && signal_id >= 0,
+		     "add failed");
+
+	zassert_equal(k_poll_set_wait(&set_test_set, results, SET_SIZE,
+				      K_NO_WAIT), -EAGAIN, "nothing is ready");
+
+	k_sem_give(&set_sem);
+	n = k_poll_set_wait(&set_test_set, results, SET_SIZE, K_NO_WAIT);
+	zassert_equal(n, 1, "");
+	zassert_equal(results[0].id, sem_id, "");
+	zassert_equal(results[0].state, K_POLL_STATE_SEM_AVAILABLE, "");
+
+	/* Level triggered: reported until consumed */
+	n = k_poll_set_wait(&set_test_set, results, SET_SIZE, K_NO_WAIT);
+	zassert_equal(n, 1, "ready entry not reported again");
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, "");
+	zassert_equal(k_poll_set_wait(&set_test_set, results, SET_SIZE,
+				      K_NO_WAIT), -EAGAIN, "consumed entry");
+
+	k_fifo_put(&set_fifo, &msg);
+	k_poll_signal_raise(&set_signal, 0);
+	n = k_poll_set_wait(&set_test_set, results, SET_SIZE, K_NO_WAIT);
+	zassert_equal(n, 2, "");
+	i = find_result(n, fifo_id);
+	zassert_true(i >= 0, "fifo not reported");
+	zassert_equal(results[i].state, K_POLL_STATE_FIFO_DATA_AVAILABLE, "");
+	i = find_result(n, signal_id);
+	zassert_true(i >= 0, "signal not reported");
+	zassert_equal(results[i].state, K_POLL_STATE_SIGNALED, "");
+
+	zassert_equal(k_fifo_get(&set_fifo, K_NO_WAIT), &msg, "");
+	k_poll_signal_reset(&set_signal);
+	zassert_equal(k_poll_set_wait(&set_test_set, results, SET_SIZE,
+				      K_NO_WAIT), -EAGAIN, "");
+
+	/* A removed entry is not reported, and its slot can be reused */
+	zassert_equal(k_poll_set_remove(&set_test_set, sem_id), 0, "");
+	zassert_equal(k_poll_set_remove(&set_test_set, sem_id), -EINVAL, "");
+	k_sem_give(&set_sem);
+	zassert_equal(k_poll_set_wait(&set_test_set, results, SET_SIZE,
+				      K_NO_WAIT), -EAGAIN, "removed entry");
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, "");
+
+	zassert_equal(k_poll_set_remove(&set_test_set, fifo_id), 0, "");
+	zassert_equal(k_poll_set_remove(&set_test_set, signal_id), 0, "");
+	zassert_equal(k_poll_set_remove(&set_test_set, SET_SIZE), -EINVAL, "");
+}
+
+/**
+ * @brief Test that more ready entries than results are served in turn
+ *
+ * @ingroup kernel_poll_tests
+ */
+void test_poll_set_round_robin(void)
+{
+	static struct k_sem sems[SET_SIZE];
+	bool seen[SET_SIZE] = { false };
+	int ids[SET_SIZE];
+
+	for (int i = 0; i < SET_SIZE; i++) {
+		k_sem_init(&sems[i], 1, 1);
+		ids[i] = k_poll_set_add(&set_test_set,
+					K_POLL_TYPE_SEM_AVAILABLE, &sems[i]);
+		zassert_equal(ids[i], i, "unexpected id");
+	}
+	zassert_equal(k_poll_set_add(&set_test_set, K_POLL_TYPE_SEM_AVAILABLE,
+				     &set_sem), -ENOMEM, "set overflow");
+
+	for (int i = 0; i < SET_SIZE; i++) {
+		zassert_equal(k_poll_set_wait(&set_test_set, results, 1,
+					      K_NO_WAIT), 1, "");
+		zassert_false(seen[results[0].id], "entry starved others");
+		seen[results[0].id] = true;
+	}
+
+	for (int i = 0; i < SET_SIZE; i++) {
+		zassert_equal(k_poll_set_remove(&set_test_set, ids[i]), 0, "");
+	}
+}
+
+static void set_give_entry(void *p1, void *p2, void *p3)
+{
+	k_msleep(50);
+	k_sem_give(&set_sem);
+}
+
+/**
+ * @brief Test that k_poll_set_wait() blocks until an entry is signaled
+ *
+ * @ingroup kernel_poll_tests
+ */
+void test_poll_set_wait(void)
+{
+	int id = k_poll_set_add(&set_test_set, K_POLL_TYPE_SEM_AVAILABLE,
+				&set_sem);
+
+	zassert_true(id >= 0, "add failed");
+	zassert_equal(k_poll_set_wait(&set_test_set, results, SET_SIZE,
+				      K_MSEC(20)), -EAGAIN, "");
+
+	k_thread_create(&set_thread, set_stack,
+			K_THREAD_STACK_SIZEOF(set_stack), set_give_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	zassert_equal(k_poll_set_wait(&set_test_set, results, SET_SIZE,
+				      K_FOREVER), 1, "");
+	zassert_equal(results[0].id, id, "");
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, "");
+	zassert_equal(k_poll_set_remove(&set_test_set, id), 0, "");
+
+	k_thread_join(&set_thread, K_FOREVER);
+}
+
+/**
+ * @brief Test poll sets through the system call interface
+ *
+ * @ingroup kernel_poll_tests
+ */
+void test_poll_set_user(void)
+{
+	struct k_poll_set_result result;
+	int id;
+
+	id = k_poll_set_add(&set_user_set, K_POLL_TYPE_SEM_AVAILABLE,
+			    &set_user_sem);
+	zassert_equal(id, 0, "add failed");
+	zassert_equal(k_poll_set_add(&set_user_set, K_POLL_TYPE_SEM_AVAILABLE,
+				     &set_user_sem), -ENOMEM, "");
+
+	k_sem_give(&set_user_sem);
+	zassert_equal(k_poll_set_wait(&set_user_set, &result, 1, K_NO_WAIT),
+		      1, "");
+	zassert_equal(result.id, id, "");
+	zassert_equal(k_poll_set_wait(&set_user_set, &result, 0, K_NO_WAIT),
+		      -EINVAL, "");
+
+	zassert_equal(k_sem_take(&set_user_sem, K_NO_WAIT), 0, "");
+	zassert_equal(k_poll_set_remove(&set_user_set, id), 0, "");
+}
+
+void test_poll_set_grant_access(void)
+{
+	k_thread_access_grant(k_current_get(), &set_user_set, &set_user_sem);
+}
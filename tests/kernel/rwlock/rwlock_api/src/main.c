@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define TIMEOUT_MS 100
+
+#define PRIO_HIGH K_PRIO_PREEMPT(2)
+#define PRIO_MAIN K_PRIO_PREEMPT(5)
+#define PRIO_LOW K_PRIO_PREEMPT(8)
+
+K_RWLOCK_DEFINE(krwlock, 0);
+
+static struct k_rwlock rwlock;
+
+K_THREAD_STACK_DEFINE(helper_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(helper2_stack, STACK_SIZE);
+static struct k_thread helper_thread;
+static struct k_thread helper2_thread;
+
+static ZTEST_BMEM int helper_ret;
+static ZTEST_BMEM volatile bool helper_locked;
+
+static void try_read_entry(void *p1, void *p2, void *p3)
+{
+	helper_ret = k_rwlock_read_lock(p1, K_NO_WAIT);
+	if (helper_ret == 0) {
+		zassert_equal(k_rwlock_unlock(p1), 0, "");
+	}
+}
+
+static void unlock_entry(void *p1, void *p2, void *p3)
+{
+	helper_ret = k_rwlock_unlock(p1);
+}
+
+static void read_entry(void *p1, void *p2, void *p3)
+{
+	helper_ret = k_rwlock_read_lock(p1, K_FOREVER);
+	helper_locked = true;
+	zassert_equal(k_rwlock_unlock(p1), 0, "");
+}
+
+static void write_entry(void *p1, void *p2, void *p3)
+{
+	helper_ret = k_rwlock_write_lock(p1, K_FOREVER);
+	helper_locked = true;
+	zassert_equal(k_rwlock_unlock(p1), 0, "");
+}
+
+static void write_timeout_entry(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_write_lock(p1, K_MSEC(TIMEOUT_MS)), -EAGAIN,
+		      "");
+}
+
+static k_tid_t spawn(struct k_thread *thread, k_thread_stack_t *stack,
+		     k_thread_entry_t entry, struct k_rwlock *lock, int prio)
+{
+	return k_thread_create(thread, stack, STACK_SIZE, entry, lock,
+			       NULL, NULL, prio,
+			       K_USER | K_INHERIT_PERMS, K_NO_WAIT);
+}
+
+/**
+ * @brief Reader-writer lock tests
+ * @defgroup kernel_rwlock_tests Reader-Writer Locks
+ * @ingroup all_tests
+ * @{
+ */
+
+/**
+ * @brief Test that readers share the lock and writers don't
+ *
+ * @see k_rwlock_read_lock(), k_rwlock_write_lock(), k_rwlock_unlock()
+ */
+void test_rwlock_readers(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+
+	zassert_equal(k_rwlock_read_lock(&krwlock, K_NO_WAIT), 0, "");
+	spawn(&helper_thread, helper_stack, try_read_entry, &krwlock, prio);
+	k_thread_join(&helper_thread, K_FOREVER);
+	zassert_equal(helper_ret, 0, "readers excluded each other");
+
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_NO_WAIT), -EBUSY,
+		      "writer admitted with a reader");
+	zassert_equal(k_rwlock_unlock(&krwlock), 0, "");
+	zassert_equal(k_rwlock_unlock(&krwlock), -EINVAL,
+		      "unlocked an unlocked rwlock");
+
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_NO_WAIT), 0, "");
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_NO_WAIT), -EBUSY,
+		      "writers nested");
+	zassert_equal(k_rwlock_read_lock(&krwlock, K_MSEC(TIMEOUT_MS)),
+		      -EAGAIN, "reader admitted with a writer");
+
+	spawn(&helper_thread, helper_stack, try_read_entry, &krwlock, prio);
+	k_thread_join(&helper_thread, K_FOREVER);
+	zassert_equal(helper_ret, -EBUSY, "reader admitted with a writer");
+
+	spawn(&helper_thread, helper_stack, unlock_entry, &krwlock, prio);
+	k_thread_join(&helper_thread, K_FOREVER);
+	zassert_equal(helper_ret, -EPERM, "unlocked another thread's lock");
+
+	zassert_equal(k_rwlock_unlock(&krwlock), 0, "");
+}
+
+/**
+ * @brief Test initializing with unknown flags
+ *
+ * @see k_rwlock_init()
+ */
+void test_rwlock_init_flags(void)
+{
+	zassert_equal(k_rwlock_init(&rwlock, BIT(7)), -EINVAL, "");
+	zassert_equal(k_rwlock_init(&rwlock, K_RWLOCK_PREFER_WRITER), 0, "");
+	zassert_equal(k_rwlock_init(&rwlock, 0), 0, "");
+}
+
+/**
+ * @brief Test that the last reader hands the lock to a waiting writer
+ */
+void test_rwlock_writer_waits(void)
+{
+	k_thread_priority_set(k_current_get(), PRIO_MAIN);
+	k_rwlock_init(&rwlock, 0);
+	helper_locked = false;
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, "");
+	spawn(&helper_thread, helper_stack, write_entry, &rwlock, PRIO_HIGH);
+	zassert_false(helper_locked, "writer admitted with a reader");
+
+	/* the writer preempts us as soon as we unlock */
+	zassert_equal(k_rwlock_unlock(&rwlock), 0, "");
+	zassert_true(helper_locked, "writer not woken");
+	zassert_equal(helper_ret, 0, "");
+	k_thread_join(&helper_thread, K_FOREVER);
+}
+
+/**
+ * @brief Test which new readers a waiting writer keeps out
+ *
+ * @details By default a waiting writer only keeps out readers of lower
+ * priority than its own, with K_RWLOCK_PREFER_WRITER it keeps out all.
+ */
+void test_rwlock_writer_preference(void)
+{
+	static const uint32_t flags[] = { 0, K_RWLOCK_PREFER_WRITER };
+
+	k_thread_priority_set(k_current_get(), PRIO_MAIN);
+
+	for (int i = 0; i < ARRAY_SIZE(flags); i++) {
+		k_rwlock_init(&rwlock, flags[i]);
+
+		zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, "");
+		spawn(&helper_thread, helper_stack, write_entry, &rwlock,
+		      K_PRIO_PREEMPT(6));
+		k_msleep(TIMEOUT_MS / 10);
+
+		spawn(&helper2_thread, helper2_stack, try_read_entry, &rwlock,
+		      PRIO_LOW);
+		k_thread_join(&helper2_thread, K_FOREVER);
+		zassert_equal(helper_ret, -EBUSY,
+			      "lower priority reader passed a writer");
+
+		spawn(&helper2_thread, helper2_stack, try_read_entry, &rwlock,
+		      PRIO_HIGH);
+		k_thread_join(&helper2_thread, K_FOREVER);
+		if (flags[i] == K_RWLOCK_PREFER_WRITER) {
+			zassert_equal(helper_ret, -EBUSY,
+				      "reader passed a preferred writer");
+		} else {
+			zassert_equal(helper_ret, 0,
+				      "higher priority reader kept out");
+		}
+
+		zassert_equal(k_rwlock_unlock(&rwlock), 0, "");
+		k_thread_join(&helper_thread, K_FOREVER);
+	}
+}
+
+/**
+ * @brief Test that the writer inherits the priority of waiting threads
+ */
+void test_rwlock_priority_inheritance(void)
+{
+	k_tid_t self = k_current_get();
+
+	k_thread_priority_set(self, PRIO_LOW);
+	k_rwlock_init(&rwlock, 0);
+	helper_locked = false;
+
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, "");
+
+	/* a waiting reader boosts the writer... */
+	spawn(&helper_thread, helper_stack, read_entry, &rwlock, PRIO_MAIN);
+	zassert_equal(k_thread_priority_get(self), PRIO_MAIN, "");
+
+	/* ...as does a waiting writer, until it gives up */
+	spawn(&helper2_thread, helper2_stack, write_timeout_entry, &rwlock,
+	      PRIO_HIGH);
+	zassert_equal(k_thread_priority_get(self), PRIO_HIGH, "");
+	k_thread_join(&helper2_thread, K_FOREVER);
+	zassert_equal(k_thread_priority_get(self), PRIO_MAIN, "");
+
+	zassert_equal(k_rwlock_unlock(&rwlock), 0, "");
+	zassert_equal(k_thread_priority_get(self), PRIO_LOW, "");
+	zassert_true(helper_locked, "reader not woken");
+	k_thread_join(&helper_thread, K_FOREVER);
+}
+
+/**
+ * @brief Test that readers kept out by a writer that gives up go ahead
+ */
+void test_rwlock_writer_timeout(void)
+{
+	k_thread_priority_set(k_current_get(), PRIO_MAIN);
+	k_rwlock_init(&rwlock, K_RWLOCK_PREFER_WRITER);
+	helper_locked = false;
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, "");
+	spawn(&helper2_thread, helper2_stack, write_timeout_entry, &rwlock,
+	      PRIO_HIGH);
+	spawn(&helper_thread, helper_stack, read_entry, &rwlock, PRIO_HIGH);
+	zassert_false(helper_locked, "reader passed a preferred writer");
+
+	k_thread_join(&helper2_thread, K_FOREVER);
+	zassert_equal(k_thread_join(&helper_thread, K_MSEC(TIMEOUT_MS)), 0,
+		      "reader not woken");
+	zassert_true(helper_locked, "");
+	zassert_equal(k_rwlock_unlock(&rwlock), 0, "");
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	k_thread_access_grant(k_current_get(), &krwlock, &rwlock,
+			      &helper_thread, &helper_stack,
+			      &helper2_thread, &helper2_stack);
+
+	ztest_test_suite(test_rwlock,
+			 ztest_user_unit_test(test_rwlock_readers),
+			 ztest_user_unit_test(test_rwlock_init_flags),
+			 ztest_unit_test(test_rwlock_writer_waits),
+			 ztest_unit_test(test_rwlock_writer_preference),
+			 ztest_unit_test(test_rwlock_priority_inheritance),
+			 ztest_unit_test(test_rwlock_writer_timeout));
+	ztest_run_test_suite(test_rwlock);
+}
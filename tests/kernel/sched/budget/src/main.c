@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define NUM_HOGS 2
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* Each hog may use a quarter of the CPU */
+#define BUDGET_US 5000
+#define PERIOD_US 20000
+
+#define MEASURE_MS 1000
+
+/* Enforcement is precise to within a tick per period */
+#define HOG_MAX_PERCENT 35
+#define BACKGROUND_MIN_PERCENT 25
+
+#define HOG_PRIO K_PRIO_PREEMPT(1)
+#define BACKGROUND_PRIO K_PRIO_PREEMPT(2)
+
+static struct k_thread hog_threads[NUM_HOGS];
+static struct k_thread background_thread;
+
+K_THREAD_STACK_ARRAY_DEFINE(hog_stacks, NUM_HOGS, STACK_SIZE);
+K_THREAD_STACK_DEFINE(background_stack, STACK_SIZE);
+
+static void spin(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_busy_wait(100);
+	}
+}
+
+static void start_threads(void)
+{
+	for (int i = 0; i < NUM_HOGS; i++) {
+		k_thread_create(&hog_threads[i], hog_stacks[i], STACK_SIZE,
+				spin, NULL, NULL, NULL, HOG_PRIO, 0,
+				K_FOREVER);
+		zassert_equal(k_thread_budget_set(&hog_threads[i], BUDGET_US,
+						  PERIOD_US), 0, "");
+	}
+	k_thread_create(&background_thread, background_stack, STACK_SIZE,
+			spin, NULL, NULL, NULL, BACKGROUND_PRIO, 0, K_FOREVER);
+
+	for (int i = 0; i < NUM_HOGS; i++) {
+		k_thread_start(&hog_threads[i]);
+	}
+	k_thread_start(&background_thread);
+}
+
+static void stop_threads(void)
+{
+	for (int i = 0; i < NUM_HOGS; i++) {
+		k_thread_abort(&hog_threads[i]);
+	}
+	k_thread_abort(&background_thread);
+}
+
+static uint64_t cpu_cycles(struct k_thread *thread)
+{
+	k_thread_runtime_stats_t stats;
+
+	zassert_equal(k_thread_runtime_stats_get(thread, &stats), 0, "");
+
+	return stats.execution_cycles;
+}
+
+/* Percentage of the elapsed cycles the thread ran for */
+static uint32_t cpu_percent(struct k_thread *thread, uint32_t elapsed)
+{
+	return (uint32_t)(cpu_cycles(thread) * 100U / elapsed);
+}
+
+/**
+ * @brief Test budget parameter validation
+ *
+ * @ingroup kernel_sched_tests
+ *
+ * @see k_thread_budget_set()
+ */
+void test_budget_invalid(void)
+{
+	zassert_equal(k_thread_budget_set(k_current_get(), PERIOD_US + 1,
+					  PERIOD_US), -EINVAL,
+		      "budget exceeding its period accepted");
+	zassert_equal(k_thread_budget_set(k_current_get(), BUDGET_US, 0),
+		      -EINVAL, "zero period accepted");
+	zassert_equal(k_thread_budget_set(k_current_get(), BUDGET_US,
+					  UINT32_MAX), -EINVAL,
+		      "period beyond the deadline range accepted");
+	zassert_equal(k_thread_budget_set(k_current_get(), 0, 0), 0, "");
+}
+
+/**
+ * @brief Test that budgets bound the interference of CPU hogs
+ *
+ * @details Two threads spinning forever at a higher priority than a
+ * background thread would starve it.  With a quarter of the CPU
+ * reserved for each, they run for no more than their budget, and the
+ * background thread gets the rest.
+ *
+ * @ingroup kernel_sched_tests
+ *
+ * @see k_thread_budget_set()
+ */
+void test_budget_overload(void)
+{
+	uint32_t start, elapsed, percent;
+
+	start = k_cycle_get_32();
+	start_threads();
+	k_msleep(MEASURE_MS);
+	elapsed = k_cycle_get_32() - start;
+
+	for (int i = 0; i < NUM_HOGS; i++) {
+		percent = cpu_percent(&hog_threads[i], elapsed);
+		zassert_true(percent <= HOG_MAX_PERCENT,
+			     "hog %d ran %u%% of the time", i, percent);
+	}
+
+	percent = cpu_percent(&background_thread, elapsed);
+	zassert_true(percent >= BACKGROUND_MIN_PERCENT,
+		     "background thread ran %u%% of the time", percent);
+
+	stop_threads();
+}
+
+/**
+ * @brief Test that removing the budgets lets the hogs take the CPU
+ *
+ * @ingroup kernel_sched_tests
+ *
+ * @see k_thread_budget_set()
+ */
+void test_budget_removed(void)
+{
+	uint32_t start, elapsed, percent;
+	uint64_t cycles;
+
+	start_threads();
+	k_msleep(MEASURE_MS / 10);
+
+	/* The hogs may be throttled at this point */
+	for (int i = 0; i < NUM_HOGS; i++) {
+		zassert_equal(k_thread_budget_set(&hog_threads[i], 0, 0), 0,
+			      "");
+	}
+
+	start = k_cycle_get_32();
+	cycles = cpu_cycles(&background_thread);
+	k_msleep(MEASURE_MS);
+	elapsed = k_cycle_get_32() - start;
+	cycles = cpu_cycles(&background_thread) - cycles;
+
+	percent = (uint32_t)(cycles * 100U / elapsed);
+	zassert_true(percent < 5U, "background thread ran %u%% of the time",
+		     percent);
+
+	stop_threads();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(budget,
+			 ztest_unit_test(test_budget_invalid),
+			 ztest_unit_test(test_budget_overload),
+			 ztest_unit_test(test_budget_removed));
+	ztest_run_test_suite(budget);
+}
@@ -629,6 +629,41 @@ void test_smp_ipi(void)
 	}
 }
 
+/**
+ * @brief Test directed interprocessor interrupt
+ *
+ * @ingroup kernel_smp_integration_tests
+ *
+ * @details Like test_smp_ipi(), but uses arch_sched_directed_ipi() to
+ * interrupt only the CPUs other than the current one, and checks that
+ * z_sched_ipi() ran on each of them.
+ *
+ * @see arch_sched_directed_ipi()
+ */
+void test_smp_directed_ipi(void)
+{
+#if !defined(CONFIG_TRACE_SCHED_IPI) || !defined(CONFIG_ARCH_HAS_DIRECTED_IPIS)
+	ztest_test_skip();
+#else
+	for (int i = 0; i < 3 ; i++) {
+		unsigned int key = arch_irq_lock();
+		uint32_t others = BIT_MASK(CONFIG_MP_NUM_CPUS) &
+				  ~BIT(arch_curr_cpu()->id);
+
+		sched_ipi_has_called = 0;
+		arch_sched_directed_ipi(others);
+		arch_irq_unlock(key);
+
+		k_msleep(100);
+
+		/**TESTPOINT: every other CPU entered the IPI handler */
+		zassert_true(sched_ipi_has_called >= CONFIG_MP_NUM_CPUS - 1,
+			     "did not receive directed IPI.(%d)",
+			     sched_ipi_has_called);
+	}
+#endif
+}
+
 void k_sys_fatal_error_handler(unsigned int reason, const z_arch_esf_t *pEsf)
 {
 	static int times;
@@ -734,6 +769,7 @@ void test_main(void)
 			 ztest_unit_test(test_sleep_threads),
 			 ztest_unit_test(test_wakeup_threads),
 			 ztest_unit_test(test_smp_ipi),
+			 ztest_unit_test(test_smp_directed_ipi),
 			 ztest_unit_test(test_get_cpu),
 			 ztest_unit_test(test_fatal_on_smp),
 			 ztest_unit_test(test_workq_on_smp)
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define NUM_TIMERS 4
+#define NUM_WORKS 2
+#define RUN_MS 1000
+#define SLACK_MS 5
+
+/* Periods chosen so that strict expiries rarely coincide */
+static const int timer_period_ms[NUM_TIMERS] = { 7, 10, 13, 17 };
+static const int work_delay_ms[NUM_WORKS] = { 11, 19 };
+
+static struct k_timer timers[NUM_TIMERS];
+static struct k_work_delayable works[NUM_WORKS];
+static volatile bool running;
+
+/* Expiry must never come early, so track the deadline of each timer */
+static int64_t timer_deadline[NUM_TIMERS];
+static volatile int early_expiries;
+
+static void timer_expiry(struct k_timer *timer)
+{
+	int i = timer - timers;
+	int64_t now = k_uptime_ticks();
+
+	if (now < timer_deadline[i]) {
+		early_expiries++;
+	}
+	timer_deadline[i] = now + k_ms_to_ticks_ceil64(timer_period_ms[i]);
+}
+
+static void work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	int i = dwork - works;
+
+	if (running) {
+		k_work_reschedule(dwork, K_MSEC(work_delay_ms[i]));
+	}
+}
+
+/* Runs the mixed workload for RUN_MS and returns the number of
+ * distinct timer wakeups it took
+ */
+static uint32_t run_workload(k_timeout_t slack)
+{
+	struct k_timer_slack_stats before, after;
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		k_timer_init(&timers[i], timer_expiry, NULL);
+		k_timer_slack_set(&timers[i], slack);
+	}
+
+	for (int i = 0; i < NUM_WORKS; i++) {
+		k_work_init_delayable(&works[i], work_handler);
+		k_work_delayable_slack_set(&works[i], slack);
+	}
+
+	running = true;
+	early_expiries = 0;
+	k_timer_slack_stats_get(&before);
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		timer_deadline[i] = k_uptime_ticks() +
+			k_ms_to_ticks_ceil64(timer_period_ms[i]);
+		k_timer_start(&timers[i], K_MSEC(timer_period_ms[i]),
+			      K_MSEC(timer_period_ms[i]));
+	}
+
+	for (int i = 0; i < NUM_WORKS; i++) {
+		k_work_schedule(&works[i], K_MSEC(work_delay_ms[i]));
+	}
+
+	k_msleep(RUN_MS);
+
+	k_timer_slack_stats_get(&after);
+	running = false;
+
+	for (int i = 0; i < NUM_TIMERS; i++) {
+		k_timer_stop(&timers[i]);
+	}
+
+	for (int i = 0; i < NUM_WORKS; i++) {
+		struct k_work_sync sync;
+
+		k_work_cancel_delayable_sync(&works[i], &sync);
+	}
+
+	TC_PRINT("slack %u ticks: %u expired, %u wakeups, %u coalesced, %u aligned\n",
+		 (uint32_t)slack.ticks, after.expired - before.expired,
+		 after.wakeups - before.wakeups,
+		 after.coalesced - before.coalesced,
+		 after.aligned - before.aligned);
+
+	zassert_equal(early_expiries, 0, "%d timers expired early",
+		      early_expiries);
+
+	return after.wakeups - before.wakeups;
+}
+
+/**
+ * @brief Test that timer slack reduces the number of wakeups
+ *
+ * @details Runs the same mix of periodic timers and self-rescheduling
+ * delayable work items with and without slack, and checks that with
+ * slack fewer distinct wakeups were needed while no timer fired early.
+ */
+void test_slack_reduces_wakeups(void)
+{
+	uint32_t strict = run_workload(K_NO_WAIT);
+	uint32_t slack = run_workload(K_MSEC(SLACK_MS));
+
+	zassert_true(slack < strict,
+		     "slack did not reduce wakeups (%u vs %u)", slack, strict);
+}
+
+/**
+ * @brief Test that a slack timer expires within its window
+ */
+void test_slack_window(void)
+{
+	struct k_timer timer;
+	k_ticks_t slack = k_ms_to_ticks_ceil32(SLACK_MS);
+
+	k_timer_init(&timer, NULL, NULL);
+	k_timer_slack_set(&timer, K_TICKS(slack));
+
+	for (int i = 0; i < 10; i++) {
+		int64_t start, end;
+
+		/* Align to a tick boundary to make the bounds exact */
+		k_sleep(K_TICKS(1));
+		start = k_uptime_ticks();
+		k_timer_start(&timer, K_TICKS(10 + i), K_NO_WAIT);
+		k_timer_status_sync(&timer);
+		end = k_uptime_ticks();
+
+		zassert_true(end - start >= 10 + i, "expired early");
+		zassert_true(end - start <= 10 + i + slack + 1,
+			     "expired %d ticks late", (int)(end - start));
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(timer_slack,
+			 ztest_unit_test(test_slack_window),
+			 ztest_unit_test(test_slack_reduces_wakeups));
+	ztest_run_test_suite(timer_slack);
+}
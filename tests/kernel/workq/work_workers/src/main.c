@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WORKQ_PRIORITY K_PRIO_PREEMPT(1)
+
+/* The queue thread plus this many additional workers */
+#define NUM_WORKERS 3
+#define NUM_THREADS (NUM_WORKERS + 1)
+
+#define SLEEP_MS 50
+#define NUM_RESUBMITS 200
+
+static K_THREAD_STACK_DEFINE(queue_stack, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, NUM_WORKERS, STACK_SIZE);
+static struct k_work_q queue;
+static struct k_work_q_worker workers[NUM_WORKERS];
+
+static struct k_work works[NUM_THREADS * 2];
+static struct k_work_sync work_sync;
+
+static atomic_t concurrent;
+static atomic_t max_concurrent;
+static atomic_t runs;
+static atomic_t item_runs[NUM_THREADS * 2];
+
+/* Given by blocking_handler() when it starts, taken when it may return */
+static struct k_sem started_sem;
+static struct k_sem rel_sem;
+
+static void track_enter(void)
+{
+	atomic_val_t now = atomic_inc(&concurrent) + 1;
+	atomic_val_t max;
+
+	do {
+		max = atomic_get(&max_concurrent);
+	} while (now > max && !atomic_cas(&max_concurrent, max, now));
+}
+
+static void track_exit(void)
+{
+	(void)atomic_dec(&concurrent);
+	(void)atomic_inc(&runs);
+}
+
+static void reset_tracking(void)
+{
+	atomic_set(&concurrent, 0);
+	atomic_set(&max_concurrent, 0);
+	atomic_set(&runs, 0);
+}
+
+static void sleep_handler(struct k_work *work)
+{
+	track_enter();
+	k_msleep(SLEEP_MS);
+	(void)atomic_inc(&item_runs[work - works]);
+	track_exit();
+}
+
+static void blocking_handler(struct k_work *work)
+{
+	k_sem_give(&started_sem);
+	k_sem_take(&rel_sem, K_FOREVER);
+	(void)atomic_inc(&runs);
+}
+
+/* Resubmits itself while running, and yields so that other workers
+ * get a chance to pick it up if they (wrongly) could
+ */
+static void resubmit_handler(struct k_work *work)
+{
+	track_enter();
+	if (atomic_get(&runs) < NUM_RESUBMITS) {
+		(void)k_work_submit_to_queue(&queue, work);
+	}
+	k_yield();
+	k_busy_wait(100);
+	track_exit();
+}
+
+/**
+ * @brief Test that items of one queue are processed concurrently
+ */
+void test_parallel(void)
+{
+	reset_tracking();
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_work_init(&works[i], sleep_handler);
+		zassert_equal(k_work_submit_to_queue(&queue, &works[i]), 1,
+			      "submit failed");
+	}
+
+	zassert_equal(k_work_queue_drain(&queue, false), 1, "");
+	zassert_equal(atomic_get(&runs), NUM_THREADS, "");
+	zassert_equal(atomic_get(&max_concurrent), NUM_THREADS,
+		      "only %d items ran at once",
+		      (int)atomic_get(&max_concurrent));
+}
+
+/**
+ * @brief Test that an item never runs concurrently with itself
+ *
+ * @details The item keeps resubmitting itself from its handler, and
+ * is submitted from the test thread too, while idle workers look for
+ * items to steal.
+ */
+void test_no_self_concurrency(void)
+{
+	reset_tracking();
+	k_work_init(&works[0], resubmit_handler);
+
+	while (atomic_get(&runs) < NUM_RESUBMITS) {
+		(void)k_work_submit_to_queue(&queue, &works[0]);
+		k_yield();
+	}
+
+	(void)k_work_queue_drain(&queue, false);
+	zassert_equal(atomic_get(&max_concurrent), 1,
+		      "item ran concurrently with itself");
+}
+
+/**
+ * @brief Test that flush waits for the item even if other workers idle
+ */
+void test_flush(void)
+{
+	reset_tracking();
+
+	for (int i = 0; i < NUM_THREADS * 2; i++) {
+		atomic_set(&item_runs[i], 0);
+		k_work_init(&works[i], sleep_handler);
+		zassert_equal(k_work_submit_to_queue(&queue, &works[i]), 1,
+			      "submit failed");
+	}
+
+	zassert_true(k_work_flush(&works[0], &work_sync), "flush did not wait");
+
+	for (int i = 0; i < NUM_THREADS * 2; i++) {
+		(void)k_work_flush(&works[i], &work_sync);
+		zassert_equal(atomic_get(&item_runs[i]), 1,
+			      "flush returned before item %d ran", i);
+		zassert_equal(k_work_busy_get(&works[i]), 0,
+			      "busy after flush");
+	}
+
+	zassert_equal(atomic_get(&runs), NUM_THREADS * 2, "");
+	zassert_false(k_work_flush(&works[0], &work_sync), "idle flush");
+}
+
+/**
+ * @brief Test cancelling a queued item while all workers are busy
+ */
+void test_cancel(void)
+{
+	struct k_work *victim = &works[NUM_THREADS];
+
+	reset_tracking();
+	k_sem_init(&started_sem, 0, NUM_THREADS);
+	k_sem_init(&rel_sem, 0, NUM_THREADS + 1);
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_work_init(&works[i], blocking_handler);
+		zassert_equal(k_work_submit_to_queue(&queue, &works[i]), 1,
+			      "submit failed");
+	}
+	for (int i = 0; i < NUM_THREADS; i++) {
+		zassert_equal(k_sem_take(&started_sem, K_SECONDS(1)), 0,
+			      "worker %d did not start", i);
+	}
+
+	k_work_init(victim, blocking_handler);
+	zassert_equal(k_work_submit_to_queue(&queue, victim), 1, "");
+	zassert_equal(k_work_cancel(victim), 0, "queued item not canceled");
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_sem_give(&rel_sem);
+	}
+
+	zassert_equal(k_work_queue_drain(&queue, false), 1, "");
+	zassert_equal(atomic_get(&runs), NUM_THREADS, "canceled item ran");
+	zassert_false(k_work_cancel_sync(victim, &work_sync), "");
+}
+
+/**
+ * @brief Test that invalid CPUs are rejected
+ */
+void test_add_worker_invalid(void)
+{
+	static struct k_work_q_worker extra;
+
+	zassert_equal(k_work_queue_add_worker(&queue, &extra,
+					      worker_stacks[0], STACK_SIZE,
+					      WORKQ_PRIORITY,
+					      CONFIG_MP_NUM_CPUS),
+		      -EINVAL, "CPU out of range accepted");
+}
+
+/**
+ * @brief Add the workers, pinned round robin if CPU masks are available
+ */
+void test_add_workers(void)
+{
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		int cpu = IS_ENABLED(CONFIG_SCHED_CPU_MASK) ?
+			(i + 1) % CONFIG_MP_NUM_CPUS : -1;
+
+		zassert_equal(k_work_queue_add_worker(&queue, &workers[i],
+				worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				WORKQ_PRIORITY, cpu), 0, "add failed");
+	}
+}
+
+void test_main(void)
+{
+	k_work_queue_start(&queue, queue_stack,
+			   K_THREAD_STACK_SIZEOF(queue_stack),
+			   WORKQ_PRIORITY, NULL);
+
+	ztest_test_suite(work_workers,
+			 ztest_unit_test(test_add_workers),
+			 ztest_unit_test(test_parallel),
+			 ztest_unit_test(test_no_self_concurrency),
+			 ztest_unit_test(test_flush),
+			 ztest_unit_test(test_cancel),
+			 ztest_unit_test(test_add_worker_invalid));
+	ztest_run_test_suite(work_workers);
+}
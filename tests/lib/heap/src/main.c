@@ -323,10 +323,68 @@ static void test_realloc(void)
 		     "Realloc should have moved %p", p2);
 }
 
+static void test_runtime_stats(void)
+{
+	struct sys_heap heap;
+	struct sys_heap_runtime_stats stats;
+	size_t total;
+	uint32_t nfree;
+	void *p[4];
+
+	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes, 0, "");
+	zassert_equal(stats.max_allocated_bytes, 0, "");
+	zassert_true(stats.largest_free_bytes > 0 &&
+		     stats.largest_free_bytes <= stats.free_bytes, "");
+	total = stats.free_bytes;
+
+	for (int i = 0; i < ARRAY_SIZE(p); i++) {
+		p[i] = sys_heap_alloc(&heap, 100);
+		zassert_not_null(p[i], "");
+	}
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_true(stats.allocated_bytes >= 4 * 100, "");
+	zassert_equal(stats.allocated_bytes + stats.free_bytes, total, "");
+	zassert_equal(stats.max_allocated_bytes, stats.allocated_bytes, "");
+
+	/* Free every other block: two holes that cannot merge, plus
+	 * the untouched tail of the heap
+	 */
+	sys_heap_free(&heap, p[0]);
+	sys_heap_free(&heap, p[2]);
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes + stats.free_bytes, total, "");
+	zassert_true(stats.max_allocated_bytes > stats.allocated_bytes, "");
+	zassert_true(stats.largest_free_bytes < stats.free_bytes, "");
+
+	nfree = 0;
+	for (int i = 0; i < stats.num_buckets; i++) {
+		nfree += stats.bucket_free_chunks[i];
+	}
+	zassert_equal(nfree, 3, "expected 3 free chunks, got %u", nfree);
+
+	sys_heap_runtime_stats_reset_max(&heap);
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.max_allocated_bytes, stats.allocated_bytes, "");
+
+	sys_heap_free(&heap, p[1]);
+	sys_heap_free(&heap, p[3]);
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes, 0, "");
+	zassert_equal(stats.free_bytes, total, "");
+	zassert_true(sys_heap_validate(&heap), "invalid heap");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_heap_test,
 			 ztest_unit_test(test_realloc),
+			 ztest_unit_test(test_runtime_stats),
 			 ztest_unit_test(test_small_heap),
 			 ztest_unit_test(test_fragmentation),
 			 ztest_unit_test(test_big_heap)
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <sys/multi_heap.h>
+
+#define REGION_SZ 1024
+
+/* Stand-ins for three kinds of memory: plain cached RAM, a DMA
+ * capable region and fast TCM
+ */
+static char __aligned(8) ram[REGION_SZ];
+static char __aligned(8) dma[REGION_SZ];
+static char __aligned(8) tcm[REGION_SZ];
+
+static struct sys_multi_heap mheap;
+static int ram_idx, dma_idx, tcm_idx;
+
+static bool in_region(void *p, char *region)
+{
+	return (char *)p >= region && (char *)p < region + REGION_SZ;
+}
+
+static void setup(void)
+{
+	sys_multi_heap_init(&mheap);
+	ram_idx = sys_multi_heap_add_region(&mheap, ram, sizeof(ram),
+					    SYS_MHEAP_ATTR_CACHEABLE);
+	dma_idx = sys_multi_heap_add_region(&mheap, dma, sizeof(dma),
+					    SYS_MHEAP_ATTR_DMA);
+	tcm_idx = sys_multi_heap_add_region(&mheap, tcm, sizeof(tcm),
+					    SYS_MHEAP_ATTR_FAST);
+	zassert_true(ram_idx >= 0 && dma_idx >= 0 && tcm_idx >= 0, "");
+}
+
+/**
+ * @brief Test that allocations land in the region matching their
+ * attributes
+ */
+static void test_routing(void)
+{
+	void *p;
+
+	setup();
+
+	p = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_DEFAULT, 64);
+	zassert_true(in_region(p, ram), "default not from first region");
+	sys_multi_heap_free(&mheap, p);
+
+	p = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_FAST, 64);
+	zassert_true(in_region(p, tcm), "fast not from TCM");
+	sys_multi_heap_free(&mheap, p);
+
+	p = sys_multi_heap_aligned_alloc(&mheap, SYS_MHEAP_ATTR_DMA, 32, 64);
+	zassert_true(in_region(p, dma), "dma not from DMA region");
+	zassert_equal((uintptr_t)p & 31, 0, "misaligned");
+	sys_multi_heap_free(&mheap, p);
+}
+
+/**
+ * @brief Test the fallback order and that DMA is never violated
+ */
+static void test_fallback(void)
+{
+	struct sys_multi_heap_region_stats stats;
+	void *big, *p, *q;
+
+	setup();
+
+	/* With RAM exhausted, default allocations fall back to the
+	 * DMA region before touching fast memory
+	 */
+	big = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_DEFAULT,
+				   REGION_SZ / 2 + 256);
+	zassert_true(in_region(big, ram), "");
+	p = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_DEFAULT,
+				 REGION_SZ / 2);
+	zassert_true(in_region(p, dma), "default did not fall back to DMA");
+	sys_multi_heap_free(&mheap, p);
+
+	/* Fast memory is a preference: with TCM full it falls back
+	 * to ordinary memory
+	 */
+	p = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_FAST, REGION_SZ / 2);
+	zassert_true(in_region(p, tcm), "");
+	q = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_FAST, REGION_SZ / 2);
+	zassert_true(in_region(q, dma), "fast did not fall back");
+	sys_multi_heap_free(&mheap, q);
+	sys_multi_heap_free(&mheap, p);
+
+	/* DMA is a requirement: never served from other regions */
+	p = sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_DMA,
+				 REGION_SZ / 2 + 256);
+	zassert_true(in_region(p, dma), "");
+	zassert_is_null(sys_multi_heap_alloc(&mheap, SYS_MHEAP_ATTR_DMA,
+					     REGION_SZ / 2),
+			"DMA allocation served from non-DMA memory");
+	sys_multi_heap_free(&mheap, p);
+
+	zassert_equal(sys_multi_heap_region_stats_get(&mheap, dma_idx, &stats),
+		      0, "");
+	zassert_equal(stats.attr, SYS_MHEAP_ATTR_DMA, "");
+	zassert_equal(stats.allocs, 3, "");
+	zassert_equal(stats.fallback_allocs, 1, "");
+	zassert_equal(stats.heap.allocated_bytes, 0, "");
+
+	zassert_equal(sys_multi_heap_region_stats_get(&mheap, 3, &stats),
+		      -EINVAL, "");
+
+	sys_multi_heap_free(&mheap, big);
+	for (int i = 0; i < mheap.num_regions; i++) {
+		zassert_true(sys_heap_validate(&mheap.regions[i].heap), "");
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lib_multi_heap_test,
+			 ztest_unit_test(test_routing),
+			 ztest_unit_test(test_fallback));
+
+	ztest_run_test_suite(lib_multi_heap_test);
+}
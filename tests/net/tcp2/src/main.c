@@ -119,6 +119,13 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_client_fast_retransmit(sa_family_t af, struct tcphdr *th,
+					  size_t len);
+static void handle_client_sack(sa_family_t af, struct tcphdr *th, size_t len);
+static void handle_client_delayed_ack(sa_family_t af, struct tcphdr *th,
+				      size_t len);
+static void handle_client_sack_renege(sa_family_t af, struct tcphdr *th,
+				      size_t len);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -207,6 +214,21 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* Small segments, so that a few hundred bytes fill the initial window */
+#define FR_MSS 100
+
+static uint8_t fr_mss_option[4] = {
+	0x02, 0x04, 0x00, FR_MSS /* Max segment */ };
+
+static uint8_t sack_syn_options[8] = {
+	0x02, 0x04, 0x00, FR_MSS, /* Max segment */
+	0x01, 0x01, /* NOP */
+	0x04, 0x02 /* SACK permitted */ };
+
+/* SACK option of the next ACK sent by the peer */
+static uint8_t sack_options[4 + 3 * 8];
+static uint8_t sack_options_len;
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -217,11 +239,24 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct net_pkt *pkt;
 	struct tcphdr *th;
+	const uint8_t *opts = NULL;
 	uint8_t opts_len = 0;
 	int ret = -EINVAL;
 
 	if ((test_case_no == 4U) && (flags & SYN)) {
+		opts = tcp_options;
 		opts_len = sizeof(tcp_options);
+	} else if ((test_case_no == 10U) && (flags & SYN)) {
+		opts = fr_mss_option;
+		opts_len = sizeof(fr_mss_option);
+	} else if (test_case_no == 11U || test_case_no == 13U) {
+		if (flags & SYN) {
+			opts = sack_syn_options;
+			opts_len = sizeof(sack_syn_options);
+		} else {
+			opts = sack_options;
+			opts_len = sack_options_len;
+		}
 	}
 
 	/* Allocate buffer */
@@ -256,14 +291,15 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
-		th->th_off = 10U;
+	th->th_off = 5U + opts_len / 4U;
+	th->th_flags = flags;
+
+	if (test_case_no >= 10U) {
+		th->th_win = htons(NET_IPV6_MTU);
 	} else {
-		th->th_off = 5U;
+		th->th_win = NET_IPV6_MTU;
 	}
 
-	th->th_flags = flags;
-	th->th_win = NET_IPV6_MTU;
 	th->th_seq = htonl(seq);
 
 	if (ACK & flags) {
@@ -275,9 +311,9 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		goto fail;
 	}
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (opts_len) {
 		/* Add TCP Options */
-		ret = net_pkt_write(pkt, tcp_options, opts_len);
+		ret = net_pkt_write(pkt, opts, opts_len);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -382,6 +418,12 @@ fail:
 	return -EINVAL;
 }
 
+static size_t tester_data_len(struct net_pkt *pkt, struct tcphdr *th)
+{
+	return net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+		net_pkt_ip_opts_len(pkt) - th->th_off * 4U;
+}
+
 static int tester_send(const struct device *dev, struct net_pkt *pkt)
 {
 	struct tcphdr th;
@@ -414,6 +456,22 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_client_fast_retransmit(net_pkt_family(pkt), &th,
+					      tester_data_len(pkt, &th));
+		break;
+	case 11:
+		handle_client_sack(net_pkt_family(pkt), &th,
+				   tester_data_len(pkt, &th));
+		break;
+	case 12:
+		handle_client_delayed_ack(net_pkt_family(pkt), &th,
+					  tester_data_len(pkt, &th));
+		break;
+	case 13:
+		handle_client_sack_renege(net_pkt_family(pkt), &th,
+					  tester_data_len(pkt, &th));
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -1330,6 +1388,7 @@ static void test_client_invalid_rst(void)
 
 #define MAX_DATA 100
 static uint32_t expected_ack = MAX_DATA + 1 - 15;
+static uint32_t dup_ack;
 static struct net_context *ooo_ctx;
 
 static void handle_server_recv_out_of_order(struct net_pkt *pkt)
@@ -1342,6 +1401,11 @@ static void handle_server_recv_out_of_order(struct net_pkt *pkt)
 		goto fail;
 	}
 
+	/* Out-of-order data is acked right away with the last ack */
+	if (ntohl(th.th_ack) == dup_ack) {
+		return;
+	}
+
 	/* Verify that we received all the queued data */
 	zassert_equal(expected_ack, ntohl(th.th_ack),
 		      "Not all pending data received. "
@@ -1372,6 +1436,7 @@ static void test_server_recv_out_of_order_data(void)
 	 * testing purposes)
 	 */
 	ooo_ctx = create_server_socket(-15U, -15U);
+	dup_ack = seq;
 
 	/* This will force the packet to be routed to our checker func
 	 * handle_server_recv_out_of_order()
@@ -1449,6 +1514,7 @@ static void test_server_timeout_out_of_order_data(void)
 	}
 
 	k_sem_reset(&test_sem);
+	dup_ack = expected_ack;
 
 	/* The +1 will cause the seq to be not sequential thus we should
 	 * get a timeout.
@@ -1478,6 +1544,707 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
+static uint32_t fr_lost_seq;
+static uint32_t fr_highest_end;
+static int64_t fr_lost_time;
+
+static void handle_client_fast_retransmit(sa_family_t af, struct tcphdr *th,
+					  size_t len)
+{
+	struct net_pkt *reply;
+	int ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		seq++;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		/* connection is success */
+		fr_lost_seq = 0U;
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+
+		if (fr_lost_seq == 0U) {
+			/* Drop the first segment */
+			fr_lost_seq = ntohl(th->th_seq);
+			fr_highest_end = fr_lost_seq + len;
+			fr_lost_time = k_uptime_get();
+			return;
+		}
+
+		if (ntohl(th->th_seq) == fr_lost_seq) {
+			/* The retransmission must not wait for the timer */
+			zassert_true(k_uptime_get() - fr_lost_time <
+				     CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT,
+				     "Lost segment resent after a timeout");
+			ack = fr_highest_end;
+			t_state = T_FIN;
+			test_sem_give();
+		} else {
+			/* Every later segment produces a duplicate ACK */
+			ack = fr_lost_seq;
+			fr_highest_end = MAX(fr_highest_end,
+					     ntohl(th->th_seq) + len);
+		}
+
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   send SYN,
+ *   expect SYN ACK with a small MSS,
+ *   send ACK,
+ *   send Data in several segments, the first one is lost,
+ *   expect duplicate ACKs,
+ *   resend the lost segment before the retransmission timeout,
+ *   expect ACK of all the data,
+ *   send FIN,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_fast_retransmit(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = ctx->tcp;
+	zassert_equal(conn->cwnd, 10U * FR_MSS, "Invalid initial window %u",
+		      conn->cwnd);
+
+	ret = net_context_send(ctx, lorem_ipsum, 6 * FR_MSS, NULL, K_NO_WAIT,
+			       NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	/* Peer will release the semaphone when the lost segment is resent */
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT),
+		      __LINE__);
+
+	/* Let the ACK of all the data be processed */
+	k_msleep(50);
+
+	zassert_true(conn->ssthresh < 10U * FR_MSS,
+		     "Slow start threshold not reduced (%u)", conn->ssthresh);
+	zassert_true(conn->cwnd <= conn->ssthresh,
+		     "Window not deflated (cwnd %u ssthresh %u)", conn->cwnd,
+		     conn->ssthresh);
+	zassert_false(conn->in_recovery, "Fast recovery not left");
+	zassert_equal(conn->unacked_len, 0, "Data not acked");
+
+	net_tcp_put(ctx);
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
+#define SACK_SEGMENTS 6
+
+/* Segments the peer has seen, received and got resent */
+static uint32_t sack_base;
+static uint8_t sack_seen;
+static uint8_t sack_received;
+static uint8_t sack_resent;
+
+/* Segments 0 and 2 are lost */
+#define SACK_LOST (BIT(0) | BIT(2))
+
+static void sack_options_set(void)
+{
+	uint8_t *p = sack_options + 4;
+	int i = 0, start;
+
+	while (i < SACK_SEGMENTS) {
+		if (!(sack_received & BIT(i))) {
+			i++;
+			continue;
+		}
+
+		start = i;
+		while (i < SACK_SEGMENTS && (sack_received & BIT(i))) {
+			i++;
+		}
+
+		sys_put_be32(sack_base + start * FR_MSS, p);
+		sys_put_be32(sack_base + i * FR_MSS, p + 4);
+		p += 8;
+	}
+
+	sack_options[0] = 0x01; /* NOP */
+	sack_options[1] = 0x01; /* NOP */
+	sack_options[2] = 0x05; /* SACK */
+	sack_options[3] = p - sack_options - 2;
+	sack_options_len = p - sack_options;
+}
+
+static void handle_client_sack(sa_family_t af, struct tcphdr *th, size_t len)
+{
+	struct net_pkt *reply;
+	int ret, i;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		sack_base = ack;
+		sack_seen = sack_received = sack_resent = 0U;
+		sack_options_len = 0U;
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		seq++;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		/* connection is success */
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+		zassert_equal(len, FR_MSS, "Unexpected segment size %zd", len);
+		i = (ntohl(th->th_seq) - sack_base) / FR_MSS;
+		zassert_false(sack_received & BIT(i),
+			      "SACKed segment %d resent", i);
+
+		if (!(sack_seen & BIT(i))) {
+			sack_seen |= BIT(i);
+
+			if (SACK_LOST & BIT(i)) {
+				return;
+			}
+
+			/* Duplicate ACK reporting all received segments */
+			sack_received |= BIT(i);
+			sack_options_set();
+		} else {
+			sack_resent |= BIT(i);
+			if (sack_resent != SACK_LOST) {
+				return;
+			}
+
+			/* Both holes are filled, ack everything */
+			sack_options_len = 0U;
+			ack = sack_base + SACK_SEGMENTS * FR_MSS;
+			t_state = T_FIN;
+			test_sem_give();
+		}
+
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   send SYN,
+ *   expect SYN ACK with SACK permitted,
+ *   send ACK,
+ *   send Data in six segments, the first and the third are lost,
+ *   expect duplicate ACKs with SACK blocks,
+ *   resend only the two lost segments,
+ *   expect ACK of all the data,
+ *   send FIN,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_sack(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = 11;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = ctx->tcp;
+	zassert_true(conn->sack_ok, "SACK not negotiated");
+	zassert_false(conn->ts_ok, "Timestamps not offered by the peer");
+
+	ret = net_context_send(ctx, lorem_ipsum, SACK_SEGMENTS * FR_MSS, NULL,
+			       K_NO_WAIT, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	/* Peer will release the semaphone when both holes are filled */
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT),
+		      __LINE__);
+
+	/* Let the ACK of all the data be processed */
+	k_msleep(50);
+
+	zassert_false(conn->in_recovery, "Fast recovery not left");
+	zassert_equal(conn->unacked_len, 0, "Data not acked");
+
+	net_tcp_put(ctx);
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
+static uint16_t da_port;
+static int64_t da_ack_time;
+
+static void handle_client_delayed_ack(sa_family_t af, struct tcphdr *th,
+				      size_t len)
+{
+	struct net_pkt *reply;
+	int ret;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		da_port = th->th_sport;
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		seq++;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		/* connection is success */
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		/* Pure ACK of all the data sent so far */
+		test_verify_flags(th, ACK);
+		zassert_equal(len, 0, "Unexpected data");
+		zassert_equal(ntohl(th->th_ack), seq, "Not all data acked");
+		da_ack_time = k_uptime_get();
+		test_sem_give();
+		return;
+	case T_DATA_ACK:
+		/* The response carries the ACK of the request */
+		test_verify_flags(th, PSH | ACK);
+		zassert_equal(ntohl(th->th_ack), seq, "ACK not piggybacked");
+		ack = ntohl(th->th_seq) + len;
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		t_state = T_FIN;
+		test_sem_give();
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+static void send_peer_data(size_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), da_port,
+				  lorem_ipsum, len);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	seq += len;
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+}
+
+/* Test case scenario IPv4
+ *   expect SYN, send SYN ACK, expect ACK,
+ *   send a small segment, expect the ACK after the delay,
+ *   send two full-sized segments, expect an ACK at once,
+ *   send a request, expect the response to carry its ACK,
+ *   expect FIN, send FIN ACK, expect ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_delayed_ack(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	int64_t start;
+	size_t mss;
+	int ret;
+
+	if (CONFIG_NET_TCP_ACK_DELAY == 0) {
+		return;
+	}
+
+	t_state = T_SYN;
+	test_case_no = 12;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = ctx->tcp;
+
+	start = k_uptime_get();
+	send_peer_data(1);
+
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_ACK_DELAY + 50), __LINE__);
+	zassert_true(da_ack_time - start >= CONFIG_NET_TCP_ACK_DELAY - 1,
+		     "ACK not delayed (%d ms)", (int)(da_ack_time - start));
+
+	mss = net_if_get_mtu(iface) - NET_IPV4TCPH_LEN;
+	start = k_uptime_get();
+	send_peer_data(mss);
+	send_peer_data(mss);
+
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_ACK_DELAY + 50), __LINE__);
+	zassert_true(da_ack_time - start < CONFIG_NET_TCP_ACK_DELAY,
+		     "Second full-sized segment not acked at once");
+
+	t_state = T_DATA_ACK;
+	send_peer_data(1);
+
+	/* Let the request be received before the response is sent */
+	k_msleep(5);
+
+	ret = net_context_send(ctx, lorem_ipsum, 1, NULL, K_NO_WAIT, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	/* Peer will release the semaphone after it receives the response */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* No ACK of its own may follow the response */
+	k_msleep(CONFIG_NET_TCP_ACK_DELAY + 10);
+	zassert_equal(conn->ack_pending, 0, "ACK still pending");
+
+	net_tcp_put(ctx);
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
+static void handle_client_sack_renege(sa_family_t af, struct tcphdr *th,
+				      size_t len)
+{
+	struct net_pkt *reply;
+	int ret, i;
+
+	switch (t_state) {
+	case T_SYN:
+		test_verify_flags(th, SYN);
+		seq = 0U;
+		ack = ntohl(th->th_seq) + 1U;
+		sack_base = ack;
+		sack_seen = sack_received = sack_resent = 0U;
+		sack_options_len = 0U;
+		reply = prepare_syn_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		seq++;
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(th, ACK);
+		/* connection is success */
+		t_state = T_DATA;
+		test_sem_give();
+		return;
+	case T_DATA:
+		test_verify_flags(th, PSH | ACK);
+		zassert_equal(len, FR_MSS, "Unexpected segment size %zd", len);
+		i = (ntohl(th->th_seq) - sack_base) / FR_MSS;
+
+		if (!(sack_seen & BIT(i))) {
+			sack_seen |= BIT(i);
+
+			if (i == 0) {
+				return;
+			}
+
+			/* Duplicate ACK reporting the second segment */
+			sack_received |= BIT(i);
+			sack_options_set();
+		} else if (i == 0) {
+			/* Resent after the timeout. The second segment
+			 * has been discarded meanwhile and is not
+			 * reported any more.
+			 */
+			sack_resent |= BIT(i);
+			sack_received = 0U;
+			sack_options_len = 0U;
+			ack = sack_base + FR_MSS;
+		} else {
+			/* The reneged segment is sent again */
+			zassert_true(sack_resent & BIT(0),
+				     "Segment %d resent before the first", i);
+			ack = sack_base + 2 * FR_MSS;
+			t_state = T_FIN;
+			test_sem_give();
+		}
+
+		reply = prepare_ack_packet(af, htons(MY_PORT), th->th_sport);
+		break;
+	case T_FIN:
+		test_verify_flags(th, FIN | ACK);
+		ack = ntohl(th->th_seq) + 1U;
+		t_state = T_FIN_ACK;
+		reply = prepare_fin_ack_packet(af, htons(MY_PORT),
+					       th->th_sport);
+		break;
+	case T_FIN_ACK:
+		test_verify_flags(th, ACK);
+		test_sem_give();
+		return;
+	default:
+		zassert_true(false, "%s unexpected state", __func__);
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+/* Test case scenario IPv4
+ *   send SYN,
+ *   expect SYN ACK with SACK permitted,
+ *   send ACK,
+ *   send Data in two segments, the first one is lost,
+ *   expect a duplicate ACK with a SACK block for the second one,
+ *   resend the first segment after the retransmission timeout,
+ *   expect an ACK of it without the SACK block,
+ *   resend the second segment as the peer has discarded it,
+ *   expect ACK of all the data,
+ *   send FIN,
+ *   expect FIN ACK,
+ *   send ACK.
+ *   any failures cause test case to fail.
+ */
+static void test_client_sack_renege(void)
+{
+	struct net_context *ctx;
+	struct tcp *conn;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = 13;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	net_context_ref(ctx);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&peer_addr_s,
+				  sizeof(struct sockaddr_in),
+				  NULL,
+				  K_MSEC(100), NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to connect to peer");
+	}
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to SYN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	conn = ctx->tcp;
+	zassert_true(conn->sack_ok, "SACK not negotiated");
+
+	ret = net_context_send(ctx, lorem_ipsum, 2 * FR_MSS, NULL,
+			       K_NO_WAIT, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to send data to peer");
+	}
+
+	/* Peer will release the semaphone when the second segment is resent,
+	 * which needs one retransmission timeout
+	 */
+	test_sem_take(K_MSEC(3 * CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT),
+		      __LINE__);
+
+	/* Let the ACK of all the data be processed */
+	k_msleep(50);
+
+	zassert_equal(conn->sacked_count, 0, "SACK scoreboard not cleared");
+	zassert_equal(conn->unacked_len, 0, "Data not acked");
+
+	net_tcp_put(ctx);
+
+	/* Peer will release the semaphone after it receives
+	 * proper ACK to FIN | ACK
+	 */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* Connection is in TIME_WAIT state, context will be released
+	 * after K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY), so wait for it.
+	 */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY));
+}
+
 /** Test case main entry */
 void test_main(void)
 {
@@ -1491,6 +2258,10 @@ void test_main(void)
 			 ztest_unit_test(test_client_syn_resend),
 			 ztest_unit_test(test_client_fin_wait_2_ipv4),
 			 ztest_unit_test(test_client_closing_ipv6),
+			 ztest_unit_test(test_client_fast_retransmit),
+			 ztest_unit_test(test_client_sack),
+			 ztest_unit_test(test_client_delayed_ack),
+			 ztest_unit_test(test_client_sack_renege),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
 			 ztest_unit_test(test_server_timeout_out_of_order_data)
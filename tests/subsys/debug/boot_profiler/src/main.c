@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <init.h>
+#include <debug/boot_profiler.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_SEM_DEFINE(thread_ran, 0, 1);
+
+static int app_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+SYS_INIT(app_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+static void static_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_give(&thread_ran);
+}
+
+K_THREAD_DEFINE(static_thread, STACK_SIZE, static_entry, NULL, NULL, NULL,
+		K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+struct record_search {
+	uint8_t type;
+	const void *id;
+	struct boot_prof_record found;
+	int index;
+	int matches;
+	int count;
+};
+
+static void find_record_cb(const struct boot_prof_record *record,
+			   void *user_data)
+{
+	struct record_search *search = user_data;
+
+	if (record->type == search->type && record->id == search->id) {
+		search->found = *record;
+		search->index = search->count;
+		search->matches++;
+	}
+	search->count++;
+}
+
+/* Looks up a boot step, which must have been recorded once */
+static struct record_search find_record(uint8_t type, const void *id)
+{
+	struct record_search search = { .type = type, .id = id };
+
+	boot_prof_foreach(find_record_cb, &search);
+	zassert_equal(search.matches, 1, "step %p recorded %d times", id,
+		      search.matches);
+	return search;
+}
+
+/**
+ * @brief Test that init entries and main() are recorded in order
+ *
+ * @see boot_prof_foreach()
+ */
+void test_boot_prof_init(void)
+{
+	struct record_search init, main_step;
+
+	init = find_record(BOOT_PROF_INIT, (const void *)app_init);
+	zassert_equal(init.found.level, _SYS_INIT_LEVEL_APPLICATION, "");
+	zassert_true(init.found.done, "");
+	zassert_is_null(init.found.name, "SYS_INIT() hook has a name");
+	zassert_true(init.found.end >= init.found.start, "");
+
+	main_step = find_record(BOOT_PROF_MAIN, NULL);
+	zassert_true(main_step.found.done, "");
+	zassert_true(main_step.index > init.index,
+		     "main() recorded before APPLICATION level");
+	zassert_true(main_step.found.start >= init.found.end, "");
+
+	zassert_equal(boot_prof_dropped(), 0, "");
+	zassert_equal(strcmp(boot_prof_level_name(init.found.level),
+			     "APPLICATION"), 0, "");
+	zassert_equal(strcmp(boot_prof_level_name(-1), "-"), 0, "");
+}
+
+/**
+ * @brief Test that static threads are recorded when first scheduled
+ *
+ * @see boot_prof_foreach()
+ */
+void test_boot_prof_thread(void)
+{
+	struct record_search thread;
+
+	zassert_equal(k_sem_take(&thread_ran, K_SECONDS(1)), 0,
+		      "static thread did not run");
+
+	thread = find_record(BOOT_PROF_THREAD, static_thread);
+	zassert_true(thread.found.done, "first scheduling not recorded");
+	zassert_equal(strcmp(thread.found.name, "static_thread"), 0, "");
+	zassert_true(thread.found.end >= thread.found.start, "");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(boot_profiler,
+			 ztest_unit_test(test_boot_prof_init),
+			 ztest_unit_test(test_boot_prof_thread));
+	ztest_run_test_suite(boot_profiler);
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <debug/heap_profiler.h>
+
+#define BLOCK_SIZE 100
+#define NUM_BLOCKS 3
+
+K_HEAP_DEFINE(test_heap, 2048);
+
+static void *blocks[NUM_BLOCKS];
+
+struct site_search {
+	void *site;
+	struct heap_prof_site found;
+	int matches;
+};
+
+static void find_site_cb(const struct heap_prof_site *site, void *user_data)
+{
+	struct site_search *search = user_data;
+
+	if (site->site == search->site) {
+		search->found = *site;
+		search->matches++;
+	}
+}
+
+/* Looks up a call site, which must exist */
+static struct heap_prof_site find_site(void *site)
+{
+	struct site_search search = { .site = site };
+
+	heap_prof_site_foreach(find_site_cb, &search);
+	zassert_equal(search.matches, 1, "site %p listed %d times", site,
+		      search.matches);
+	return search.found;
+}
+
+struct live_search {
+	void *mem;
+	void *site;
+};
+
+static void find_live_cb(void *mem, size_t bytes, void *site,
+			 uint32_t timestamp_ms, void *user_data)
+{
+	struct live_search *search = user_data;
+
+	ARG_UNUSED(bytes);
+	ARG_UNUSED(timestamp_ms);
+
+	if (mem == search->mem) {
+		search->site = site;
+	}
+}
+
+/* Returns the call site recorded for a live allocation */
+static void *site_of(void *mem)
+{
+	struct live_search search = { .mem = mem };
+
+	heap_prof_live_foreach(find_live_cb, &search);
+	zassert_not_null(search.site, "%p not tracked", mem);
+	return search.site;
+}
+
+static __noinline void *alloc_block(void)
+{
+	return k_heap_alloc(&test_heap, BLOCK_SIZE, K_NO_WAIT);
+}
+
+static __noinline void *malloc_a(void)
+{
+	return k_malloc(BLOCK_SIZE);
+}
+
+static __noinline void *malloc_b(void)
+{
+	return k_malloc(BLOCK_SIZE);
+}
+
+/**
+ * @brief Test that allocations are attributed to the API caller
+ *
+ * @details Allocations from the same call site share one entry which
+ * accumulates their sizes, not one per layer of the allocator stack.
+ */
+void test_site_attribution(void)
+{
+	struct heap_prof_site s;
+	void *site;
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		blocks[i] = alloc_block();
+		zassert_not_null(blocks[i], "allocation failed");
+	}
+
+	site = site_of(blocks[0]);
+	for (int i = 1; i < NUM_BLOCKS; i++) {
+		zassert_equal(site_of(blocks[i]), site,
+			      "same call site recorded differently");
+	}
+
+	s = find_site(site);
+	zassert_equal(s.live_bytes, NUM_BLOCKS * BLOCK_SIZE, "");
+	zassert_equal(s.live_count, NUM_BLOCKS, "");
+	zassert_equal(s.peak_bytes, NUM_BLOCKS * BLOCK_SIZE, "");
+	zassert_equal(s.allocs, NUM_BLOCKS, "");
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		k_heap_free(&test_heap, blocks[i]);
+	}
+
+	s = find_site(site);
+	zassert_equal(s.live_bytes, 0, "live bytes left after free");
+	zassert_equal(s.live_count, 0, "");
+	zassert_equal(s.frees, NUM_BLOCKS, "");
+	zassert_equal(s.peak_bytes, NUM_BLOCKS * BLOCK_SIZE, "peak lost");
+
+	heap_prof_reset();
+	s = find_site(site);
+	zassert_equal(s.allocs, 0, "");
+	zassert_equal(s.peak_bytes, 0, "peak not reset");
+}
+
+/**
+ * @brief Test that k_malloc() callers are told apart
+ */
+void test_k_malloc_sites(void)
+{
+	void *a = malloc_a();
+	void *b = malloc_b();
+
+	zassert_not_null(a, "allocation failed");
+	zassert_not_null(b, "allocation failed");
+	zassert_not_equal(site_of(a), site_of(b),
+			  "different callers share a site");
+
+	k_free(a);
+	k_free(b);
+}
+
+/**
+ * @brief Test that a full live table drops instead of failing
+ */
+void test_table_full(void)
+{
+	struct heap_prof_stats before, after;
+	void *mem[CONFIG_HEAP_PROFILER_ALLOCS];
+	int n;
+
+	heap_prof_stats_get(&before);
+
+	for (n = 0; n < ARRAY_SIZE(mem); n++) {
+		mem[n] = k_heap_alloc(&test_heap, 8, K_NO_WAIT);
+		zassert_not_null(mem[n], "allocation failed");
+	}
+
+	heap_prof_stats_get(&after);
+	zassert_true(after.dropped > before.dropped, "nothing dropped");
+	zassert_true(after.tracked < CONFIG_HEAP_PROFILER_ALLOCS, "");
+
+	for (n = 0; n < ARRAY_SIZE(mem); n++) {
+		k_heap_free(&test_heap, mem[n]);
+	}
+
+	heap_prof_stats_get(&after);
+	zassert_equal(after.tracked, before.tracked, "tracking leaked");
+	zassert_true(after.untracked_frees > before.untracked_frees, "");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(heap_profiler,
+			 ztest_unit_test(test_site_attribution),
+			 ztest_unit_test(test_k_malloc_sites),
+			 ztest_unit_test(test_table_full));
+	ztest_run_test_suite(heap_profiler);
+}